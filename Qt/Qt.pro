@@ -14,14 +14,22 @@ HEADERS += \
 
 SOURCES += \
  $${SRC_DIR}/address.cpp \
+ $${SRC_DIR}/analyzer.cpp \
  $${SRC_DIR}/baseboard.cpp \
  $${SRC_DIR}/board.cpp \
  $${SRC_DIR}/cell.cpp \
  $${SRC_DIR}/cells.cpp \
+ $${SRC_DIR}/checkpoint.cpp \
  $${SRC_DIR}/combo.cpp \
  $${SRC_DIR}/direction.cpp \
+ $${SRC_DIR}/engine.cpp \
+ $${SRC_DIR}/filemap.cpp \
  $${SRC_DIR}/fraction.cpp \
  $${SRC_DIR}/game.cpp \
+ $${SRC_DIR}/gamecontext.cpp \
+ $${SRC_DIR}/gameevent.cpp \
+ $${SRC_DIR}/gamefile.cpp \
+ $${SRC_DIR}/gametext.cpp \
  $${SRC_DIR}/gameopt.cpp \
  $${SRC_DIR}/gui/area.cpp \
  $${SRC_DIR}/gui/canvas.cpp \
@@ -48,17 +56,31 @@ SOURCES += \
  $${SRC_DIR}/handopt.cpp \
  $${SRC_DIR}/handopts.cpp \
  $${SRC_DIR}/hands.cpp \
+ $${SRC_DIR}/host.cpp \
+ $${SRC_DIR}/hostedgame.cpp \
  $${SRC_DIR}/indices.cpp \
+ $${SRC_DIR}/journal.cpp \
  $${SRC_DIR}/move.cpp \
+ $${SRC_DIR}/mutex.cpp \
  $${SRC_DIR}/network.cpp \
+ $${SRC_DIR}/observers.cpp \
  $${SRC_DIR}/partial.cpp \
  $${SRC_DIR}/project.cpp \
+ $${SRC_DIR}/random.cpp \
+ $${SRC_DIR}/reactor.cpp \
+ $${SRC_DIR}/searchpool.cpp \
+ $${SRC_DIR}/selfplay.cpp \
+ $${SRC_DIR}/selftest.cpp \
  $${SRC_DIR}/socket.cpp \
+ $${SRC_DIR}/stockbag.cpp \
  $${SRC_DIR}/string.cpp \
  $${SRC_DIR}/strings.cpp \
+ $${SRC_DIR}/suggestioncache.cpp \
  $${SRC_DIR}/tile.cpp \
  $${SRC_DIR}/tilecell.cpp \
+ $${SRC_DIR}/tileids.cpp \
  $${SRC_DIR}/tileopt.cpp \
  $${SRC_DIR}/tiles.cpp \
  $${SRC_DIR}/turn.cpp \
- $${SRC_DIR}/turns.cpp
+ $${SRC_DIR}/turns.cpp \
+ $${SRC_DIR}/workers.cpp
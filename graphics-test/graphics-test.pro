@@ -17,5 +17,6 @@ SOURCES += \
  $${SRC_DIR}/gui/rect.cpp \
  $${SRC_DIR}/gui/window.cpp \
  $${SRC_DIR}/project.cpp \
+ $${SRC_DIR}/random.cpp \
  $${SRC_DIR}/string.cpp \
  $${SRC_DIR}/strings.cpp
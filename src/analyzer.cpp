@@ -0,0 +1,346 @@
+// File:     analyzer.cpp
+// Location: src
+// Purpose:  implement Analyzer class
+// Author:   Stephen Gold sgold@sonic.net
+// (c) Copyright 2012 Stephen Gold
+// Distributed under the terms of the GNU General Public License
+
+/*
+This file is part of the Gold Tile Game.
+
+The Gold Tile Game is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by the
+Free Software Foundation, either version 3 of the License, or (at your
+option) any later version.
+
+The Gold Tile Game is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with the Gold Tile Game.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <iostream>     // cout
+#include "analyzer.hpp"
+#include "handopts.hpp"
+#include "hands.hpp"
+#include "partial.hpp"
+#include "turns.hpp"
+#include "workers.hpp"
+
+
+// static callback functions
+
+// callback for worker threads
+static void analyze_game(void* pArgument, SizeType game) {
+    Analyzer* const p_analyzer = (Analyzer*)pArgument;
+
+    p_analyzer->AnalyzeGame(game);
+}
+
+// quotient formatted for a table, or "-" if the divisor is zero
+static String ratio(double dividend, SizeType divisor) {
+    String result = "-";
+    if (divisor > 0) {
+        result = String(dividend/divisor);
+    }
+
+    return result;
+}
+
+
+// lifecycle
+
+Analyzer::Analyzer(SizeType nodeBudget) {
+    mBestPoints = 0;
+    mBonusPlayCnt = 0;
+    mBonusPoints = 0;
+    mElapsedMsec = 0;
+    for (unsigned i_ending = 0; i_ending < ENDING_CNT; i_ending++) {
+        mEndingCnts[i_ending] = 0;
+    }
+    mFailedCnt = 0;
+    mFirstLossCnt = 0;
+    mFirstTieCnt = 0;
+    mFirstWinCnt = 0;
+    mNodeBudget = nodeBudget;
+    mOptimalCnt = 0;
+    mPassCnt = 0;
+    mPlayCnt = 0;
+    mPlayPoints = 0;
+    mRatedCnt = 0;
+    mRatedPoints = 0;
+    mResignCnt = 0;
+    mSwapCnt = 0;
+}
+
+// The implicitly defined destructor is fine.
+
+
+// operators
+
+// one table per statistic, separated by blank lines
+Analyzer::operator String(void) const {
+    SizeType const game_cnt = CountGames() - mFailedCnt;
+    SizeType const turn_cnt = mPlayCnt + mSwapCnt + mPassCnt + mResignCnt;
+
+    String result = "ending,games,fraction\n";
+    for (unsigned i_ending = 0; i_ending < ENDING_CNT; i_ending++) {
+        SizeType const cnt = mEndingCnts[i_ending];
+        result += ::ending_to_string(EndingType(i_ending)) + ","
+            + String(unsigned(cnt)) + "," + ::ratio(cnt, game_cnt) + "\n";
+    }
+    result += "failed to load," + String(unsigned(mFailedCnt)) + ",-\n";
+
+    result += "\nturn,count,points per turn\n";
+    result += "play," + String(unsigned(mPlayCnt)) + ","
+        + ::ratio(double(mPlayPoints), mPlayCnt) + "\n";
+    result += "swap," + String(unsigned(mSwapCnt)) + ",0\n";
+    result += "pass," + String(unsigned(mPassCnt)) + ",0\n";
+    result += "resign," + String(unsigned(mResignCnt)) + ",0\n";
+    result += "all," + String(unsigned(turn_cnt)) + ","
+        + ::ratio(double(mPlayPoints), turn_cnt) + "\n";
+
+    SizeType const plain_cnt = mPlayCnt - mBonusPlayCnt;
+    uint64_t const plain_points = mPlayPoints - mBonusPoints;
+    result += "\nplay,count,points per play\n";
+    result += "with bonus tile," + String(unsigned(mBonusPlayCnt)) + ","
+        + ::ratio(double(mBonusPoints), mBonusPlayCnt) + "\n";
+    result += "without bonus tile," + String(unsigned(plain_cnt)) + ","
+        + ::ratio(double(plain_points), plain_cnt) + "\n";
+
+    SizeType const first_cnt = mFirstWinCnt + mFirstTieCnt + mFirstLossCnt;
+    result += "\nfirst mover,games,fraction\n";
+    result += "won," + String(unsigned(mFirstWinCnt)) + ","
+        + ::ratio(mFirstWinCnt, first_cnt) + "\n";
+    result += "tied," + String(unsigned(mFirstTieCnt)) + ","
+        + ::ratio(mFirstTieCnt, first_cnt) + "\n";
+    result += "lost," + String(unsigned(mFirstLossCnt)) + ","
+        + ::ratio(mFirstLossCnt, first_cnt) + "\n";
+
+    if (mNodeBudget > 0) {
+        result += "\nrated plays,optimal,points,best points,efficiency\n";
+        result += String(unsigned(mRatedCnt)) + ","
+            + String(unsigned(mOptimalCnt)) + ","
+            + String((unsigned long long)mRatedPoints) + ","
+            + String((unsigned long long)mBestPoints) + ","
+            + ::ratio(double(mRatedPoints), SizeType(mBestPoints)) + "\n";
+    }
+
+    return result;
+}
+
+
+// misc methods
+
+void Analyzer::AddFile(String const& rFilespec) {
+    mFilespecs.push_back(rFilespec);
+}
+
+/*
+Load a game, deal it again, and redo its turns one at a time up to the
+saved position, tallying each turn.  If rating is enabled, find the best
+play for each position before the play is redone.
+*/
+void Analyzer::AnalyzeGame(SizeType game) {
+    ASSERT(game < CountGames());
+
+    // The loaded game selects its own context for this thread.
+    Game* const p_game = Game::Load(mFilespecs[game]);
+    if (p_game == NULL) {
+        mTotalsMutex.Lock();
+        mFailedCnt++;
+        mTotalsMutex.Unlock();
+        return;
+    }
+
+    Turns const history = Turns(*p_game);
+    EndingType const ending = p_game->Ending();
+    HandOpts const hand_opts = *p_game;
+    SizeType const hand_cnt = hand_opts.Count();
+    p_game->Restart();
+
+    uint64_t best_points = 0;
+    SizeType bonus_play_cnt = 0;
+    uint64_t bonus_points = 0;
+    SizeType optimal_cnt = 0;
+    SizeType pass_cnt = 0;
+    SizeType play_cnt = 0;
+    uint64_t play_points = 0;
+    SizeType rated_cnt = 0;
+    uint64_t rated_points = 0;
+    SizeType resign_cnt = 0;
+    SizeType swap_cnt = 0;
+
+    for (SizeType i_turn = hand_cnt; i_turn < history.Count(); i_turn++) {
+        Turn const& r_turn = history[i_turn];
+        Move const move = Move(r_turn);
+        ScoreType const points = r_turn.Points();
+
+        if (move.IsResign()) {
+            resign_cnt++;
+        } else if (move.InvolvesSwap()) {
+            swap_cnt++;
+        } else if (move.IsPass()) {
+            pass_cnt++;
+        } else {
+            play_cnt++;
+            play_points += points;
+
+            Tiles const tiles = Tiles(move);
+            Tiles::ConstIterator i_tile;
+            for (i_tile = tiles.begin(); i_tile != tiles.end(); i_tile++) {
+                if (Tile(*i_tile).HasBonus()) {
+                    bonus_play_cnt++;
+                    bonus_points += points;
+                    break;
+                }
+            }
+
+            if (mNodeBudget > 0) {
+                Partial partial(p_game, HINT_NONE, 0.0);
+                if (p_game->MustPlay() == 0) {
+                    partial.SetNodeBudget(mNodeBudget);
+                }
+                partial.Suggest();
+
+                // The search is budgeted, so the play may beat it.
+                ScoreType best = partial.Points();
+                if (best < points) {
+                    best = points;
+                }
+                rated_cnt++;
+                rated_points += points;
+                best_points += best;
+                if (points == best) {
+                    optimal_cnt++;
+                }
+            }
+        }
+
+        p_game->Redo();
+    }
+
+    // Compare the score of the hand which moved first with the best of the rest.
+    bool first_won = false;
+    bool first_tied = false;
+    bool const has_first = (history.Count() > hand_cnt);
+    if (has_first) {
+        String const first_name = history[hand_cnt].HandName();
+        Hands const hands = Hands(*p_game);
+        ScoreType first_score = 0;
+        ScoreType best_other = 0;
+        Hands::ConstIterator i_hand;
+        for (i_hand = hands.begin(); i_hand != hands.end(); i_hand++) {
+            ScoreType const score = i_hand->Score();
+            if (i_hand->Name() == first_name) {
+                first_score = score;
+            } else if (score > best_other) {
+                best_other = score;
+            }
+        }
+        first_won = (first_score > best_other);
+        first_tied = (first_score == best_other);
+    }
+
+    delete p_game;
+
+    mTotalsMutex.Lock();
+    mBestPoints += best_points;
+    mBonusPlayCnt += bonus_play_cnt;
+    mBonusPoints += bonus_points;
+    mEndingCnts[ending]++;
+    if (first_won) {
+        mFirstWinCnt++;
+    } else if (first_tied) {
+        mFirstTieCnt++;
+    } else if (has_first) {
+        mFirstLossCnt++;
+    }
+    mOptimalCnt += optimal_cnt;
+    mPassCnt += pass_cnt;
+    mPlayCnt += play_cnt;
+    mPlayPoints += play_points;
+    mRatedCnt += rated_cnt;
+    mRatedPoints += rated_points;
+    mResignCnt += resign_cnt;
+    mSwapCnt += swap_cnt;
+    mTotalsMutex.Unlock();
+}
+
+SizeType Analyzer::CountGames(void) const {
+    SizeType const result = SizeType(mFilespecs.size());
+
+    return result;
+}
+
+double Analyzer::GamesPerSecond(void) const {
+    double result = 0.0;
+    if (mElapsedMsec > 0) {
+        result = 1000.0*CountGames()/mElapsedMsec;
+    }
+
+    return result;
+}
+
+void Analyzer::Run(SizeType threadCnt) {
+    MsecIntervalType const start = ::milliseconds();
+    Workers workers(threadCnt);
+    workers.Run(&::analyze_game, this, CountGames());
+    mElapsedMsec = ::milliseconds() - start;
+}
+
+
+#ifdef _ANALYZE
+
+// command-line utility to gather statistics from saved games
+
+static void usage(void) {
+    std::cerr << "usage:  gold-tile-analyze [-j THREADS] [-s BUDGET] FILE ..."
+        << std::endl;
+}
+
+int main(int argCnt, char** argValues) {
+    SizeType node_budget = 0;
+    SizeType thread_cnt = 0;
+
+    int i_arg = 1;
+    while (i_arg + 1 < argCnt && argValues[i_arg][0] == '-') {
+        String const flag = argValues[i_arg];
+        String const value = argValues[i_arg + 1];
+        if (flag == "-j") {
+            thread_cnt = SizeType(long(value));
+        } else if (flag == "-s") {
+            node_budget = SizeType(long(value));
+        } else {
+            ::usage();
+            return EXIT_FAILURE;
+        }
+        i_arg += 2;
+    }
+    if (i_arg >= argCnt) {
+        ::usage();
+        return EXIT_FAILURE;
+    }
+
+    Analyzer analyzer(node_budget);
+    for (; i_arg < argCnt; i_arg++) {
+        analyzer.AddFile(argValues[i_arg]);
+    }
+
+    // Discard the console output of the games themselves.
+    std::streambuf* const p_stdout = std::cout.rdbuf(NULL);
+
+    analyzer.Run(thread_cnt);
+
+    std::cout.rdbuf(p_stdout);
+    std::cout << String(analyzer);
+    std::cerr << analyzer.CountGames() << " games at "
+        << analyzer.GamesPerSecond() << " games per second" << std::endl;
+
+    return EXIT_SUCCESS;
+}
+
+#endif  // defined(_ANALYZE)
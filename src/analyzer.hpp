@@ -0,0 +1,93 @@
+#ifndef ANALYZER_HPP_INCLUDED
+#define ANALYZER_HPP_INCLUDED
+
+// File:     analyzer.hpp
+// Location: src
+// Purpose:  declare Analyzer class
+// Author:   Stephen Gold sgold@sonic.net
+// (c) Copyright 2012 Stephen Gold
+// Distributed under the terms of the GNU General Public License
+
+/*
+This file is part of the Gold Tile Game.
+
+The Gold Tile Game is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by the
+Free Software Foundation, either version 3 of the License, or (at your
+option) any later version.
+
+The Gold Tile Game is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with the Gold Tile Game.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+An Analyzer object represents a batch of saved games to be replayed for
+statistics:  how the games ended, the points scored per turn, the effect
+of bonus tiles, the advantage of moving first, and (optionally) how the
+moves played compare with the best moves found by Partial::Suggest().
+
+The Analyzer class encapsulates a list of filespecs and the running
+totals.  The games are spread across a Workers object.  Each game is
+loaded, dealt again, and replayed turn by turn with Game::Redo(), and
+its totals are added to the batch under a mutex.
+*/
+
+#include <vector>       // HASA std::vector
+#include "game.hpp"     // HASA EndingType
+#include "mutex.hpp"    // HASA Mutex
+#include "strings.hpp"  // HASA Strings
+
+class Analyzer {
+public:
+    // public lifecycle
+    explicit Analyzer(SizeType nodeBudget);
+    // ~Analyzer(void);  implicitly defined destructor
+
+    // public operators
+    operator String(void) const;  // CSV tables of the totals
+
+    // misc public methods
+    void     AddFile(String const& filespec);
+    void     AnalyzeGame(SizeType);  // invoked by worker threads
+    SizeType CountGames(void) const;
+    double   GamesPerSecond(void) const;
+    void     Run(SizeType threadCnt);
+
+private:
+    // private constants
+    static const unsigned ENDING_CNT = ENDING_STUCK + 1;
+
+    // private data
+    uint64_t            mBestPoints;           // best points found for the rated plays
+    SizeType            mBonusPlayCnt;         // plays which placed a bonus tile
+    uint64_t            mBonusPoints;          // points scored by those plays
+    MsecIntervalType    mElapsedMsec;          // wall-clock time for the batch
+    SizeType            mEndingCnts[ENDING_CNT];  // games by ending
+    SizeType            mFailedCnt;            // files which couldn't be loaded
+    std::vector<String> mFilespecs;            // one file per game
+    SizeType            mFirstLossCnt;         // games lost by the hand which moved first
+    SizeType            mFirstTieCnt;          // games tied by the hand which moved first
+    SizeType            mFirstWinCnt;          // games won by the hand which moved first
+    SizeType            mNodeBudget;           // for rating plays, or 0 to skip rating
+    SizeType            mOptimalCnt;           // rated plays which scored the best points
+    SizeType            mPassCnt;
+    SizeType            mPlayCnt;
+    uint64_t            mPlayPoints;           // points scored by all plays
+    SizeType            mRatedCnt;             // plays rated against Partial::Suggest()
+    uint64_t            mRatedPoints;          // points scored by the rated plays
+    SizeType            mResignCnt;
+    SizeType            mSwapCnt;
+    Mutex               mTotalsMutex;
+
+    // private lifecycle
+    Analyzer(Analyzer const&);  // not copyable
+
+    // private operators
+    Analyzer& operator=(Analyzer const&);  // not assignable
+};
+#endif  // !defined(ANALYZER_HPP_INCLUDED)
@@ -23,6 +23,7 @@ along with the Gold Tile Game.  If not, see <http://www.gnu.org/licenses/>.
 */
 
 #include "baseboard.hpp"
+#include "cells.hpp"
 #include "tiles.hpp"
 
 
@@ -44,6 +45,19 @@ BaseBoard::BaseBoard(void) {
 
 // The implicitly defined assignment operator is fine.
 
+// get a list of all cells played
+BaseBoard::operator Cells(void) const {
+    Cells result;
+
+    CellConstIterator i_cell;
+    for (i_cell = mCells.begin(); i_cell != mCells.end(); i_cell++) {
+        Cell const cell = i_cell->first;
+        result.Add(cell);
+    }
+
+    return result;
+}
+
 // get a list of all tiles played
 BaseBoard::operator Tiles(void) const {
     Tiles result;
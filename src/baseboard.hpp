@@ -52,6 +52,7 @@ public:
 
     // public operators
     // BaseBoard& operator=(BaseBoard const&);  implicitly defined assignment operator
+    operator Cells(void) const;
     operator Tiles(void) const;
 
     // misc public methods
@@ -24,6 +24,7 @@ along with the Gold Tile Game.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <iostream>      // std::cin
 #include "direction.hpp"
+#include "gamecontext.hpp"
 #include "gameopt.hpp"
 #include "strings.hpp"
 
@@ -35,14 +36,6 @@ const String Cell::SEPARATOR(",");
 const String Cell::SUFFIX(")");
 
 
-// static data
-
-GridType   Cell::msGrid     = GRID_4WAY;
-RowType    Cell::msHeight   = HEIGHT_MAX;
-ColumnType Cell::msWidth    = WIDTH_MAX;
-bool       Cell::msWrapFlag = false;
-
-
 // lifecycle
 
 // default constructor:  refer to the start cell
@@ -99,7 +92,7 @@ Cell::Cell(Cell const& rBase, Direction const& rDirection, int count) {
     mRow = rBase.mRow + count*row_offset;
     mColumn = rBase.mColumn + count*column_offset;
 
-    if (msWrapFlag) {
+    if (DoesBoardWrap()) {
         Wrap();
     }
 }
@@ -156,6 +149,37 @@ ColumnType Cell::Column(void) const {
     return mColumn;
 }
 
+// Configure the current context for a game.
+/* static */  void Cell::Configure(GameOpt const& rGameOpt) {
+    GameContext& r_context = GameContext::Current();
+
+    GridType const grid = rGameOpt;
+    switch (grid) {
+    case GRID_HEX:
+    case GRID_TRIANGLE:
+    case GRID_4WAY:
+    case GRID_8WAY:
+        break;
+    default:
+        FAIL();
+    }
+    r_context.mGrid = grid;
+
+    RowType const height = rGameOpt.BoardHeight();
+    ASSERT(height <= HEIGHT_MAX);
+    ASSERT(height >= HEIGHT_MIN);
+    ASSERT(::is_even(height));
+    r_context.mHeight = height;
+
+    ColumnType const width = rGameOpt.BoardWidth(); 
+    ASSERT(width <= WIDTH_MAX);
+    ASSERT(width >= WIDTH_MIN);
+    ASSERT(::is_even(width));
+    r_context.mWidth = width;
+
+    r_context.mWrapFlag = rGameOpt.DoesBoardWrap();
+}
+
 bool Cell::GetUserChoice(String const& rAlternate) {
     String input;
 
@@ -189,7 +213,7 @@ bool Cell::GetUserChoice(String const& rAlternate) {
 }
 
 /* static */ GridType Cell::Grid(void) {
-    return msGrid;
+    return GameContext::Current().mGrid;
 }
 
 /* static */ void Cell::LimitPlay(SizeType& rCellCnt) {
@@ -254,18 +278,20 @@ void Cell::Next(Direction const& rDirection, int count) {
     RowType& rRowOffset,
     ColumnType& rColumnOffset)
 {
+    bool const is_hex = (Grid() == GRID_HEX);
+
     if (rDirection.IsNorth()) {
-        rRowOffset = (msGrid == GRID_HEX) ? +2 : +1;
+        rRowOffset = is_hex ? +2 : +1;
         rColumnOffset = 0;
     } else if (rDirection.IsSouth()) {
-        rRowOffset = (msGrid == GRID_HEX) ? -2 : -1;
+        rRowOffset = is_hex ? -2 : -1;
         rColumnOffset = 0;
     } else if (rDirection.IsEast()) {
         rRowOffset = 0;
-        rColumnOffset = (msGrid == GRID_HEX) ? +2 : +1;
+        rColumnOffset = is_hex ? +2 : +1;
     } else if (rDirection.IsWest()) {
         rRowOffset = 0;
-        rColumnOffset = (msGrid == GRID_HEX) ? -2 : -1;
+        rColumnOffset = is_hex ? -2 : -1;
     } else if (rDirection.IsNortheast()) {
         rRowOffset = +1;
         rColumnOffset = +1;
@@ -294,7 +320,7 @@ RowType Cell::Row(void) const {
 
 // number of rows above (or below) used cells which might be usable
 /* static */  int Cell::RowFringe(void) {
-    int const result = (msGrid == GRID_HEX) ? 2 : 1;
+    int const result = (Grid() == GRID_HEX) ? 2 : 1;
 
     return result;
 }
@@ -302,7 +328,7 @@ RowType Cell::Row(void) const {
 /* static */  String Cell::ScoringAxes(void) {
     String result;
 
-    switch (msGrid) {
+    switch (Grid()) {
     case GRID_TRIANGLE:
         result = "row or diagonal";
         break;
@@ -322,75 +348,51 @@ RowType Cell::Row(void) const {
     return result;
 }
 
-/* static */  void Cell::SetStatic(GameOpt const& rGameOpt) {
-    GridType const grid = rGameOpt;
-    switch (grid) {
-    case GRID_HEX:
-    case GRID_TRIANGLE:
-    case GRID_4WAY:
-    case GRID_8WAY:
-        break;
-    default:
-        FAIL();
-    }
-    msGrid = grid;
-
-    RowType const height = rGameOpt.BoardHeight();
-    ASSERT(height <= HEIGHT_MAX);
-    ASSERT(height >= HEIGHT_MIN);
-    ASSERT(::is_even(height));
-    msHeight = height;
-
-    ColumnType const width = rGameOpt.BoardWidth(); 
-    ASSERT(width <= WIDTH_MAX);
-    ASSERT(width >= WIDTH_MIN);
-    ASSERT(::is_even(width));
-    msWidth = width;
-
-    msWrapFlag = rGameOpt.DoesBoardWrap();
-}
-
 void Cell::Wrap(void) {
-    ASSERT(msWrapFlag);
+    ASSERT(DoesBoardWrap());
+    GameContext const& r_context = GameContext::Current();
+    RowType const height = r_context.mHeight;
+    ColumnType const width = r_context.mWidth;
 
     if (mColumn >= 0) {
-        IndexType const num_wraps = (mColumn + msWidth/2) / msWidth;
+        IndexType const num_wraps = (mColumn + width/2) / width;
         ASSERT(num_wraps >= 0);
-        mColumn -= num_wraps * msWidth;
+        mColumn -= num_wraps * width;
     } else {
-        IndexType const num_wraps = (msWidth/2 - mColumn - 1) / msWidth;
+        IndexType const num_wraps = (width/2 - mColumn - 1) / width;
         ASSERT(num_wraps >= 0);
-        mColumn += num_wraps * msWidth;
+        mColumn += num_wraps * width;
     }
 
     if (mRow >= 0) {
-        IndexType const num_wraps = (mRow + msHeight/2) / msHeight;
+        IndexType const num_wraps = (mRow + height/2) / height;
         ASSERT(num_wraps >= 0);
-        mRow -= num_wraps * msHeight;
+        mRow -= num_wraps * height;
     } else {
-        IndexType const num_wraps = (msHeight/2 - mRow - 1) / msHeight;
+        IndexType const num_wraps = (height/2 - mRow - 1) / height;
         ASSERT(num_wraps >= 0);
-        mRow += num_wraps * msHeight;
+        mRow += num_wraps * height;
     }
 
-    ASSERT(mColumn >= -msWidth/2);
-    ASSERT(mColumn < msWidth/2);
-    ASSERT(mRow >= -msHeight/2);
-    ASSERT(mRow < msHeight/2);
+    ASSERT(mColumn >= -width/2);
+    ASSERT(mColumn < width/2);
+    ASSERT(mRow >= -height/2);
+    ASSERT(mRow < height/2);
 }
 
 
 // inquiry methods
 
 /* static */  bool Cell::DoesBoardWrap(void) {
-    return msWrapFlag;
+    return GameContext::Current().mWrapFlag;
 }
 
 bool Cell::HasNeighbor(Direction const& rDirection) const {
     ASSERT(rDirection.IsValid());
+    GameContext const& r_context = GameContext::Current();
 
     bool result = true;
-    switch (msGrid) {
+    switch (r_context.mGrid) {
     case GRID_HEX:
         result = !(rDirection.IsHorizontal());
         break;
@@ -424,11 +426,11 @@ bool Cell::HasNeighbor(Direction const& rDirection) const {
     NextCellOffsets(rDirection, row, column);
     row += mRow;
     column += mColumn;
-    if (!msWrapFlag) {
-        if (row >= msHeight/2 || row < -msHeight/2) {
+    if (!r_context.mWrapFlag) {
+        if (row >= r_context.mHeight/2 || row < -r_context.mHeight/2) {
             result = false;
         }
-        if (column >= msWidth/2 || column < -msWidth/2) {
+        if (column >= r_context.mWidth/2 || column < -r_context.mWidth/2) {
             result = false;
         }
     }
@@ -474,19 +476,34 @@ bool Cell::IsStart(void) const {
 }
 
 bool Cell::IsValid(void) const {
+    GameContext const& r_context = GameContext::Current();
     bool result = true;
 
-    if (msGrid == GRID_HEX && IsOdd()) {
+    if (r_context.mGrid == GRID_HEX && IsOdd()) {
         result = false;
-    } else if (mRow < -msHeight/2 || mRow >= msHeight/2) {
+    } else if (mRow < -r_context.mHeight/2 || mRow >= r_context.mHeight/2) {
         result = false;
-    } else if (mColumn < -msWidth/2 || mColumn >= msWidth/2) {
+    } else if (mColumn < -r_context.mWidth/2 || mColumn >= r_context.mWidth/2) {
         result = false;
     }
 
     return result;
 }
 
+// Check a save/send string before parsing it, since it may come from the network.
+/* static */ bool Cell::IsValid(String const& rString) {
+    bool const has_prefix = rString.HasPrefix(PREFIX);
+    bool const has_suffix = rString.HasSuffix(SUFFIX);
+    bool result = false;
+    if (has_prefix && has_suffix) {
+        String const body = rString.Suffix(PREFIX).Prefix(SUFFIX);
+        Strings const parts(body, SEPARATOR);
+        result = (parts.Count() == 2);
+    }
+
+    return result;
+}
+
 
 // global utility functions
 
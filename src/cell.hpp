@@ -75,6 +75,7 @@ public:
 
     // misc public methods
     ColumnType      Column(void) const;
+    static void     Configure(GameOpt const&);
     bool            GetUserChoice(String const&);
     static GridType Grid(void);
     static void     LimitPlay(SizeType&);
@@ -83,7 +84,6 @@ public:
     RowType         Row(void) const;
     static int      RowFringe(void);
     static String   ScoringAxes(void);
-    static void     SetStatic(GameOpt const&);
     void            Wrap(void);
 
     // public inquiry methods
@@ -93,6 +93,7 @@ public:
     static bool IsScoringAxis(Direction const&);
     bool        IsStart(void) const;
     bool        IsValid(void) const;
+    static bool IsValid(String const&);
 
 private:
     // private constants
@@ -101,12 +102,8 @@ private:
     static const String SUFFIX;
 
     // private data
-    ColumnType         mColumn;
-    static GridType   msGrid;
-    static RowType    msHeight;    // must be even and <= HEIGHT_MAX
-    RowType            mRow;
-    static ColumnType msWidth;     // must be even and <= WIDTH_MAX
-    static bool       msWrapFlag;  // coordinates wrap around
+    ColumnType mColumn;
+    RowType    mRow;
 
     // misc private methods
     static void NextCellOffsets(Direction const&, RowType&, ColumnType&);
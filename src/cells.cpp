@@ -41,7 +41,6 @@ Cells::Cells(Cell const& rCell) {
 
 // operators
 
-#if 0
 Cells::operator String(void) const {
     String result("{");
 
@@ -56,7 +55,6 @@ Cells::operator String(void) const {
 
     return result;
 }
-#endif
 
 // The implicitly defined assignment method is fine.
 
@@ -101,6 +99,14 @@ void Cells::MakeEmpty(void) {
     ASSERT(IsEmpty());
 }
 
+void Cells::Remove(Cell const& rCell) {
+    ASSERT(Contains(rCell));
+
+    erase(rCell);
+
+    ASSERT(!Contains(rCell));
+}
+
 
 // inquiry methods
 
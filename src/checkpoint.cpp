@@ -0,0 +1,67 @@
+// File:     checkpoint.cpp
+// Location: src
+// Purpose:  implement Checkpoint class
+// Author:   Stephen Gold sgold@sonic.net
+// (c) Copyright 2012 Stephen Gold
+// Distributed under the terms of the GNU General Public License
+
+/*
+This file is part of the Gold Tile Game.
+
+The Gold Tile Game is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by the 
+Free Software Foundation, either version 3 of the License, or (at your 
+option) any later version.
+
+The Gold Tile Game is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY 
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License 
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with the Gold Tile Game.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "checkpoint.hpp"
+
+
+// lifecycle
+
+Checkpoint::Checkpoint(
+    SizeType turn,
+    Board const& rBoard,
+    Hands const& rHands,
+    StockBag const& rStockBag)
+:   mBoard(rBoard),
+    mHands(rHands),
+    mStockBag(rStockBag)
+{
+    mTurn = turn;
+}
+
+// The implicitly defined copy constructor is OK.
+// The implicitly defined destructor is OK.
+
+
+// operators
+
+// The implicitly defined assignment operator is OK.
+
+Checkpoint::operator Board(void) const {
+    return mBoard;
+}
+
+Checkpoint::operator Hands(void) const {
+    return mHands;
+}
+
+Checkpoint::operator StockBag(void) const {
+    return mStockBag;
+}
+
+
+// misc methods
+
+SizeType Checkpoint::Turn(void) const {
+    return mTurn;
+}
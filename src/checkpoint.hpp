@@ -0,0 +1,68 @@
+#ifndef CHECKPOINT_HPP_INCLUDED
+#define CHECKPOINT_HPP_INCLUDED
+
+// File:     checkpoint.hpp
+// Location: src
+// Purpose:  declare Checkpoint class
+// Author:   Stephen Gold sgold@sonic.net
+// (c) Copyright 2012 Stephen Gold
+// Distributed under the terms of the GNU General Public License
+
+/*
+This file is part of the Gold Tile Game.
+
+The Gold Tile Game is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by the 
+Free Software Foundation, either version 3 of the License, or (at your 
+option) any later version.
+
+The Gold Tile Game is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY 
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License 
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with the Gold Tile Game.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/*
+A Checkpoint object represents a snapshot of the state of a game
+(board, hands, and stock bag) as of a particular turn in its history.
+The hands include the scores and clocks.
+
+Game records a checkpoint every few turns, so that it can seek to any
+turn by restoring the nearest earlier checkpoint and redoing only the
+turns which follow it.
+*/
+
+#include "board.hpp"     // HASA Board
+#include "hands.hpp"     // HASA Hands
+#include "stockbag.hpp"  // HASA StockBag
+
+
+class Checkpoint {
+public:
+    // public lifecycle
+    // no default constructor
+    Checkpoint(SizeType turn, Board const&, Hands const&, StockBag const&);
+    // Checkpoint(Checkpoint const&);  implicitly defined copy constructor
+    // ~Checkpoint(void);  implicitly defined destructor
+
+    // public operators
+    // Checkpoint& operator=(Checkpoint const&);  implicitly defined assignment operator
+    operator Board(void) const;
+    operator Hands(void) const;
+    operator StockBag(void) const;
+
+    // misc public methods
+    SizeType Turn(void) const;
+
+private:
+    // private data
+    Board    mBoard;
+    Hands    mHands;
+    StockBag mStockBag;
+    SizeType mTurn;      // number of turns in the history preceding the snapshot
+};
+#endif  // !defined(CHECKPOINT_HPP_INCLUDED)
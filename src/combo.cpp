@@ -22,41 +22,36 @@ You should have received a copy of the GNU General Public License
 along with the Gold Tile Game.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <vector>       // std::vector
 #include "combo.hpp"
+#include "gamecontext.hpp"
 #include "gameopt.hpp"
 
 
-// static data
-
-AttrCntType Combo:: msAttrCnt = 0;     // configured by SetStatic()
-AttrType*   Combo::mspValueMax = NULL; // allocated by SetStatic()
-
-
 // lifecycle
 
 Combo::Combo(void) {
-    ASSERT(msAttrCnt >= ATTR_CNT_MIN);
+    AttrCntType const attr_cnt = AttrCnt();
 
-    mpArray = new AttrType[msAttrCnt];
-    ASSERT(mpArray != NULL);
+    Allocate();
 
-    for (AttrIndexType i_attr = 0; i_attr < msAttrCnt; i_attr++) {
+    for (AttrIndexType i_attr = 0; i_attr < attr_cnt; i_attr++) {
         mpArray[i_attr] = 0;
     }
+    mPacked = 0;
 }
 
 // Construct a new Combo from a save/send string.
 Combo::Combo(String const& rString) {
-    ASSERT(msAttrCnt >= ATTR_CNT_MIN);
+    AttrCntType const attr_cnt = AttrCnt();
 
-    mpArray = new AttrType[msAttrCnt];
-    ASSERT(mpArray != NULL);
+    Allocate();
 
     AttrIndexType i_attr = 0;
     String::ConstIterator i_char;
     for (i_char = rString.begin() ; i_char != rString.end(); i_char++) {
         char const ch = *i_char;
-        if (i_attr < msAttrCnt) {
+        if (i_attr < attr_cnt) {
             AttrModeType const display_mode = ATTR_MODE_ABC;
             AttrType value = CharToAttr(display_mode, ch);
             if (value > ValueMax(i_attr)) {
@@ -67,58 +62,110 @@ Combo::Combo(String const& rString) {
         }
     }
 
-    while (i_attr < msAttrCnt) {
+    while (i_attr < attr_cnt) {
         // not enough characters in the string -- pad the attribute array with zeroes
         mpArray[i_attr] = 0;
         i_attr++;
     }
+    Pack();
 }
 
 // construct a copy
 Combo::Combo(Combo const& rBase) {
-    ASSERT(msAttrCnt >= ATTR_CNT_MIN);
+    AttrCntType const attr_cnt = AttrCnt();
 
-    mpArray = new AttrType[msAttrCnt];
-    ASSERT(mpArray != NULL);
+    Allocate();
 
-    for (AttrIndexType i_attr = 0; i_attr < msAttrCnt; i_attr++) {
+    for (AttrIndexType i_attr = 0; i_attr < attr_cnt; i_attr++) {
         AttrType const value = rBase.mpArray[i_attr];
         mpArray[i_attr] = value;
     }
+    mPacked = rBase.mPacked;
+}
+
+#ifdef COMBO_MOVE_SEMANTICS
+// Steal the heap array (if any) of a temporary.
+Combo::Combo(Combo&& rBase) {
+    AttrCntType const attr_cnt = AttrCnt();
+
+    if (rBase.mpArray == rBase.mInline) {
+        mpArray = mInline;
+        for (AttrIndexType i_attr = 0; i_attr < attr_cnt; i_attr++) {
+            mpArray[i_attr] = rBase.mpArray[i_attr];
+        }
+    } else {
+        mpArray = rBase.mpArray;
+        rBase.mpArray = NULL;
+    }
+    mPacked = rBase.mPacked;
 }
+#endif  // defined(COMBO_MOVE_SEMANTICS)
 
 Combo::~Combo(void) {
-    delete[] mpArray;
-    mpArray = NULL;
+    Release();
 }
 
 
 // operators
 
 Combo& Combo::operator=(Combo const& rOther) {
-    mpArray = new AttrType[msAttrCnt];
-    ASSERT(mpArray != NULL);
-    for (AttrIndexType i_attr = 0; i_attr < msAttrCnt; i_attr++) {
+    if (this == &rOther) {
+        return *this;
+    }
+
+    // Re-allocate in case the attribute count has changed since construction.
+    Release();
+    Allocate();
+    AttrCntType const attr_cnt = AttrCnt();
+    for (AttrIndexType i_attr = 0; i_attr < attr_cnt; i_attr++) {
         AttrType const value = rOther.mpArray[i_attr];
-        ASSERT(value <= mspValueMax[i_attr]);
+        ASSERT(value <= ValueMax(i_attr));
         mpArray[i_attr] = value;
     }
+    mPacked = rOther.mPacked;
 
     return *this;
 }
 
+#ifdef COMBO_MOVE_SEMANTICS
+Combo& Combo::operator=(Combo&& rOther) {
+    if (this == &rOther) {
+        return *this;
+    }
+
+    if (rOther.mpArray == rOther.mInline) {
+        if (mpArray != mInline) {
+            Release();
+            Allocate();
+        }
+        AttrCntType const attr_cnt = AttrCnt();
+        for (AttrIndexType i_attr = 0; i_attr < attr_cnt; i_attr++) {
+            mpArray[i_attr] = rOther.mpArray[i_attr];
+        }
+    } else {
+        Release();
+        mpArray = rOther.mpArray;
+        rOther.mpArray = NULL;
+    }
+    mPacked = rOther.mPacked;
+
+    return *this;
+}
+#endif  // defined(COMBO_MOVE_SEMANTICS)
+
 bool Combo::operator==(Combo const& rOther) const {
-    bool const result = (CountMatchingAttrs(rOther) == msAttrCnt);
+    bool const result = (CountMatchingAttrs(rOther) == AttrCnt());
 
     return result;
 }
 
 Combo::operator String(void) const {
+    AttrCntType const attr_cnt = AttrCnt();
     String result;
 
-    for (AttrIndexType i_attr = 0; i_attr < msAttrCnt; i_attr++) {
+    for (AttrIndexType i_attr = 0; i_attr < attr_cnt; i_attr++) {
         AttrType const value = mpArray[i_attr];
-        ASSERT(value <= mspValueMax[i_attr]);
+        ASSERT(value <= ValueMax(i_attr));
         AttrModeType const display_mode = ATTR_MODE_ABC;
         result += AttrToString(display_mode, value);
     }
@@ -129,8 +176,22 @@ Combo::operator String(void) const {
 
 // misc methods
 
+/*
+Point mpArray at storage for the current number of attributes:  the
+inline array if it's large enough, otherwise a new heap array.
+*/
+void Combo::Allocate(void) {
+    AttrCntType const attr_cnt = AttrCnt();
+    if (attr_cnt <= INLINE_ATTR_CNT) {
+        mpArray = mInline;
+    } else {
+        mpArray = new AttrType[attr_cnt];
+        ASSERT(mpArray != NULL);
+    }
+}
+
 AttrType Combo::Attr(AttrIndexType ind) const {
-    ASSERT(ind < msAttrCnt);
+    ASSERT(ind < AttrCnt());
 
     AttrType const result = mpArray[ind];
 
@@ -138,9 +199,10 @@ AttrType Combo::Attr(AttrIndexType ind) const {
 }
 
 /* static */ AttrCntType Combo::AttrCnt(void) {
-    ASSERT(msAttrCnt >= ATTR_CNT_MIN);
+    AttrCntType const result = GameContext::Current().mAttrCnt;
 
-    return msAttrCnt;
+    ASSERT(result >= ATTR_CNT_MIN);
+    return result;
 }
 
 /* static */ String Combo::AttrToString(AttrModeType displayMode, AttrType value) {
@@ -166,6 +228,36 @@ AttrType Combo::Attr(AttrIndexType ind) const {
     return result;
 }
 
+// Precompute the compatibility of every pair of combinations, if there are few enough.
+/* static */ void Combo::BuildCompatibilityTable(void) {
+    GameContext& r_context = GameContext::Current();
+    r_context.mCompatible.clear();
+
+    if (r_context.mIdCnt > 0 && r_context.mIdCnt <= TABLE_ID_CNT_MAX) {
+        SizeType const id_cnt = SizeType(r_context.mIdCnt);
+
+        // Decode each ID into a combo.
+        std::vector<Combo> combos(id_cnt);
+        for (SizeType id = 0; id < id_cnt; id++) {
+            SizeType rest = id;
+            for (AttrIndexType i_attr = 0; i_attr < r_context.mAttrCnt; i_attr++) {
+                AttrType const value_cnt = ValueCnt(i_attr);
+                combos[id].SetAttr(i_attr, AttrType(rest % value_cnt));
+                rest /= value_cnt;
+            }
+            ASSERT(combos[id].Id() == id);
+        }
+
+        r_context.mCompatible.assign(id_cnt*id_cnt, false);
+        for (SizeType i_first = 0; i_first < id_cnt; i_first++) {
+            for (SizeType i_second = 0; i_second < id_cnt; i_second++) {
+                bool const is_compatible = combos[i_first].IsCompatibleWith(combos[i_second]);
+                r_context.mCompatible[i_first*id_cnt + i_second] = is_compatible;
+            }
+        }
+    }
+}
+
 /* static */ AttrType Combo::CharToAttr(AttrModeType display_mode, char ch) {
     AttrType result = 0;
 
@@ -192,11 +284,11 @@ AttrType Combo::Attr(AttrIndexType ind) const {
 
 // Calculate the number of possible combinations of attributes.
 /* static */  ComboCntType Combo::CombinationCnt(void) {
-    ASSERT(msAttrCnt >= ATTR_CNT_MIN);
+    AttrCntType const attr_cnt = AttrCnt();
 
     ComboCntType result = 1;
-    for (AttrIndexType i_attr = 0; i_attr < msAttrCnt; i_attr++) {
-        AttrType const max_value = mspValueMax[i_attr];
+    for (AttrIndexType i_attr = 0; i_attr < attr_cnt; i_attr++) {
+        AttrType const max_value = ValueMax(i_attr);
         AttrType const possible_values = max_value + 1;  // zero is a possible value
         result *= possible_values;
     }
@@ -210,23 +302,76 @@ AttrType Combo::Attr(AttrIndexType ind) const {
 
 // identify the common attribute of a compatible combo
 AttrIndexType Combo::CommonAttr(Combo const& rOther) const {
+    AttrCntType const attr_cnt = AttrCnt();
     ASSERT(CountMatchingAttrs(rOther) == 1);
 
-    AttrIndexType result = msAttrCnt;
-    for (AttrIndexType i_attr = 0; i_attr < msAttrCnt; i_attr++) {
+    AttrIndexType result = attr_cnt;
+    for (AttrIndexType i_attr = 0; i_attr < attr_cnt; i_attr++) {
         if (mpArray[i_attr] == rOther.mpArray[i_attr]) {
             result = i_attr;
             break;
         }
     }
 
-    ASSERT(result < msAttrCnt);
+    ASSERT(result < attr_cnt);
+    return result;
+}
+
+// Configure the current context for a game.
+/* static */ void Combo::Configure(GameOpt const& rGameOpt) {
+    AttrCntType const attr_cnt = rGameOpt.AttrCnt();
+
+    ASSERT(attr_cnt >= ATTR_CNT_MIN);
+    ASSERT(attr_cnt <= ATTR_CNT_MAX);
+
+    GameContext& r_context = GameContext::Current();
+    r_context.mAttrCnt = attr_cnt;
+    r_context.mValueMax.assign(attr_cnt, 0);
+
+    for (AttrIndexType i_attr = 0; i_attr < attr_cnt; i_attr++) {
+        AttrType const value_cnt = rGameOpt.CountAttrValues(i_attr);
+        ASSERT(value_cnt >= VALUE_CNT_MIN);
+        ASSERT(value_cnt <= VALUE_CNT_MAX);
+        r_context.mValueMax[i_attr] = value_cnt - 1;
+    }
+
+    r_context.mPackedMask = 0;
+    for (AttrIndexType i_attr = 0; i_attr < attr_cnt && i_attr < PACKED_ATTR_CNT_MAX; i_attr++) {
+        r_context.mPackedMask |= PackedType(1) << (4*i_attr);
+    }
+
+    // Count the combinations, giving up on IDs if there are too many.
+    r_context.mIdCnt = 1;
+    for (AttrIndexType i_attr = 0; i_attr < attr_cnt; i_attr++) {
+        ComboCntType const value_cnt = ValueCnt(i_attr);
+        if (r_context.mIdCnt > ID_CNT_MAX/value_cnt) {
+            r_context.mIdCnt = 0;
+            break;
+        }
+        r_context.mIdCnt *= value_cnt;
+    }
+
+    BuildCompatibilityTable();
+}
+
+/* static */ AttrCntType Combo::CountMatchingAttrs(PackedType first, PackedType second) {
+    ASSERT(CanPack());
+
+    PackedType const differ = DifferingAttrs(first, second);
+    AttrCntType const result = AttrCntType(AttrCnt() - ::count_bits(differ));
+
     return result;
 }
 
 AttrCntType Combo::CountMatchingAttrs(Combo const& rOther) const {
+    if (CanPack()) {
+        AttrCntType const result = CountMatchingAttrs(mPacked, rOther.mPacked);
+        return result;
+    }
+
+    AttrCntType const attr_cnt = AttrCnt();
     AttrCntType result = 0;
-    for (AttrIndexType i_attr = 0; i_attr < msAttrCnt; i_attr++) {
+    for (AttrIndexType i_attr = 0; i_attr < attr_cnt; i_attr++) {
         AttrType const attr_value = rOther.mpArray[i_attr];
         if (HasAttr(i_attr, attr_value)) {
             ++result;
@@ -236,6 +381,22 @@ AttrCntType Combo::CountMatchingAttrs(Combo const& rOther) const {
     return result;
 }
 
+/* 
+Compare two packed combos, yielding the low bit of each
+attribute whose values differ.
+*/
+/* static */ Combo::PackedType Combo::DifferingAttrs(
+    PackedType first,
+    PackedType second)
+{
+    PackedType result = first ^ second;
+    result |= result >> 2;
+    result |= result >> 1;
+    result &= GameContext::Current().mPackedMask;
+
+    return result;
+}
+
 /* static */ AttrModeType Combo::DefaultDisplayMode(AttrIndexType ind) {
     AttrModeType result = ATTR_MODE_123;
 
@@ -273,11 +434,12 @@ AttrCntType Combo::CountMatchingAttrs(Combo const& rOther) const {
 }
 
 String Combo::Description(void) const {
+    AttrCntType const attr_cnt = AttrCnt();
     String result;
 
-    for (AttrIndexType i_attr = 0; i_attr < msAttrCnt; i_attr++) {
+    for (AttrIndexType i_attr = 0; i_attr < attr_cnt; i_attr++) {
         AttrType const value = mpArray[i_attr];
-        ASSERT(value <= mspValueMax[i_attr]);
+        ASSERT(value <= ValueMax(i_attr));
         AttrModeType const display_mode = DefaultDisplayMode(i_attr);
         result += AttrToString(display_mode, value);
     }
@@ -287,17 +449,17 @@ String Combo::Description(void) const {
 
 // Construct a new Combo from a description.
 /* static */ Combo Combo::FromDescription(String const& rDescription) {
-    ASSERT(msAttrCnt >= ATTR_CNT_MIN);
+    AttrCntType const attr_cnt = AttrCnt();
 
     Combo result;
-    result.mpArray = new AttrType[msAttrCnt];
+    result.mpArray = new AttrType[attr_cnt];
     ASSERT(result.mpArray != NULL);
 
     AttrIndexType i_attr = 0;
     String::ConstIterator i_char;
     for (i_char = rDescription.begin() ; i_char != rDescription.end(); i_char++) {
         char const ch = *i_char;
-        if (i_attr < msAttrCnt) {
+        if (i_attr < attr_cnt) {
             AttrModeType const display_mode = DefaultDisplayMode(i_attr);
             AttrType value = CharToAttr(display_mode, ch);
             if (value > ValueMax(i_attr)) {
@@ -308,39 +470,63 @@ String Combo::Description(void) const {
         }
     }
 
-    while (i_attr < msAttrCnt) {
+    while (i_attr < attr_cnt) {
         // Not enough characters in the string -- pad the attribute array with zeroes.
         result.mpArray[i_attr] = 0;
         i_attr++;
     }
+    result.Pack();
 
     return result;
 }
 
-void Combo::SetAttr(AttrIndexType ind, AttrType value) {
-    ASSERT(ind < msAttrCnt);
-    ASSERT(value <= mspValueMax[ind]);
+// Identify the combination, treating each attribute as a digit whose radix
+// is the number of possible values.
+Combo::IdType Combo::Id(void) const {
+    ASSERT(HasIds());
 
-    mpArray[ind] = value;
+    ComboCntType result = 0;
+    for (AttrIndexType i_attr = AttrCnt(); i_attr > 0; i_attr--) {
+        result = result*ValueCnt(i_attr - 1) + mpArray[i_attr - 1];
+    }
+
+    ASSERT(result < GameContext::Current().mIdCnt);
+    return IdType(result);
 }
 
-/* static */ void Combo::SetStatic(GameOpt const& rGameOpt) {
-    AttrCntType const attr_cnt = rGameOpt.AttrCnt();
+// Recompute the packed copy of the attributes.
+void Combo::Pack(void) {
+    AttrCntType const attr_cnt = AttrCnt();
+    mPacked = 0;
+    for (AttrIndexType i_attr = 0; i_attr < attr_cnt && i_attr < PACKED_ATTR_CNT_MAX; i_attr++) {
+        PackedType const value = mpArray[i_attr];
+        ASSERT(value < 16);
+        mPacked |= value << (4*i_attr);
+    }
+}
 
-    ASSERT(attr_cnt >= ATTR_CNT_MIN);
-    ASSERT(attr_cnt <= ATTR_CNT_MAX);
+Combo::PackedType Combo::Packed(void) const {
+    ASSERT(CanPack());
 
-    msAttrCnt = attr_cnt;
+    return mPacked;
+}
 
-    delete[] mspValueMax;
-    mspValueMax = new AttrType[attr_cnt];
-    ASSERT(mspValueMax != NULL);
+// Free the heap array, if any.
+void Combo::Release(void) {
+    if (mpArray != mInline) {
+        delete[] mpArray;
+    }
+    mpArray = NULL;
+}
 
-    for (AttrIndexType i_attr = 0; i_attr < attr_cnt; i_attr++) {
-        AttrType const value_cnt = rGameOpt.CountAttrValues(i_attr);
-        ASSERT(value_cnt >= VALUE_CNT_MIN);
-        ASSERT(value_cnt <= VALUE_CNT_MAX);
-        mspValueMax[i_attr] = value_cnt - 1;
+void Combo::SetAttr(AttrIndexType ind, AttrType value) {
+    ASSERT(ind < AttrCnt());
+    ASSERT(value <= ValueMax(ind));
+
+    mpArray[ind] = value;
+    if (ind < PACKED_ATTR_CNT_MAX) {
+        PackedType const mask = PackedType(0xf) << (4*ind);
+        mPacked = (mPacked & ~mask) | (PackedType(value) << (4*ind));
     }
 }
 
@@ -351,8 +537,9 @@ void Combo::SetAttr(AttrIndexType ind, AttrType value) {
 }
 
 /* static */ AttrType Combo::ValueMax(AttrIndexType attrIndex) {
-    ASSERT(attrIndex < msAttrCnt);
-    AttrType const result = mspValueMax[attrIndex];
+    GameContext const& r_context = GameContext::Current();
+    ASSERT(attrIndex < r_context.mAttrCnt);
+    AttrType const result = r_context.mValueMax[attrIndex];
 
     return result;
 }
@@ -360,8 +547,37 @@ void Combo::SetAttr(AttrIndexType ind, AttrType value) {
 
 // inquiry methods
 
+/*
+Check one packed combo against every combo in a run.  The loop has no
+early exit, so that compilers can vectorize it.
+*/
+/* static */ bool Combo::AreAllCompatibleWith(
+    PackedType combo,
+    PackedType const* pRun,
+    SizeType cnt)
+{
+    ASSERT(CanPack());
+    ASSERT(pRun != NULL || cnt == 0);
+
+    unsigned const differ_cnt = AttrCnt() - 1;
+    bool result = true;
+    for (SizeType i = 0; i < cnt; i++) {
+        PackedType const differ = DifferingAttrs(combo, pRun[i]);
+        result &= (::count_bits(differ) == differ_cnt);
+    }
+
+    return result;
+}
+
+// true if packed combos are supported in the current game
+/* static */ bool Combo::CanPack(void) {
+    bool const result = (GameContext::Current().mAttrCnt <= PACKED_ATTR_CNT_MAX);
+
+    return result;
+}
+
 bool Combo::HasAttr(AttrIndexType index, AttrType value) const {
-    ASSERT(index < msAttrCnt);
+    ASSERT(index < AttrCnt());
 
     AttrType const attrib = mpArray[index];
     bool const result = (attrib == value);
@@ -369,6 +585,40 @@ bool Combo::HasAttr(AttrIndexType index, AttrType value) const {
     return result;
 }
 
+// true if IsCompatibleId() is supported in the current game
+/* static */ bool Combo::HasCompatibilityTable(void) {
+    bool const result = !GameContext::Current().mCompatible.empty();
+
+    return result;
+}
+
+// true if Id() is supported in the current game
+/* static */ bool Combo::HasIds(void) {
+    bool const result = (GameContext::Current().mIdCnt > 0);
+
+    return result;
+}
+
+/* static */ bool Combo::IsCompatible(PackedType first, PackedType second) {
+    ASSERT(CanPack());
+
+    PackedType const differ = DifferingAttrs(first, second);
+    bool const result = (::count_bits(differ) == unsigned(AttrCnt() - 1));
+
+    return result;
+}
+
+/* static */ bool Combo::IsCompatibleId(IdType first, IdType second) {
+    ASSERT(HasCompatibilityTable());
+    GameContext const& r_context = GameContext::Current();
+    ASSERT(first < r_context.mIdCnt);
+    ASSERT(second < r_context.mIdCnt);
+
+    bool const result = r_context.mCompatible[first*SizeType(r_context.mIdCnt) + second];
+
+    return result;
+}
+
 bool Combo::IsCompatibleWith(Combo const& rOther) const {
     AttrCntType const matchCnt = CountMatchingAttrs(rOther);
     bool const result = (matchCnt == 1);
@@ -30,11 +30,29 @@ A Combo object represents a combination of tile attributes.
 Each combo has at least two attributes, each of which can assume up
 to nine values.  In the context of a particular game, every combo has 
 the same number of attributes.
+
+The attributes are stored inline when there are no more than 8 of them,
+which covers every GUI game, so that constructing and copying a Combo
+needn't allocate memory.  Games with more attributes spill to the heap.
+
+When there are no more than 16 attributes, each Combo also keeps a packed
+copy of its attributes, four bits per attribute in a 64-bit word, so that
+attributes can be compared all at once using bitwise operations.
+
+When the number of possible combinations is modest, each combination is
+also identified by a dense Combo::IdType, which tiles use to share a
+precomputed table of which combinations are compatible with one another.
+The attribute count, the range of each attribute, and the compatibility
+table are kept in the GameContext of the current game.
 */
 
 #include <climits>      // USHRT_MAX
 #include "project.hpp"  // USES String
 
+#if __cplusplus >= 201103L || (defined(_MSC_VER) && _MSC_VER >= 1600)
+# define COMBO_MOVE_SEMANTICS  // compiler supports rvalue references
+#endif
+
 typedef uint16_t AttrCntType;    // an attribute count
 typedef uint16_t AttrIndexType;  // an index into an array of attributes
 typedef uint16_t AttrType;       // an attribute value
@@ -59,6 +77,10 @@ typedef uintmax_t ComboCntType;  // for counting combinations
 
 class Combo {
 public:
+    // public types
+    typedef uint32_t IdType;      // dense index of a combination
+    typedef uint64_t PackedType;  // four bits per attribute
+
     // public constants
     static const AttrCntType ATTR_CNT_MIN = 2;
     static const AttrCntType ATTR_CNT_DEFAULT = 2;
@@ -72,19 +94,30 @@ public:
     static const AttrType VALUE_CNT_DEFAULT = 6;
     static const AttrType VALUE_CNT_MAX = 9;
 
+    static const AttrCntType INLINE_ATTR_CNT = 8;       // attributes stored without allocation
+    static const AttrCntType PACKED_ATTR_CNT_MAX = 16;  // attributes per PackedType
+
     static const ComboCntType COMBINATION_CNT_MIN = 4;
 #ifdef _GUI
     static const ComboCntType COMBINATION_CNT_MAX = 59049L; // 9^5
 #endif  // defined(_GUI)
+    static const ComboCntType ID_CNT_MAX = 0x10000000L;     // combinations with IDs
+    static const ComboCntType TABLE_ID_CNT_MAX = 1024;      // combinations in the compatibility table
 
     // public lifecycle
     Combo(void);
     Combo(Combo const&);
+#ifdef COMBO_MOVE_SEMANTICS
+    Combo(Combo&&);
+#endif  // defined(COMBO_MOVE_SEMANTICS)
     explicit Combo(String const&);
     ~Combo(void);
 
     // public operators
     Combo&   operator=(Combo const&);
+#ifdef COMBO_MOVE_SEMANTICS
+    Combo&   operator=(Combo&&);
+#endif  // defined(COMBO_MOVE_SEMANTICS)
     bool     operator==(Combo const&) const;
     operator String(void) const;
 
@@ -94,27 +127,46 @@ public:
     static String       AttrToString(AttrModeType, AttrType);
     static ComboCntType CombinationCnt(void);
     AttrIndexType       CommonAttr(Combo const&) const;
+    static void         Configure(GameOpt const&);
     AttrCntType         CountMatchingAttrs(Combo const&) const;
+    static AttrCntType  CountMatchingAttrs(PackedType, PackedType);
     String              Description(void) const;
     static AttrModeType DefaultDisplayMode(AttrIndexType);
     static Combo        FromDescription(String const&);
+    IdType              Id(void) const;
+    PackedType          Packed(void) const;
     void                SetAttr(AttrIndexType, AttrType);
-    static void         SetStatic(GameOpt const&);
     static AttrType     ValueCnt(AttrIndexType);
     static AttrType     ValueMax(AttrIndexType);
 
     // public inquiry methods
+    static bool 
+         AreAllCompatibleWith(PackedType, PackedType const* run, SizeType cnt);
+    static bool
+         CanPack(void);
+    static bool
+         HasCompatibilityTable(void);
+    static bool
+         HasIds(void);
     bool HasAttr(AttrIndexType, AttrType) const;
+    static bool 
+         IsCompatible(PackedType, PackedType);
+    static bool 
+         IsCompatibleId(IdType, IdType);
     bool IsCompatibleWith(Combo const&) const;
 
 private:
     // private data
-    AttrType* mpArray;     // array of attributes
-
-    static AttrIndexType msAttrCnt;   // number of attributes per tile
-    static AttrType*    mspValueMax;  // max value for each tile attribute
+    AttrType*  mpArray;     // array of attributes:  mInline or a heap array
+    AttrType   mInline[INLINE_ATTR_CNT];
+    PackedType mPacked;     // packed copy of the first PACKED_ATTR_CNT_MAX attributes
 
     // misc private methods
+    void            Allocate(void);
+    static void     BuildCompatibilityTable(void);
+    static PackedType DifferingAttrs(PackedType, PackedType);
+    void            Pack(void);
+    void            Release(void);
     static AttrType CharToAttr(AttrModeType, char);
 };
 
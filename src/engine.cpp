@@ -0,0 +1,435 @@
+// File:     engine.cpp
+// Location: src
+// Purpose:  implement Engine class
+// Author:   Stephen Gold sgold@sonic.net
+// (c) Copyright 2012 Stephen Gold
+// Distributed under the terms of the GNU General Public License
+
+/*
+This file is part of the Gold Tile Game.
+
+The Gold Tile Game is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by the
+Free Software Foundation, either version 3 of the License, or (at your
+option) any later version.
+
+The Gold Tile Game is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with the Gold Tile Game.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "direction.hpp"
+#include "engine.hpp"
+#include "game.hpp"
+#include "partial.hpp"
+#include "random.hpp"
+
+
+// static callback functions
+
+// callback for worker threads
+static void evaluate_deal(void* pArgument, SizeType deal) {
+    Engine* const p_engine = (Engine*)pArgument;
+
+    p_engine->EvaluateDeal(deal);
+}
+
+
+// static data
+
+Workers Engine::msWorkers;
+
+
+// lifecycle
+
+Engine::Engine(Game const& rGame, HandOpt::LevelType level):
+    mBoard(rGame)
+{
+    ASSERT(level >= HandOpt::LEVEL_MIN);
+    ASSERT(level <= HandOpt::LEVEL_MAX);
+
+    mpGame = &rGame;
+    mTiles = rGame.ActiveTiles();
+    mCandidateCntMax = level;
+    mDealCnt = DEALS_PER_LEVEL*level;
+    mRoundCnt = 1 + level/LEVELS_PER_ROUND;
+    mElapsedMsec = 0;
+    mPlayoutCnt = 0;
+
+    // sizes of the other hands, in turn order
+    Hands const others = rGame.UnplayableHands();
+    Hands::ConstIterator i_hand;
+    for (i_hand = others.begin(); i_hand != others.end(); i_hand++) {
+        if (!i_hand->HasResigned()) {
+            SizeType const size = Tiles(*i_hand).Count();
+            mHandSizes.push_back(size);
+        }
+    }
+}
+
+// The implicitly defined destructor is fine.
+
+
+// misc methods
+
+// Add every valid play which extends rSoFar using tiles from rAvailable - RECURSIVE
+/* static */ void Engine::AddPlays(
+    Board const& rStart,
+    Board& rAfter,          // rStart with rSoFar played on it
+    Tiles const& rAvailable,
+    Move const& rSoFar,
+    Cells const& rReachable,  // empty cells which might extend rSoFar
+    Visited& rVisited,
+    Plays& rPlays)
+{
+    Tiles::ConstIterator i_tile;
+    for (i_tile = rAvailable.begin(); i_tile != rAvailable.end(); i_tile++) {
+        Tile const tile = *i_tile;
+
+        Cells::ConstIterator i_cell;
+        for (i_cell = rReachable.begin(); i_cell != rReachable.end(); i_cell++) {
+            Cell const cell = *i_cell;
+            if (!IsPlausible(rAfter, tile, cell)) {
+                continue;
+            }
+            Move move = rSoFar;
+            move.Add(tile, cell);
+
+            // the same set of placements may be reached in any order
+            String const key = move;
+            if (rVisited.count(key) > 0) {
+                continue;
+            }
+            rVisited.insert(key);
+            if (!rStart.IsValidMove(move)) {
+                continue;
+            }
+
+            rAfter.PlayOnCell(cell, tile);
+            ScoreType const points = rAfter.ScoreMove(move);
+            rPlays.insert(Plays::value_type(points, move));
+
+            Cells const reachable = RunEnds(rAfter, move);
+            Tiles available = rAvailable;
+            available.Remove(tile.Id());
+            AddPlays(rStart, rAfter, available, move, reachable, rVisited, rPlays);
+            rAfter.MakeEmpty(cell);
+        }
+    }
+}
+
+// Find the best-scoring play for the specified tiles.
+// Return its points, or zero if none is possible.
+/* static */ ScoreType Engine::BestPlay(
+    Board const& rBoard,
+    Tiles const& rTiles,
+    Move& rBest)
+{
+    Plays plays;
+    FindPlays(rBoard, rTiles, plays);
+
+    ScoreType result = 0;
+    rBest = Move();
+    if (!plays.empty()) {
+        Plays::const_reverse_iterator const i_best = plays.rbegin();
+        result = i_best->first;
+        rBest = i_best->second;
+    }
+
+    return result;
+}
+
+Move Engine::BestMove(void) {
+    ASSERT(mpGame != NULL);
+
+    Move result;
+    if (mpGame->MustPlay() == 0) {
+        FindCandidates();
+    }
+
+    if (mCandidates.size() == 1) {
+        result = mCandidates[0];
+
+    } else if (mCandidates.size() > 1) {
+        DealTiles();
+
+        SizeType const candidate_cnt = mCandidates.size();
+        mValues.assign(mDealCnt*candidate_cnt, 0.0);
+
+        MsecIntervalType const start = ::milliseconds();
+        msWorkers.Run(&evaluate_deal, this, mDealCnt);
+        mElapsedMsec = ::milliseconds() - start;
+        mPlayoutCnt = mDealCnt*candidate_cnt;
+
+        // choose the candidate with the best expected outcome
+        SizeType best = 0;
+        double best_value = 0.0;
+        for (SizeType i_candidate = 0; i_candidate < candidate_cnt; i_candidate++) {
+            double sum = 0.0;
+            for (SizeType i_deal = 0; i_deal < mDealCnt; i_deal++) {
+                sum += mValues[i_deal*candidate_cnt + i_candidate];
+            }
+            double const value = sum/mDealCnt;
+            if (i_candidate == 0 || value > best_value) {
+                best = i_candidate;
+                best_value = value;
+            }
+        }
+        result = mCandidates[best];
+
+    } else {
+        // first turn, or no play is possible:  defer to the greedy search
+        Partial partial(mpGame, HINT_NONE, 0.0);
+        partial.Suggest();
+        result = partial.GetMove(false);
+    }
+
+    return result;
+}
+
+SizeType Engine::CountPlayouts(void) const {
+    return mPlayoutCnt;
+}
+
+SizeType Engine::CountThreads(void) const {
+    SizeType const result = msWorkers.Count();
+
+    return result;
+}
+
+// Generate the random deals.  This happens on the calling thread, using
+// a generator split from the game's, so the deals depend only on the seed.
+void Engine::DealTiles(void) {
+    Tiles const unseen = mpGame->UnseenTiles();
+    Deal base;
+    Tiles::ConstIterator i_tile;
+    for (i_tile = unseen.begin(); i_tile != unseen.end(); i_tile++) {
+        base.push_back(*i_tile);
+    }
+
+    Random random = mpGame->SplitGenerator();
+    mDeals.clear();
+    for (SizeType i_deal = 0; i_deal < mDealCnt; i_deal++) {
+        Deal deal = base;
+        // Fisher-Yates shuffle
+        for (SizeType i = deal.size(); i > 1; i--) {
+            SizeType const j = random.Below(i);
+            Tile::IdType const temp = deal[i - 1];
+            deal[i - 1] = deal[j];
+            deal[j] = temp;
+        }
+        mDeals.push_back(deal);
+    }
+}
+
+// Draw up to cnt tiles from a deal, starting at position rNext.
+/* static */ void Engine::Draw(
+    Deal const& rDeal,
+    SizeType& rNext,
+    SizeType cnt,
+    Tiles& rTiles)
+{
+    for (SizeType i = 0; i < cnt && rNext < rDeal.size(); i++) {
+        rTiles.Add(rDeal[rNext]);
+        rNext++;
+    }
+}
+
+// Evaluate every candidate against a single deal.
+void Engine::EvaluateDeal(SizeType deal) {
+    ASSERT(deal < mDealCnt);
+
+    SizeType const candidate_cnt = mCandidates.size();
+    for (SizeType i_candidate = 0; i_candidate < candidate_cnt; i_candidate++) {
+        double const value = Rollout(mDeals[deal], i_candidate);
+        mValues[deal*candidate_cnt + i_candidate] = value;
+    }
+}
+
+// Choose the highest-scoring plays as candidates.
+void Engine::FindCandidates(void) {
+    Plays plays;
+    FindPlays(mBoard, mTiles, plays);
+
+    mCandidates.clear();
+    mCandidatePoints.clear();
+    Plays::const_reverse_iterator i_play;
+    for (i_play = plays.rbegin(); i_play != plays.rend(); i_play++) {
+        if (mCandidates.size() >= mCandidateCntMax) {
+            break;
+        }
+        mCandidatePoints.push_back(i_play->first);
+        mCandidates.push_back(i_play->second);
+    }
+}
+
+// Find every valid play for the specified tiles.
+/* static */ void Engine::FindPlays(
+    Board const& rBoard,
+    Tiles const& rTiles,
+    Plays& rPlays)
+{
+    Cells reachable;
+    if (rBoard.IsEmpty()) {
+        Cell const start_cell;
+        reachable.Add(start_cell);
+    } else {
+        for (Cell cell = rBoard.FirstCell(); rBoard.MightUse(cell); rBoard.Next(cell)) {
+            Cell wrap_cell = cell;
+            if (Cell::DoesBoardWrap()) {
+                wrap_cell.Wrap();
+            }
+            if (wrap_cell.IsValid()
+                && rBoard.HasEmptyCell(wrap_cell)
+                && rBoard.HasNeighbor(wrap_cell))
+            {
+                reachable.Add(wrap_cell);
+            }
+        }
+    }
+
+    Board after = rBoard;
+    Move const no_tiles;
+    Visited visited;
+    AddPlays(rBoard, after, rTiles, no_tiles, reachable, visited, rPlays);
+}
+
+// Return the empty cells at the ends of each run which contains
+// all the cells of the move, since any further tile must go there.
+/* static */ Cells Engine::RunEnds(Board const& rAfter, Move const& rMove) {
+    Cells const cells = rMove;
+    ASSERT(!cells.IsEmpty());
+    Cell const first = cells.First();
+
+    Cells result;
+    Direction axis;
+    for (axis.SetFirst(); axis.IsAxis(); axis++) {
+        if (Cell::IsScoringAxis(axis)) {
+            Cells run(first);
+            Cells ends;
+
+            // look both ways along the axis
+            for (int count = -1; count <= +1; count += 2) {
+                Cell current = first;
+                for (;;) {
+                    Cell const next(current, axis, count);
+                    if (!next.IsValid() || run.Contains(next)) {
+                        break;
+                    }
+                    if (rAfter.HasEmptyCell(next)) {
+                        if (!ends.Contains(next)) {
+                            ends.Add(next);
+                        }
+                        break;
+                    }
+                    run.Add(next);
+                    current = next;
+                }
+            }
+
+            if (run.ContainsAll(cells)) {
+                Cells::ConstIterator i_cell;
+                for (i_cell = ends.begin(); i_cell != ends.end(); i_cell++) {
+                    if (!result.Contains(*i_cell)) {
+                        result.Add(*i_cell);
+                    }
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
+double Engine::PlayoutsPerSecond(void) const {
+    double result = 0.0;
+    if (mPlayoutCnt > 0) {
+        MsecIntervalType const msec = MAX(mElapsedMsec, 1);
+        result = double(mPlayoutCnt)*MSECS_PER_SECOND/double(msec);
+    }
+
+    return result;
+}
+
+// Play out a candidate against a deal, with every hand making its
+// best-scoring play each turn.  Return the playable hand's net gain:
+// its points minus the average points of the other hands.
+double Engine::Rollout(Deal const& rDeal, SizeType candidate) const {
+    Board board = mBoard;
+    SizeType next = 0;  // position in the deal
+
+    // deal the other hands; the rest of the deal is the stock bag
+    SizeType const other_cnt = mHandSizes.size();
+    std::vector<Tiles> others(other_cnt);
+    for (SizeType i_other = 0; i_other < other_cnt; i_other++) {
+        Draw(rDeal, next, mHandSizes[i_other], others[i_other]);
+    }
+
+    // play the candidate
+    Move const& r_move = mCandidates[candidate];
+    board.PlayMove(r_move);
+    ScoreType my_points = mCandidatePoints[candidate];
+    Tiles mine = mTiles;
+    Tiles const played = r_move;
+    mine.Purge(played);
+    Draw(rDeal, next, played.Count(), mine);
+
+    ScoreType other_points = 0;
+    for (SizeType i_round = 0; i_round < mRoundCnt; i_round++) {
+        for (SizeType i_other = 0; i_other < other_cnt; i_other++) {
+            Move reply;
+            other_points += BestPlay(board, others[i_other], reply);
+            board.PlayMove(reply);
+            Tiles const replied = reply;
+            others[i_other].Purge(replied);
+            Draw(rDeal, next, replied.Count(), others[i_other]);
+        }
+
+        if (i_round + 1 < mRoundCnt) {
+            Move reply;
+            my_points += BestPlay(board, mine, reply);
+            board.PlayMove(reply);
+            Tiles const replied = reply;
+            mine.Purge(replied);
+            Draw(rDeal, next, replied.Count(), mine);
+        }
+    }
+
+    double result = double(my_points);
+    if (other_cnt > 0) {
+        result -= double(other_points)/double(other_cnt);
+    }
+
+    return result;
+}
+
+
+// inquiry methods
+
+// Quickly screen a placement before the (costly) full validity check:
+// the tile must be compatible with each neighbor along a scoring axis.
+/* static */ bool Engine::IsPlausible(
+    Board const& rBoard,
+    Tile const& rTile,
+    Cell const& rCell)
+{
+    bool result = true;
+
+    Direction direction;
+    for (direction.SetFirst(); direction.IsValid(); direction++) {
+        if (Cell::IsScoringAxis(direction.Axis()) && rCell.HasNeighbor(direction)) {
+            Cell const look(rCell, direction, +1);
+            Tile const* const p_neighbor = rBoard.GetCell(look);
+            if (!rTile.IsCompatibleWith(p_neighbor)) {
+                result = false;
+                break;
+            }
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,116 @@
+#ifndef ENGINE_HPP_INCLUDED
+#define ENGINE_HPP_INCLUDED
+
+// File:     engine.hpp
+// Location: src
+// Purpose:  declare Engine class
+// Author:   Stephen Gold sgold@sonic.net
+// (c) Copyright 2012 Stephen Gold
+// Distributed under the terms of the GNU General Public License
+
+/*
+This file is part of the Gold Tile Game.
+
+The Gold Tile Game is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by the
+Free Software Foundation, either version 3 of the License, or (at your
+option) any later version.
+
+The Gold Tile Game is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with the Gold Tile Game.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+An Engine object chooses a move for an automatic hand by Monte Carlo
+expectimax:  it maximizes, over a short list of candidate plays, the
+expected outcome over randomly sampled deals of the unseen tiles.
+
+The Engine class uses only public information:  the board, the playable
+hand's own tiles, the sizes of the other hands, and the set of tiles
+which the playable hand cannot see (Game::UnseenTiles).  Each sample
+(or "deal") is a shuffle of the unseen tiles, which assigns tiles to
+the other hands and orders the stock bag.  For each deal, every candidate
+is evaluated by a rollout in which each hand plays its best-scoring move.
+The deals are independent, so they are spread across a Workers object,
+which every Engine shares so that its threads outlive each move.
+Engines for concurrent games submit their batches side by side.
+The number of candidates, deals, and rounds per rollout grows with the
+skill level of the hand, and a single Engine never uses more threads
+than it has deals, so the spare threads serve other engines.
+*/
+
+#include <map>          // HASA std::multimap
+#include <set>          // USES std::set
+#include <vector>       // HASA std::vector
+#include "board.hpp"    // HASA Board
+#include "cells.hpp"    // USES Cells
+#include "handopt.hpp"  // USES HandOpt::LevelType
+#include "tiles.hpp"    // HASA Tiles
+#include "workers.hpp"  // HASA Workers
+
+class Engine {
+public:
+    // public constants
+    static const SizeType DEALS_PER_LEVEL = 3;
+    static const SizeType LEVELS_PER_ROUND = 6;
+
+    // public lifecycle
+    // no default constructor
+    Engine(Game const&, HandOpt::LevelType);
+    // ~Engine(void);  implicitly defined destructor
+
+    // misc public methods
+    Move     BestMove(void);
+    SizeType CountPlayouts(void) const;
+    SizeType CountThreads(void) const;
+    void     EvaluateDeal(SizeType);  // invoked by worker threads
+    double   PlayoutsPerSecond(void) const;
+
+private:
+    // private types
+    typedef std::vector<Tile::IdType>     Deal;    // a shuffle of the unseen tiles
+    typedef std::set<String>              Visited; // partial moves already explored
+    typedef std::multimap<ScoreType,Move> Plays;   // plays ordered by points
+
+    // private data
+    Board                   mBoard;            // the board at the start of the turn
+    std::vector<Move>       mCandidates;
+    SizeType                mCandidateCntMax;
+    std::vector<ScoreType>  mCandidatePoints;
+    SizeType                mDealCnt;
+    std::vector<Deal>       mDeals;
+    MsecIntervalType        mElapsedMsec;      // time spent on rollouts
+    std::vector<SizeType>   mHandSizes;        // other hands, in turn order
+    Game const*             mpGame;
+    SizeType                mPlayoutCnt;
+    SizeType                mRoundCnt;         // rounds per rollout
+    Tiles                   mTiles;            // the playable hand
+    std::vector<double>     mValues;           // indexed by deal, then candidate
+    static Workers          msWorkers;         // one thread per processor
+
+    // private lifecycle
+    Engine(Engine const&);  // not copyable
+
+    // private operators
+    Engine& operator=(Engine const&);  // not assignable
+
+    // misc private methods
+    static void      AddPlays(Board const&, Board& after, Tiles const& available,
+                         Move const&, Cells const& reachable, Visited&, Plays&);
+    static ScoreType BestPlay(Board const&, Tiles const&, Move&);
+    void             DealTiles(void);
+    static void      Draw(Deal const&, SizeType& next, SizeType cnt, Tiles&);
+    void             FindCandidates(void);
+    static void      FindPlays(Board const&, Tiles const&, Plays&);
+    double           Rollout(Deal const&, SizeType candidate) const;
+    static Cells     RunEnds(Board const& after, Move const&);
+
+    // private inquiry methods
+    static bool IsPlausible(Board const&, Tile const&, Cell const&);
+};
+#endif  // !defined(ENGINE_HPP_INCLUDED)
@@ -38,8 +38,13 @@ Fifo::Fifo(void) {
     Reset();
 }
 
+Fifo::~Fifo(void) {
+    delete[] mpBuffer;
+}
+
 void Fifo::Reset(void) {
     mConsumedCnt = 0;
+    mLineCnt = 0;
     mValidCnt = 0;
 
     ASSERT(IsValid());
@@ -49,12 +54,23 @@ void Fifo::Reset(void) {
 
 // misc methods
 
+// Count the complete lines among the unconsumed data.
+SizeType Fifo::CountLines(void) const {
+    ASSERT(IsValid());
+
+    return mLineCnt;
+}
+
 char Fifo::GetByte(void) {
     ASSERT(IsValid());
     ASSERT(HasData());
 
     char const result = mpBuffer[mConsumedCnt];
     mConsumedCnt++;
+    if (result == '\n') {
+        ASSERT(mLineCnt > 0);
+        mLineCnt--;
+    }
 
     ASSERT(IsValid());
     return result;
@@ -64,32 +80,49 @@ void Fifo::PostReceive(SizeType byteCnt) {
     ASSERT(IsValid());
     ASSERT(byteCnt >= 0);
 
-    mValidCnt += byteCnt;
+    // Count only the newly received lines.
+    SizeType const end = mValidCnt + byteCnt;
+    for (SizeType i_byte = mValidCnt; i_byte < end; i_byte++) {
+        if (mpBuffer[i_byte] == '\n') {
+            mLineCnt++;
+        }
+    }
+    mValidCnt = end;
 
     ASSERT(IsValid());
 }
 
+// Return a count of zero if the buffer is full and can't grow.
 void Fifo::PreReceive(char*& rpStart, SizeType& rByteCnt) {
     ASSERT(IsValid());
 
-    if (!HasSpace()) {
-        mSize *= 2;
-        char* p_buffer = new char[mSize];
-        for (SizeType i_byte = mConsumedCnt; i_byte < mValidCnt; i_byte++) {
-            p_buffer[i_byte] = mpBuffer[i_byte];
-        }
-        delete mpBuffer;
-    }
-
     if (mConsumedCnt == mValidCnt) {
         Reset();
+
+    } else if (!HasSpace() && (mConsumedCnt > 0 || mSize < BUFFER_SIZE_MAX)) {
+        // Keep the unconsumed data, moving it to a larger buffer if it fills this one.
+        SizeType const data_cnt = mValidCnt - mConsumedCnt;
+        char* p_buffer = mpBuffer;
+        if (mConsumedCnt == 0) {
+            mSize *= 2;
+            p_buffer = new char[mSize];
+            ASSERT(p_buffer != NULL);
+        }
+        for (SizeType i_byte = 0; i_byte < data_cnt; i_byte++) {
+            p_buffer[i_byte] = mpBuffer[mConsumedCnt + i_byte];
+        }
+        if (p_buffer != mpBuffer) {
+            delete[] mpBuffer;
+            mpBuffer = p_buffer;
+        }
+        mConsumedCnt = 0;
+        mValidCnt = data_cnt;
     }
 
     rpStart = mpBuffer + mValidCnt;
     SizeType byte_cnt = mSize - mValidCnt;
     rByteCnt = byte_cnt;
 
-    ASSERT(rByteCnt > 0);
     ASSERT(rpStart != NULL);
 }
 
@@ -29,23 +29,30 @@ along with the Gold Tile Game.  If not, see <http://www.gnu.org/licenses/>.
 A Fifo object represents a first-in, first-out buffer for receiving
 network bytes.
 
-The Fifo class is encapsulates a fixed-size buffer and a pair of counts,
-one for valid bytes and one for consumed bytes.
+The Fifo class is encapsulates a growable buffer and a pair of counts,
+one for valid bytes and one for consumed bytes.  It also counts the
+complete lines among the unconsumed bytes as they arrive, so a reactor
+can check for a line without rescanning the buffer.  The buffer stops
+growing at BUFFER_SIZE_MAX, which bounds the length of a line.
 */
 
 #include "project.hpp"  // HASA SizeType
 
 class Fifo {
 public:
+    // public constants
+    static const SizeType BUFFER_SIZE_MAX = 0x400000;  // 4 MiB
+
     // public lifecycle
     Fifo(void);
     ~Fifo(void);
 
     // misc public methods
-    char GetByte(void);
-    void PostReceive(SizeType count);
-    void PreReceive(char*& dest, SizeType& count);
-    void Reset(void);
+    SizeType CountLines(void) const;
+    char     GetByte(void);
+    void     PostReceive(SizeType count);
+    void     PreReceive(char*& dest, SizeType& count);
+    void     Reset(void);
 
     // public inquiry methods
     bool HasData(void) const;
@@ -57,6 +64,7 @@ private:
 
     // private data
     SizeType mConsumedCnt; // number of consumed bytes in the buffer
+    SizeType mLineCnt;     // number of newlines among the unconsumed bytes
     char*   mpBuffer;
     SizeType mSize;        // total size of the buffer, in bytes
     SizeType mValidCnt;    // number of valid bytes in buffer, including those consumed
@@ -0,0 +1,134 @@
+// File:     filemap.cpp
+// Location: src
+// Purpose:  implement FileMap class
+// Author:   Stephen Gold sgold@sonic.net
+// (c) Copyright 2012 Stephen Gold
+// Distributed under the terms of the GNU General Public License
+
+/*
+This file is part of the Gold Tile Game.
+
+The Gold Tile Game is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by the
+Free Software Foundation, either version 3 of the License, or (at your
+option) any later version.
+
+The Gold Tile Game is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with the Gold Tile Game.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "filemap.hpp"
+#include "string.hpp"
+#ifdef _QT
+# include <QFile>
+typedef QFile NativeType;
+#elif defined(WIN32)
+# include "gui/win_types.hpp"
+typedef Win::HANDLE NativeType;
+#else  // POSIX
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif  // POSIX
+
+
+// lifecycle
+
+FileMap::FileMap(String const& rFilespec) {
+    mpBytes = NULL;
+    mpNative = NULL;
+    mSize = 0;
+    TextType const filespec = rFilespec;
+
+#ifdef _QT
+    NativeType* const p_file = new NativeType(QString(filespec));
+    ASSERT(p_file != NULL);
+    if (p_file->open(QIODevice::ReadOnly)) {
+        mSize = SizeType(p_file->size());
+        mpBytes = p_file->map(0, mSize);
+    }
+    mpNative = p_file;
+#elif defined(WIN32)
+    NativeType const file = Win::CreateFileA(filespec, GENERIC_READ,
+        FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file != INVALID_HANDLE_VALUE) {
+        mSize = Win::GetFileSize(file, NULL);
+        NativeType const mapping = Win::CreateFileMappingA(file, NULL,
+            PAGE_READONLY, 0, 0, NULL);
+        if (mapping != NULL) {
+            mpBytes = (uint8_t const*)Win::MapViewOfFile(mapping,
+                FILE_MAP_READ, 0, 0, 0);
+            mpNative = new NativeType(mapping);
+        }
+        // The mapping keeps the file open.
+        Win::CloseHandle(file);
+    }
+#else  // POSIX
+    int const descriptor = ::open(filespec, O_RDONLY);
+    if (descriptor >= 0) {
+        struct stat status;
+        if (::fstat(descriptor, &status) == 0 && status.st_size > 0) {
+            mSize = SizeType(status.st_size);
+            void* const p_map = ::mmap(NULL, mSize, PROT_READ, MAP_PRIVATE,
+                descriptor, 0);
+            if (p_map != MAP_FAILED) {
+                mpBytes = (uint8_t const*)p_map;
+            }
+        }
+        // The mapping keeps the file open.
+        ::close(descriptor);
+    }
+#endif  // POSIX
+
+    if (mpBytes == NULL) {
+        mSize = 0;
+    }
+}
+
+FileMap::~FileMap(void) {
+#ifdef _QT
+    NativeType* const p_file = (NativeType*)mpNative;
+    delete p_file;  // also unmaps and closes the file
+#elif defined(WIN32)
+    NativeType* const p_mapping = (NativeType*)mpNative;
+    if (mpBytes != NULL) {
+        Win::UnmapViewOfFile(mpBytes);
+    }
+    if (p_mapping != NULL) {
+        Win::CloseHandle(*p_mapping);
+        delete p_mapping;
+    }
+#else  // POSIX
+    if (mpBytes != NULL) {
+        ::munmap((void*)mpBytes, mSize);
+    }
+#endif  // POSIX
+}
+
+
+// misc methods
+
+uint8_t const* FileMap::Bytes(void) const {
+    ASSERT(IsValid());
+
+    return mpBytes;
+}
+
+SizeType FileMap::Size(void) const {
+    return mSize;
+}
+
+
+// inquiry methods
+
+bool FileMap::IsValid(void) const {
+    bool const result = (mpBytes != NULL);
+
+    return result;
+}
@@ -0,0 +1,66 @@
+#ifndef FILEMAP_HPP_INCLUDED
+#define FILEMAP_HPP_INCLUDED
+
+// File:     filemap.hpp
+// Location: src
+// Purpose:  declare FileMap class
+// Author:   Stephen Gold sgold@sonic.net
+// (c) Copyright 2012 Stephen Gold
+// Distributed under the terms of the GNU General Public License
+
+/*
+This file is part of the Gold Tile Game.
+
+The Gold Tile Game is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by the
+Free Software Foundation, either version 3 of the License, or (at your
+option) any later version.
+
+The Gold Tile Game is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with the Gold Tile Game.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+A FileMap object represents the contents of a file, mapped read-only
+into memory so that they can be decoded in place, without copying them
+into a buffer.
+
+The FileMap class encapsulates a pointer to the mapped bytes and a
+pointer to the native mapping:  a QFile (Qt), a file-mapping HANDLE
+(Windows), or nothing (POSIX, where munmap() needs only the address
+and size).
+*/
+
+#include "project.hpp"
+
+class FileMap {
+public:
+    // public lifecycle
+    explicit FileMap(String const& filespec);
+    ~FileMap(void);
+
+    // misc public methods
+    uint8_t const* Bytes(void) const;
+    SizeType       Size(void) const;
+
+    // public inquiry methods
+    bool IsValid(void) const;
+
+private:
+    // private data
+    uint8_t const* mpBytes;   // the mapped contents, or NULL if not mapped
+    void*          mpNative;  // the native mapping
+    SizeType       mSize;     // size of the file (in bytes)
+
+    // private lifecycle
+    FileMap(FileMap const&);  // not copyable
+
+    // private operators
+    FileMap& operator=(FileMap const&);  // not assignable
+};
+#endif  // !defined(FILEMAP_HPP_INCLUDED)
@@ -22,9 +22,9 @@ You should have received a copy of the GNU General Public License
 along with the Gold Tile Game.  If not, see <http://www.gnu.org/licenses/>.
 */
 
-#include <cstdlib>      // ::srand()
 #include "fraction.hpp"
 #include "project.hpp"  // ASSERT
+#include "random.hpp"
 
 
 // lifecycle
@@ -55,22 +55,18 @@ void Fraction::Invert(void) {
     mFloat = 1.0f - mFloat;
 }
 
-bool Fraction::RandomBool(void) const {
+bool Fraction::RandomBool(Random& rRandom) const {
     bool result = false;
 
     if (mFloat == 1.0) {
         result = true;
 
     } else if (mFloat > 0.0) {
-        double const r = double(::rand())/RAND_MAX;
+        double const r = rRandom.Unit();
         ASSERT(r >= 0.0);
-        ASSERT(r <= 1.0);
+        ASSERT(r < 1.0);
         result = (r < mFloat);
     }
 
     return result;
 }
-
-/* static */ void Fraction::ReseedGenerator(SeedType seed) {
-    ::srand(seed);
-}
@@ -48,9 +48,7 @@ public:
 
     // misc public methods
     void Invert(void);
-    bool RandomBool(void) const;
-    static void 
-         ReseedGenerator(SeedType);
+    bool RandomBool(Random&) const;
 
 private:
     // private data
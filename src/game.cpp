@@ -22,16 +22,22 @@ You should have received a copy of the GNU General Public License
 along with the Gold Tile Game.  If not, see <http://www.gnu.org/licenses/>.
 */
 
-#include <fstream>
 #include <iostream>
 #include "direction.hpp"
 #include "game.hpp"
+#include "gamefile.hpp"
+#include "gametext.hpp"
 #include "handopts.hpp"
 #include "network.hpp"
 #include "partial.hpp"
 #include "strings.hpp"
 
 
+// static constants
+
+const String Game::JOURNAL_MARKER("GoldTileJournal\n");
+
+
 // lifecycle
 
 Game::Game(
@@ -39,31 +45,34 @@ Game::Game(
     HandOpts const& rHandOptions, 
     Socket const& rClientSocket)
 :   mClient(rClientSocket),
+    mContext(rGameOpt),
     mOptions(rGameOpt)
 {
     ASSERT(!rHandOptions.IsEmpty());
     ASSERT(rHandOptions.Count() == rGameOpt.HandsDealt());
 
     mAmClient = !rClientSocket.IsValid();
+    mClockSeconds = -1;
+    mMovePut = false;
+    mRedoIndex = 0;
 
-    // Intialize static data of the Cell and Tile classes.
-    Cell::SetStatic(mOptions);
-    Tile::SetStatic(mOptions);
+    // The tiles created below are stored in this game's context.
+    SelectContext();
 
-    // Re-seed the psedo-random generator.
-    mOptions.ReseedGenerator();
+    // Seed the pseudo-random generator.
+    mSeed = mOptions.GeneratorSeed();
+    mRandom = Random(mSeed);
 
     // Add tiles to the stock bag.
     if (AmClient()) {
-        for (SizeType i = 0; i < mOptions.TilesPerCombo(); i++) {
-            // Generate all possible tiles.
-            mStockBag.Restock();
-        }
+        // Generate all possible tiles, TilesPerCombo() of each.
+        mStockBag.Restock(mOptions.TilesPerCombo(), mRandom);
     } else {
         String stock_text;
-        bool const was_successful = mClient.GetLine(stock_text);
+        bool const was_successful = mClient.GetLine(stock_text)
+                                 && Tiles::IsValid(stock_text, true);
         if (was_successful) {
-            mStockBag = Tiles(stock_text, true);
+            mStockBag = StockBag(Tiles(stock_text, true));
         } else {
             mClient.Invalidate();
         } 
@@ -71,22 +80,31 @@ Game::Game(
     std::cout << "\nPlaced " << ::plural(CountStock(), "tile") << " in the stock bag." 
         << std::endl;
 
-    // Generate a list of player names.
-    Strings names = rHandOptions.AllPlayerNames();
+    AddHands(rHandOptions);
+}
 
-    // Construct hands and give each one a unique name.
-    for (SizeType i_hand = 0; i_hand < rHandOptions.Count(); i_hand++) {
-        HandOpt const options = rHandOptions[i_hand];
+// Construct a game with no hands and an empty stock bag, for Load() to fill in.
+Game::Game(GameOpt const& rGameOpt)
+:   mContext(rGameOpt),
+    mOptions(rGameOpt)
+{
+    mAmClient = true;
+    mClockSeconds = -1;
+    mMovePut = false;
+    mRedoIndex = 0;
 
-        String hand_name = options.PlayerName();
-        SizeType const cnt = names.Count(hand_name);
-        if (cnt > 1) {
-            hand_name = names.InventUnique(hand_name, "'s ", " hand");
-            names.Append(hand_name);
-        }
+    // The tiles loaded later are stored in this game's context.
+    SelectContext();
 
-        Hand const hand(hand_name, options, mClient);
-        mHands.Append(hand);
+    // Seed the pseudo-random generator.
+    mSeed = mOptions.GeneratorSeed();
+    mRandom = Random(mSeed);
+}
+
+Game::~Game(void) {
+    // Don't leave the calling thread with a dangling selection.
+    if (IsContextSelected()) {
+        GameContext::Select(NULL);
     }
 }
 
@@ -133,13 +151,21 @@ Game::operator String(void) const {
     result += "History=" + String(mHistory) + "\n";
     result += "MustPlay=" + String(mMustPlay) + "\n";
     result += "PlayableHand=" + miPlayableHand->Name() + "\n";
-    result += "Redo=" + String(mHistory.Index(miRedo)) + "\n";
+    result += "Redo=" + String(mRedoIndex) + "\n";
     result += "StockBag=" + String(mStockBag) + "\n";
     result += String(mOptions);
 
     return result;
 }
 
+// Copy the history, omitting any turns which were undone.
+Game::operator Turns(void) const {
+    Turns result = mHistory;
+    result.Truncate(mRedoIndex);
+
+    return result;
+}
+
 
 // misc methods
 
@@ -149,6 +175,7 @@ void Game::ActivateNextHand(void) {
     // Skip over hands which have resigned.
     mHands.NextWorking(miPlayableHand);
     mUnsavedChanges = true;
+    NotifyTurn();
 
     ASSERT(!IsClockRunning());
 }
@@ -160,6 +187,31 @@ Tiles Game::ActiveTiles(void) const {
     return result;
 }
 
+// Construct hands and give each one a unique name.
+void Game::AddHands(HandOpts const& rHandOptions) {
+    // Generate a list of player names.
+    Strings names = rHandOptions.AllPlayerNames();
+
+    for (SizeType i_hand = 0; i_hand < rHandOptions.Count(); i_hand++) {
+        HandOpt const options = rHandOptions[i_hand];
+
+        String hand_name = options.PlayerName();
+        SizeType const cnt = names.Count(hand_name);
+        if (cnt > 1) {
+            hand_name = names.InventUnique(hand_name, "'s ", " hand");
+            names.Append(hand_name);
+        }
+
+        Hand const hand(hand_name, options, mClient);
+        mHands.Append(hand);
+    }
+}
+
+// Register a callback to be notified of changes to the game.
+void Game::AddObserver(Observers::FunctionType* pFunction, void* pArgument) {
+    mObservers.Add(pFunction, pArgument);
+}
+
 void Game::AddServer(Address const& rAddress, Socket const& rSocket) {
     ASSERT(AmClient());
     ASSERT(!IsConnectedToServer(rAddress));
@@ -175,22 +227,69 @@ void Game::AddServer(Address const& rAddress, Socket const& rSocket) {
     ASSERT(IsConnectedToServer(rAddress));
 }
 
+// Remember the result of a search, for Partial::Suggest().
+void Game::AddSuggestion(String const& rKey, Move const& rMove) const {
+    mSuggestions.Add(rKey, rMove);
+}
+
 void Game::AddTurn(Turn const& rTurn) {
     ASSERT(!IsClockRunning());
 
-    while (miRedo != mHistory.end()) {
-        miRedo = mHistory.erase(miRedo);
+    // Discard any undone turns, along with their checkpoints.
+    mHistory.Truncate(mRedoIndex);
+    while (!mCheckpoints.empty() && mCheckpoints.back().Turn() > mRedoIndex) {
+        mCheckpoints.pop_back();
+    }
+    mHistory.Append(rTurn);
+    mRedoIndex = mHistory.Count();
+    TakeCheckpoint();
+
+    if (mJournal.IsOpen()) {
+        String const record = JournalRecord(mRedoIndex - 1, rTurn);
+        mJournal.Append(record);
+
+        // Compact the journal once replaced turns make up too much of it.
+        if (mJournal.CountRecords() > JOURNAL_GROWTH_MAX*mHistory.Count()) {
+            WriteJournal(mJournal.Filespec());
+        }
     }
-    mHistory.push_back(rTurn);
-    miRedo = mHistory.end();
 
     mUnsavedChanges = true;
 }
 
+// Gather every tile in the game.
+Tiles Game::AllTiles(void) const {
+    // Every tile is in the stock bag, on the board, or in a hand.
+    Tiles result = mStockBag;
+    Tiles const board_tiles = Tiles(mBoard);
+    result.Merge(board_tiles);
+    Hands::ConstIterator i_hand;
+    for (i_hand = mHands.begin(); i_hand != mHands.end(); i_hand++) {
+        Tiles const hand_tiles = Tiles(*i_hand);
+        result.Merge(hand_tiles);
+    }
+
+    return result;
+}
+
 String Game::BestRunReport(void) const {
     return mBestRunReport;
 }
 
+// Notify observers if the playable hand's clock display has changed.
+void Game::CheckClock(void) {
+    if (IsClockRunning()) {
+        int const seconds = Seconds(*miPlayableHand);
+        if (seconds != mClockSeconds) {
+            mClockSeconds = seconds;
+
+            GameEvent event(EVENT_CLOCK_TICKED, miPlayableHand->Name());
+            event.SetSeconds(seconds);
+            mObservers.Notify(event);
+        }
+    }
+}
+
 bool Game::ConnectToServers(void) {
     ASSERT(AmClient());
 
@@ -330,7 +429,7 @@ void Game::DisableServers(Address const& rAddress) {
 
 bool Game::DrawTiles(SizeType tileCount, Hand& rHand, Tiles& rTiles) {
     if (AmClient()) {
-        rTiles = mStockBag.PullRandomTiles(tileCount);
+        rTiles = mStockBag.PullRandomTiles(tileCount, mRandom);
 
         String const draw_string = Indices(rTiles);
         PutLineToEachServer(draw_string);
@@ -339,12 +438,28 @@ bool Game::DrawTiles(SizeType tileCount, Hand& rHand, Tiles& rTiles) {
         std::cout << "Getting from client:  tiles drawn by "
             << rHand.Name() << "." << std::endl;
         String draw_string;
-        bool const was_successful = mClient.GetLine(draw_string);
+        bool const was_successful = mClient.GetLine(draw_string)
+                                 && Indices::IsValid(draw_string);
         if (!was_successful) {
             return false;
         }
 
-        rTiles = Tiles(Indices(draw_string), true);
+        // Check the client's draw against the stock bag before purging it.
+        Indices const indices(draw_string);
+        SizeType const stock_cnt = CountStock();
+        SizeType const draw_cnt = (tileCount < stock_cnt) ? tileCount : stock_cnt;
+        if (indices.Count() != draw_cnt) {
+            return false;
+        }
+        Indices::ConstIterator i_index;
+        for (i_index = indices.begin(); i_index != indices.end(); i_index++) {
+            Tile::IdType const id = -Tile::IdType(*i_index);
+            if (!Tile::IsValid(id) || !mStockBag.Contains(id)) {
+                return false;
+            }
+        }
+
+        rTiles = Tiles(indices, true);
         mStockBag.Purge(rTiles);
     }
     rHand.AddTiles(rTiles);
@@ -432,7 +547,7 @@ EndingType Game::Ending(void) const {
         result = ENDING_WENT_OUT;
     } else if (mHands.HaveAllResigned()) {
         result = ENDING_ALL_RESIGNED;
-    } else if (mHistory.IndexLastPlay() + STUCK_THRESHOLD == mHistory.Index(miRedo)) {
+    } else if (mHistory.IndexLastPlay(mRedoIndex) + STUCK_THRESHOLD == mRedoIndex) {
         result = ENDING_STUCK;
     }
 
@@ -471,6 +586,13 @@ void Game::FindBestRun(void) {
     std::cout << mBestRunReport;
 }
 
+// Look up the result of an earlier search, for Partial::Suggest().
+bool Game::FindSuggestion(String const& rKey, Move& rMove) const {
+    bool const result = mSuggestions.Find(rKey, rMove);
+
+    return result;
+}
+
 bool Game::FinishTurn(Move const& rMove) {
     ASSERT(IsLegalMove(rMove));
     ASSERT(IsClockRunning());
@@ -481,8 +603,9 @@ bool Game::FinishTurn(Move const& rMove) {
     if (AmClient()) {
         PutLineToEachServer(move_string);
 
-    } else if (miPlayableHand->IsLocalUser() && mClient.IsValid()) {
-        bool was_successful = mClient.PutLine(move_string);
+    } else if (!miPlayableHand->IsRemote() && mClient.IsValid()) {
+        bool was_successful = mMovePut || PutMoveToClient(rMove);
+        mMovePut = false;
         if (!was_successful) {
             return false;
         }
@@ -493,8 +616,7 @@ bool Game::FinishTurn(Move const& rMove) {
         if (!was_successful) {
             return false;
         }
-        Move const junk_move = Move(junk, true);
-        if (junk_move != rMove) {
+        if (!Move::IsValid(junk, true) || Move(junk, true) != rMove) {
             Network::Notice("Game canceled.");
             return false;
         }
@@ -539,6 +661,7 @@ bool Game::FinishTurn(Move const& rMove) {
             turn.SetPoints(points);
         }
     }
+    NotifyMove(rMove, EVENT_TILES_PLACED);
 
     AddTurn(turn);
 
@@ -590,6 +713,78 @@ bool Game::FirstTurnConsole(void) {
     return was_successful;
 }
 
+// Tell observers the tiles and score of every hand.
+void Game::NotifyHands(void) const {
+    if (mObservers.IsEmpty()) {
+        return;
+    }
+
+    Hands::ConstIterator i_hand;
+    for (i_hand = mHands.begin(); i_hand != mHands.end(); i_hand++) {
+        String const hand_name = i_hand->Name();
+
+        GameEvent hand_event(EVENT_HAND_CHANGED, hand_name);
+        hand_event.SetTiles(Tiles(*i_hand));
+        mObservers.Notify(hand_event);
+
+        GameEvent score_event(EVENT_SCORE_CHANGED, hand_name);
+        score_event.SetScore(i_hand->Score());
+        mObservers.Notify(score_event);
+    }
+}
+
+/*
+Tell observers how a move by the playable hand (or the undoing of one)
+changed the board, the hand's score, and the hand's tiles.  The event type
+says whether the move's tiles were placed on the board or removed from it.
+*/
+void Game::NotifyMove(Move const& rMove, EventType tileEvent) const {
+    if (mObservers.IsEmpty() || rMove.IsPass()) {
+        return;
+    }
+
+    String const hand_name = miPlayableHand->Name();
+    if (rMove.IsPlay()) {
+        NotifyTiles(tileEvent, hand_name, Cells(rMove), Tiles(rMove));
+
+        GameEvent score_event(EVENT_SCORE_CHANGED, hand_name);
+        score_event.SetScore(miPlayableHand->Score());
+        mObservers.Notify(score_event);
+    }
+
+    GameEvent hand_event(EVENT_HAND_CHANGED, hand_name);
+    hand_event.SetTiles(Tiles(*miPlayableHand));
+    mObservers.Notify(hand_event);
+}
+
+void Game::NotifyTiles(
+    EventType type,
+    String const& rHandName,
+    Cells const& rCells,
+    Tiles const& rTiles) const
+{
+    ASSERT(type == EVENT_TILES_PLACED || type == EVENT_TILES_REMOVED);
+
+    if (!mObservers.IsEmpty() && !rCells.IsEmpty()) {
+        GameEvent event(type, rHandName);
+        event.SetCells(rCells);
+        event.SetTiles(rTiles);
+        mObservers.Notify(event);
+    }
+}
+
+// Tell observers which hand is playable and how far the game has advanced.
+void Game::NotifyTurn(void) {
+    // The newly playable hand's clock hasn't been reported yet.
+    mClockSeconds = -1;
+
+    if (!mObservers.IsEmpty()) {
+        GameEvent event(EVENT_TURN_ADVANCED, miPlayableHand->Name());
+        event.SetTurn(mRedoIndex);
+        mObservers.Notify(event);
+    }
+}
+
 SizeType Game::HandSize(void) const {
     SizeType const result = mOptions.HandSize();
 
@@ -619,15 +814,15 @@ bool Game::Initialize(void) {
         // Record the deal in mHistory.
         String const name = i_hand->Name();
         Turn const turn(deal, name);
-        mHistory.push_back(turn);
+        mHistory.Append(turn);
     }
     std::cout << std::endl;
 
     // The hand with the best "run" gets to go first.
     FindBestRun();
 
-    // Set the redo iterator to the end of the history.
-    miRedo = mHistory.end();
+    // Set the redo index to the end of the history.
+    mRedoIndex = mHistory.Count();
 
     // Pretend this game has been saved, for convenience.
     mUnsavedChanges = false;
@@ -638,6 +833,52 @@ bool Game::Initialize(void) {
     return true;
 }
 
+/*
+Reconstruct a game from a file written by SaveBinary(), by Save(), or
+from operator String().  Return NULL if the file can't be mapped or
+isn't a valid game file.
+*/
+/* static */ Game* Game::Load(String const& rFilespec) {
+    Game* p_result = NULL;
+    bool was_successful = false;
+
+    GameFile file(rFilespec);
+    if (file.IsGood()) {
+        // binary format
+        String const game_text = file.GetString();
+        GameOpt const game_opt(game_text);
+        if (file.IsGood() && game_opt.IsValid()) {
+            p_result = new Game(game_opt);
+            ASSERT(p_result != NULL);
+            was_successful = p_result->Unpack(file);
+        }
+    } else {
+        // text format:  either a journal or the text of operator String()
+        GameText text(rFilespec);
+        bool const is_journal = text.Accept(TextType(JOURNAL_MARKER));
+        String const game_text = is_journal ? text.GetParagraph() : text.GetOptions();
+        GameOpt const game_opt(game_text);
+        if (text.IsGood() && game_opt.IsValid()) {
+            p_result = new Game(game_opt);
+            ASSERT(p_result != NULL);
+            if (is_journal) {
+                was_successful = p_result->UnpackJournal(text);
+            } else {
+                was_successful = p_result->Unpack(text);
+            }
+        }
+    }
+
+    if (was_successful) {
+        p_result->mFilespec = rFilespec;
+    } else {
+        delete p_result;
+        p_result = NULL;
+    }
+
+    return p_result;
+}
+
 SizeType Game::MustPlay(void) const {
     return mMustPlay;
 }
@@ -661,6 +902,27 @@ SizeType Game::MustPlay(void) const {
     return p_result;
 }
 
+// Describe the game as it was before any tiles were dealt.
+String Game::JournalHeader(void) const {
+    String result = JOURNAL_MARKER + String(mOptions);
+
+    HandOpts const hand_opts = *this;
+    result += String(hand_opts);
+
+    Tiles const all_tiles = AllTiles();
+    result += "Tiles=" + String(all_tiles) + "\n\n";
+
+    return result;
+}
+
+// A journal record is a turn preceded by its index in the history.  Any
+// turns at or after that index were undone and are replaced.
+/* static */ String Game::JournalRecord(SizeType index, Turn const& rTurn) {
+    String const result = String(unsigned(index)) + " " + String(rTurn);
+
+    return result;
+}
+
 bool Game::NextTurnConsole(void) {
     ASSERT(IsPaused());
 
@@ -699,6 +961,21 @@ bool Game::NextTurnConsole(void) {
     return was_successful;
 }
 
+/*
+Start journaling the game to a file, replacing any existing file.  The
+journal consists of a header describing the game (a marker line,
+options, hands, and tiles), followed by one record per turn in the
+history.  Each turn finished thereafter appends a record, and the
+records are written in batches (or by Save()).  Load() reads the
+journal back.  Return false on failure.
+*/
+bool Game::OpenJournal(String const& rFilespec) {
+    mJournal.Close();
+    bool const result = WriteJournal(rFilespec);
+
+    return result;
+}
+
 void Game::PlayConsole(void) {
     bool was_successful = FirstTurnConsole();
     if (!was_successful) {
@@ -746,12 +1023,28 @@ void Game::PutLineToEachServer(String const& rLine) {
     }
 }
 
+/*
+SERVER:  Put a move by a local hand to the client ahead of FinishTurn(),
+so that the caller can wait for the client's reply without blocking.
+*/
+bool Game::PutMoveToClient(Move const& rMove) {
+    ASSERT(!AmClient());
+    ASSERT(!miPlayableHand->IsRemote());
+    ASSERT(!mMovePut);
+
+    String const move_string = rMove;
+    bool const result = mClient.PutLine(move_string);
+    mMovePut = result;
+
+    return result;
+}
+
 void Game::Redo(void) {
     ASSERT(!IsClockRunning());
     ASSERT(CanRedo());
 
-    Turn const turn = *miRedo;
-    miRedo++;
+    Turn const turn = mHistory[mRedoIndex];
+    mRedoIndex++;
 
     ASSERT(miPlayableHand->Name() == turn.HandName());
 
@@ -783,19 +1076,53 @@ void Game::Redo(void) {
             miPlayableHand->AddScore(points);
         }
     }
+    NotifyMove(move, EVENT_TILES_PLACED);
 
     //  If it was the first turn, it no longer is.
     mMustPlay = 0;
 
     ActivateNextHand();
+    TakeCheckpoint();
 
     ASSERT(!IsClockRunning());
 }
 
+// Unregister a callback registered by AddObserver().
+void Game::RemoveObserver(Observers::FunctionType* pFunction, void* pArgument) {
+    mObservers.Remove(pFunction, pArgument);
+}
+
+/*
+Deal the hands and redo the turns of the history up to a position, which
+recreates the board, the scores, and the checkpoints.  Since the history
+may come from a file, each turn is checked before it's redone.  Return
+false if the position is invalid or the history can't be replayed.
+*/
+bool Game::Replay(SizeType redoIndex) {
+    bool result = (redoIndex >= mHands.Count())
+               && (redoIndex <= mHistory.Count())
+               && AreValidDeals();
+    if (result) {
+        // Restart() needs a playable hand, so start with the first one.
+        miPlayableHand = mHands.begin();
+        Restart();
+        while (result && mRedoIndex < redoIndex) {
+            result = IsValidRedo();
+            if (result) {
+                Redo();
+            }
+        }
+        mUnsavedChanges = false;
+    }
+
+    return result;
+}
+
 void Game::Restart(void) {
     ASSERT(!IsClockRunning());
 
     // Return all played tiles to the stock bag.
+    Cells const played_cells = Cells(mBoard);
     Tiles const played_tiles = Tiles(mBoard);
     mStockBag.Merge(played_tiles);
     mBoard.MakeEmpty();
@@ -809,44 +1136,123 @@ void Game::Restart(void) {
     }
 
     // Redo the initial draws.
-    miRedo = mHistory.begin();
+    mRedoIndex = 0;
     for (SizeType i_hand = 0; i_hand < mHands.Count(); i_hand++) {
-        ASSERT(miRedo->Points() == 0);
+        Turn const& r_turn = mHistory[mRedoIndex];
+        ASSERT(r_turn.Points() == 0);
 
-        Move const move = Move(*miRedo);
+        Move const move = Move(r_turn);
         ASSERT(move.IsPass());
 
-        String const hand_name = miRedo->HandName();
+        String const hand_name = r_turn.HandName();
         miPlayableHand = mHands.Find(hand_name);
 
-        Tiles const draw_tiles = miRedo->Draw();
+        Tiles const draw_tiles = r_turn.Draw();
         ASSERT(draw_tiles.Count() == HandSize());
 
         miPlayableHand->AddTiles(draw_tiles);
         mStockBag.Purge(draw_tiles);
 
-        miRedo++;
+        mRedoIndex++;
     }
 
     // The hand with the best "run" gets the first turn.
     FindBestRun();
 
+    NotifyTiles(EVENT_TILES_REMOVED, "", played_cells, played_tiles);
+    NotifyHands();
+    NotifyTurn();
+
     ASSERT(IsPaused());
     ASSERT(!CanUndo());
 }
 
+// Restore the state of the game from a checkpoint.
+void Game::RestoreCheckpoint(Checkpoint const& rCheckpoint) {
+    ASSERT(!IsClockRunning());
+    ASSERT(rCheckpoint.Turn() > mHands.Count());
+    ASSERT(rCheckpoint.Turn() <= mHistory.Count());
+
+    Cells const old_cells = Cells(mBoard);
+    Tiles const old_tiles = Tiles(mBoard);
+
+    mBoard = Board(rCheckpoint);
+    mHands = Hands(rCheckpoint);
+    mStockBag = StockBag(rCheckpoint);
+    mRedoIndex = rCheckpoint.Turn();
+
+    // Checkpoints follow the first turn, so nothing must be played.
+    mMustPlay = 0;
+
+    // The hand after the one which took the preceding turn is playable.
+    String const hand_name = mHistory[mRedoIndex - 1].HandName();
+    miPlayableHand = mHands.Find(hand_name);
+
+    NotifyTiles(EVENT_TILES_REMOVED, "", old_cells, old_tiles);
+    NotifyTiles(EVENT_TILES_PLACED, "", Cells(mBoard), Tiles(mBoard));
+    NotifyHands();
+    ActivateNextHand();
+
+    ASSERT(!IsClockRunning());
+}
+
+/*
+Save the game as a journal in its associated file.  The journal stays
+open, so each turn finished thereafter is saved (in batches) without
+further calls.
+*/
 void Game::Save(void) {
   if (mFilespec.IsEmpty()) {
       mFilespec = "untitled.gtg";
   }
 
-  // TODO check for existing file
-  std::ofstream file;
-  file.open(mFilespec);
-  file << String(*this);
-  file.close();
+  bool was_successful = false;
+  if (mJournal.IsOpen() && mJournal.Filespec() == mFilespec) {
+      // The journal holds every turn, so just write any pending records.
+      was_successful = mJournal.Flush();
+  } else {
+      // TODO check for existing file
+      was_successful = OpenJournal(mFilespec);
+  }
 
-  mUnsavedChanges = false;
+  if (was_successful) {
+      mUnsavedChanges = false;
+  }
+}
+
+/*
+Write the game to a file in the binary format:  the game options, the
+hand options, every tile with its options, the history, and the current
+position in the history.  Clocks and the suggestion cache are not saved.
+Return false on failure.
+*/
+bool Game::SaveBinary(String const& rFilespec) {
+    GameFile file;
+
+    file.PutString(String(mOptions));
+    HandOpts const hand_opts = *this;
+    file.PutCount(hand_opts.Count());
+    for (SizeType i_hand = 0; i_hand < hand_opts.Count(); i_hand++) {
+        file.PutString(String(hand_opts[i_hand]));
+    }
+
+    Tiles const all_tiles = AllTiles();
+    file.PutTileTable(all_tiles);
+
+    SizeType const turn_cnt = mHistory.Count();
+    file.PutCount(turn_cnt);
+    for (SizeType i_turn = 0; i_turn < turn_cnt; i_turn++) {
+        file.PutTurn(mHistory[i_turn], mHands);
+    }
+    file.PutCount(mRedoIndex);
+
+    bool const result = file.Write(rFilespec);
+    if (result) {
+        mFilespec = rFilespec;
+        mUnsavedChanges = false;
+    }
+
+    return result;
 }
 
 int Game::Seconds(Hand& rHand) const {
@@ -868,6 +1274,66 @@ SecondsType Game::SecondsPerHand(void) const {
     return result;
 }
 
+/*
+Move to the given position in the history, with the same result as
+repeated Undo() or Redo().  Start from whichever is closest:  the current
+position, the latest checkpoint at or before the target, or the initial
+deal.  Unless undoing is quicker, at most CHECKPOINT_INTERVAL-1 turns
+are redone after a checkpoint.
+*/
+void Game::SeekTurn(SizeType turn) {
+    ASSERT(!IsClockRunning());
+    ASSERT(turn >= mHands.Count());
+    ASSERT(turn <= mHistory.Count());
+
+    // Find the latest checkpoint at or before the target.
+    SizeType start = mHands.Count();
+    SizeType const checkpoint_cnt = SizeType(mCheckpoints.size());
+    SizeType i_checkpoint = checkpoint_cnt;
+    if (checkpoint_cnt > 0 && turn >= mCheckpoints.front().Turn()) {
+        // The checkpoints are CHECKPOINT_INTERVAL turns apart.
+        i_checkpoint = (turn - mCheckpoints.front().Turn())/CHECKPOINT_INTERVAL;
+        if (i_checkpoint >= checkpoint_cnt) {
+            i_checkpoint = checkpoint_cnt - 1;
+        }
+        start = mCheckpoints[i_checkpoint].Turn();
+        ASSERT(start <= turn);
+    }
+
+    if (mRedoIndex > turn && mRedoIndex - turn <= turn - start) {
+        while (mRedoIndex > turn) {
+            Undo();
+        }
+    } else if (mRedoIndex > turn || mRedoIndex < start) {
+        if (i_checkpoint < checkpoint_cnt) {
+            RestoreCheckpoint(mCheckpoints[i_checkpoint]);
+        } else {
+            Restart();
+        }
+    }
+
+    while (mRedoIndex < turn) {
+        Redo();
+    }
+
+    ASSERT(mRedoIndex == turn);
+}
+
+// Select this game's context for the calling thread.
+void Game::SelectContext(void) {
+    GameContext::Select(&mContext);
+}
+
+// Derive a generator for a search from the seed and the current turn,
+// so that the search can make random choices without disturbing the
+// game's own sequence of draws.  Stream 0 belongs to mRandom.
+Random Game::SplitGenerator(void) const {
+    uint64_t const stream = uint64_t(mRedoIndex) + 1;
+    Random const result(mSeed, stream);
+
+    return result;
+}
+
 void Game::StartClock(void) {
     ASSERT(!IsOver());
     ASSERT(!IsClockRunning());
@@ -893,6 +1359,25 @@ GameStyleType Game::Style(void) const {
     return result;
 }
 
+// Record a checkpoint if one is due at the current position in the history.
+void Game::TakeCheckpoint(void) {
+    if (mRedoIndex <= mHands.Count() || mRedoIndex % CHECKPOINT_INTERVAL != 0) {
+        return;
+    }
+
+    // Keep the checkpoints contiguous, so that SeekTurn() can index them.
+    bool is_due = mCheckpoints.empty();
+    if (!is_due) {
+        SizeType const last_turn = mCheckpoints.back().Turn();
+        is_due = (last_turn + CHECKPOINT_INTERVAL == mRedoIndex);
+    }
+
+    if (is_due) {
+        Checkpoint const checkpoint(mRedoIndex, mBoard, mHands, mStockBag);
+        mCheckpoints.push_back(checkpoint);
+    }
+}
+
 void Game::TogglePause(void) {
     ASSERT(!IsOver());
 
@@ -907,8 +1392,8 @@ void Game::Undo(void) {
     ASSERT(!IsClockRunning());
     ASSERT(CanUndo());
 
-    miRedo--;
-    Turn const turn = *miRedo;
+    mRedoIndex--;
+    Turn const turn = mHistory[mRedoIndex];
 
     String const hand_name = turn.HandName();
     miPlayableHand = mHands.Find(hand_name);
@@ -943,14 +1428,14 @@ void Game::Undo(void) {
             miPlayableHand->SubtractScore(points);
         }
     }
+    NotifyMove(move, EVENT_TILES_REMOVED);
+    NotifyTurn();
 }
 
 Indices Game::UndoTiles(void) const {
     ASSERT(CanUndo());
 
-    Turns::ConstIterator previous = miRedo;
-    previous--;
-    Move const move = Turn(*previous);
+    Move const move = mHistory[mRedoIndex - 1];
 
     Indices result;
     if (move.IsPlay()) {
@@ -960,6 +1445,183 @@ Indices Game::UndoTiles(void) const {
     return result;
 }
 
+/*
+Decode the rest of a file written by SaveBinary():  the hand options,
+the tiles, the history, and the position in the history.  Return false
+if the file is invalid.
+*/
+bool Game::Unpack(GameFile& rFile) {
+    ASSERT(mHands.IsEmpty());
+    ASSERT(mHistory.Count() == 0);
+
+    HandOpts hand_opts;
+    SizeType const hand_cnt = rFile.GetCount();
+    for (SizeType i_hand = 0; i_hand < hand_cnt && rFile.IsGood(); i_hand++) {
+        String const hand_text = rFile.GetString();
+        HandOpt const hand_opt(hand_text);
+        hand_opts.Append(hand_opt);
+    }
+    // The turns refer to the hands by position, so construct them first.
+    if (!rFile.IsGood() || !UnpackHands(hand_opts)) {
+        return false;
+    }
+
+    Tiles const all_tiles = rFile.GetTileTable();
+
+    Turns history;
+    SizeType const turn_cnt = rFile.GetCount();
+    for (SizeType i_turn = 0; i_turn < turn_cnt && rFile.IsGood(); i_turn++) {
+        Turn const turn = rFile.GetTurn(mHands);
+        history.Append(turn);
+    }
+    SizeType const redo_index = rFile.GetCount();
+
+    bool const result = rFile.IsGood()
+                     && UnpackHistory(all_tiles, history, redo_index);
+
+    return result;
+}
+
+/*
+Read the rest of a file written by Save(), in the order written by
+operator String().  The board, the messages, the scores, and the clocks
+are skipped, since replaying the history recreates them (apart from the
+clocks).  Return false if the file is invalid.
+*/
+bool Game::Unpack(GameText& rText) {
+    ASSERT(mHands.IsEmpty());
+    ASSERT(mHistory.Count() == 0);
+
+    rText.Expect("AmClient=");
+    rText.GetLine();
+    rText.Expect("BestRunReport=");
+    rText.SkipBlock();
+    rText.Expect("\nBoard=");
+    rText.GetLine();
+    rText.Expect("FirstTurnMessage=");
+    rText.SkipBlock();
+    rText.Expect("\nHands=");
+    Strings hand_names;
+    HandOpts const hand_opts = rText.GetHands(hand_names);
+    rText.Expect("\nHistory=");
+    Turns const history = rText.GetTurns();
+    rText.Expect("\nMustPlay=");
+    rText.GetLine();
+    rText.Expect("PlayableHand=");
+    rText.GetLine();
+    rText.Expect("Redo=");
+    SizeType const redo_index = SizeType(rText.GetNumber());
+    rText.Expect("\nStockBag=");
+    rText.GetTiles();
+    rText.Expect("\n");
+
+    if (!rText.IsGood() || !UnpackHands(hand_opts)) {
+        return false;
+    }
+
+    // The hand names are derived from the options, so they should match.
+    Strings::ConstIterator i_name = hand_names.Begin();
+    Hands::ConstIterator i_hand;
+    for (i_hand = mHands.begin(); i_hand != mHands.end(); i_hand++) {
+        if (i_hand->Name() != *i_name) {
+            return false;
+        }
+        i_name++;
+    }
+
+    Tiles const all_tiles = rText.AllTiles();
+    bool const result = UnpackHistory(all_tiles, history, redo_index);
+
+    return result;
+}
+
+/*
+Check the hand options read from a file, in any of the formats, and
+construct the hands.  Return false if the options are invalid.
+*/
+bool Game::UnpackHands(HandOpts const& rHandOpts) {
+    ASSERT(mHands.IsEmpty());
+
+    if (rHandOpts.Count() != mOptions.HandsDealt()) {
+        return false;
+    }
+    for (SizeType i_hand = 0; i_hand < rHandOpts.Count(); i_hand++) {
+        if (!rHandOpts[i_hand].IsValid()) {
+            return false;
+        }
+    }
+    AddHands(rHandOpts);
+
+    return true;
+}
+
+/*
+Install the tiles and the history read from a file, in any of the
+formats, and replay the history up to a position, checking each turn.
+Return false if the history is invalid.
+*/
+bool Game::UnpackHistory(
+    Tiles const& rAllTiles,
+    Turns const& rHistory,
+    SizeType redoIndex)
+{
+    ASSERT(mHistory.Count() == 0);
+
+    // Every tile was either drawn at some point or is still in the stock bag.
+    mStockBag = StockBag(rAllTiles);
+    mHistory = rHistory;
+
+    bool const result = Replay(redoIndex);
+
+    return result;
+}
+
+/*
+Read the rest of a journal written by Save():  the hand options, the
+tiles, and the records.  Each record replaces any turns at or after its
+index, so the last record for an index wins.  An incomplete last line
+(from a write which was interrupted) is ignored.  The game resumes at
+the end of the history.  Return false if the journal is invalid.
+*/
+bool Game::UnpackJournal(GameText& rText) {
+    ASSERT(mHands.IsEmpty());
+    ASSERT(mHistory.Count() == 0);
+
+    HandOpts hand_opts;
+    while (rText.IsGood() && !rText.Accept("Tiles=")) {
+        String const hand_text = rText.GetParagraph();
+        HandOpt const hand_opt(hand_text);
+        hand_opts.Append(hand_opt);
+    }
+    rText.GetTiles();
+    rText.Expect("\n\n");
+
+    if (!rText.IsGood() || !UnpackHands(hand_opts)) {
+        return false;
+    }
+
+    Turns history;
+    while (rText.HasLine()) {
+        SizeType const index = SizeType(rText.GetNumber());
+        rText.Expect(" ");
+        Turn const turn = rText.GetTurn();
+        rText.Expect("\n");
+        if (!rText.IsGood() || index > history.Count()) {
+            return false;
+        }
+        history.Truncate(index);
+        history.Append(turn);
+    }
+    if (!rText.IsGood()) {
+        return false;
+    }
+
+    Tiles const all_tiles = rText.AllTiles();
+    bool const result = UnpackHistory(all_tiles, history, history.Count());
+
+    return result;
+}
+
 // Return a list of unplayable hands (including those which have resigned).
 Hands Game::UnplayableHands(void) const {
     Hands result;
@@ -975,6 +1637,23 @@ Hands Game::UnplayableHands(void) const {
     return result;
 }
 
+// Return the tiles which the playable hand cannot see:  those in the
+// stock bag plus those in every other hand.  The composition of this set
+// is public information, even though the location of each tile is not.
+Tiles Game::UnseenTiles(void) const {
+    Tiles result = mStockBag;
+
+    Hands::ConstIterator i_hand;
+    for (i_hand = mHands.begin(); i_hand != mHands.end(); i_hand++) {
+        if (i_hand != miPlayableHand) {
+            Tiles const hand_tiles = Tiles(*i_hand);
+            result.Merge(hand_tiles);
+        }
+    }
+
+    return result;
+}
+
 Strings Game::WinningHands(void) const {
     ScoreType const winning_score = WinningScore();
 
@@ -998,6 +1677,20 @@ ScoreType Game::WinningScore(void) const {
     return result;
 }
 
+// (Re)write the journal from scratch:  the header plus the whole history.
+bool Game::WriteJournal(String const& rFilespec) {
+    Strings records;
+    for (SizeType i_turn = 0; i_turn < mHistory.Count(); i_turn++) {
+        String const record = JournalRecord(i_turn, mHistory[i_turn]);
+        records.Append(record);
+    }
+
+    String const header = JournalHeader();
+    bool const result = mJournal.Open(rFilespec, header, records);
+
+    return result;
+}
+
 
 // inquiry methods
 
@@ -1005,15 +1698,46 @@ bool Game::AmClient(void) const {
     return mAmClient;
 }
 
+// Check that the history starts with one deal per hand, in the order of
+// the hands, each drawing a full hand from the tiles of the game.
+bool Game::AreValidDeals(void) const {
+    if (mHistory.Count() < mHands.Count()) {
+        return false;
+    }
+
+    Tiles undealt = AllTiles();
+    for (SizeType i_hand = 0; i_hand < mHands.Count(); i_hand++) {
+        Turn const& r_turn = mHistory[i_hand];
+        Move const move = Move(r_turn);
+        Tiles const draw = r_turn.Draw();
+        if (r_turn.HandName() != mHands[i_hand].Name()
+         || r_turn.Points() != 0
+         || !move.IsPass()
+         || draw.Count() != HandSize())
+        {
+            return false;
+        }
+
+        Tiles::ConstIterator i_tile;
+        for (i_tile = draw.begin(); i_tile != draw.end(); i_tile++) {
+            if (!undealt.Contains(*i_tile)) {
+                return false;
+            }
+        }
+        undealt.Purge(draw);
+    }
+
+    return true;
+}
+
 bool Game::CanRedo(void) const {
-    bool const result = (miRedo != mHistory.end());
+    bool const result = (mRedoIndex < mHistory.Count());
 
     return result;
 }
 
 bool Game::CanUndo(void) const {
-    SizeType const turn = mHistory.Index(miRedo);
-    bool const result = (turn > mHands.Count());
+    bool const result = (mRedoIndex > mHands.Count());
 
     return result;
 }
@@ -1055,6 +1779,12 @@ bool Game::IsConnectedToServer(Address const& rServer) const {
     return result;
 }
 
+bool Game::IsContextSelected(void) const {
+    bool const result = mContext.IsCurrent();
+
+    return result;
+}
+
 bool Game::IsDisabled(void) const {
     bool const result = (!mAmClient && !mClient.IsValid());
 
@@ -1120,8 +1850,121 @@ bool Game::IsPaused(void) const {
     return result;
 }
 
+/*
+Unlike IsLegalMove(), which trusts the move to come from the playable
+hand, check a move read from a file or the network:  that it uses only
+tiles from the playable hand, once each, on cells that fit the board.
+*/
+bool Game::IsPlayableMove(Move const& rMove) const {
+    if (rMove.RepeatsTile()) {
+        return false;
+    }
+
+    Tiles const hand_tiles = Tiles(*miPlayableHand);
+    Move::ConstIterator i_tile_cell;
+    for (i_tile_cell = rMove.Begin(); i_tile_cell != rMove.End(); i_tile_cell++) {
+        Tile const tile = i_tile_cell->operator Tile();
+        if (!hand_tiles.Contains(tile.Id())) {
+            return false;
+        }
+        if (!i_tile_cell->IsSwap()) {
+            Cell const cell = *i_tile_cell;
+            if (!cell.IsValid()) {
+                return false;
+            }
+        }
+    }
+
+    bool result = false;
+    if (rMove.IsResign()) {
+        // A resignation returns the whole hand to the stock bag.
+        result = (rMove.Count() == hand_tiles.Count());
+    } else if (mMustPlay == 0 || rMove.CountTilesPlayed() == mMustPlay) {
+        // On the first turn, IsLegalMove() requires the number of tiles played.
+        result = IsLegalMove(rMove);
+    }
+
+    return result;
+}
+
+/*
+Check that the next turn in the history can be redone:  that it belongs
+to the playable hand, is a playable move, draws replacements from the
+stock bag, and scores the recorded points.
+*/
+bool Game::IsValidRedo(void) const {
+    ASSERT(CanRedo());
+
+    Turn const& r_turn = mHistory[mRedoIndex];
+    Move const move = Move(r_turn);
+    if (r_turn.HandName() != miPlayableHand->Name()
+     || miPlayableHand->HasResigned()
+     || r_turn.MustPlay() != mMustPlay
+     || !IsPlayableMove(move))
+    {
+        return false;
+    }
+
+    Tiles const draw = r_turn.Draw();
+    SizeType const tile_cnt = move.Count();
+    if (move.IsResign()) {
+        bool const result = draw.IsEmpty() && r_turn.Points() == 0;
+        return result;
+    }
+
+    // Replacements are drawn from the stock bag, as many as it holds.
+    SizeType const stock_cnt = CountStock();
+    SizeType const draw_cnt = (tile_cnt < stock_cnt) ? tile_cnt : stock_cnt;
+    if (draw.Count() != draw_cnt) {
+        return false;
+    }
+    Tiles::ConstIterator i_tile;
+    for (i_tile = draw.begin(); i_tile != draw.end(); i_tile++) {
+        if (!mStockBag.Contains(*i_tile)) {
+            return false;
+        }
+    }
+
+    ScoreType points = 0;
+    if (!move.InvolvesSwap()) {
+        // Score the move the way Redo() will, after placing its tiles.
+        Board after(mBoard);
+        after.PlayMove(move);
+        points = after.ScoreMove(move);
+    }
+    bool const result = (r_turn.Points() == points);
+
+    return result;
+}
+
 bool Game::IsStockEmpty(void) const {
     bool const result = (CountStock() == 0);
 
     return result;
 }
+
+
+// global utility functions
+
+String ending_to_string(EndingType ending) {
+    String result;
+
+    switch (ending) {
+    case ENDING_NOT_OVER_YET:
+        result = "not over yet";
+        break;
+    case ENDING_WENT_OUT:
+        result = "went out";
+        break;
+    case ENDING_ALL_RESIGNED:
+        result = "all resigned";
+        break;
+    case ENDING_STUCK:
+        result = "stuck";
+        break;
+    default:
+        FAIL();
+    }
+
+    return result;
+}
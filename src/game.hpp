@@ -30,15 +30,32 @@ A Game object represents the state of a game in progress.
 
 The Game class owns various Tile objects, which are stored in three
 places:  a Board object, a Hands object, and a Tiles object (for the stock bag).
-The game history is stored using a Turns object and an iterator to
-indicate the current position therein.  The options used to create
-the game are saved in a GameOpt object.
+The game history is stored using a Turns object and an index to
+indicate the current position therein.  Checkpoint objects taken every
+few turns allow SeekTurn() to move to any position without replaying
+the whole history.  The options used to create
+the game are saved in a GameOpt object.  Load() reads the binary
+format of SaveBinary() (via a GameFile object), or else the journal
+written by Save() or the text of operator String() (via a GameText object).
+
+Each game owns a GameContext, which holds the configuration and tile table
+consulted by the Cell and Tile classes.  Constructing a game selects its
+context for the constructing thread; any other thread must call
+SelectContext() before operating on the game.
 
 */
 
+#include <vector>       // HASA std::vector
 #include "board.hpp"    // HASA Board
+#include "checkpoint.hpp" // HASA Checkpoint
+#include "gamecontext.hpp" // HASA GameContext
 #include "gameopt.hpp"  // HASA GameOpt
 #include "hands.hpp"    // HASA Hands
+#include "journal.hpp"  // HASA Journal
+#include "observers.hpp" // HASA Observers
+#include "random.hpp"   // HASA Random
+#include "stockbag.hpp" // HASA StockBag
+#include "suggestioncache.hpp"  // HASA SuggestionCache
 #include "turns.hpp"    // HASA Turns
 
 enum EndingType {
@@ -50,9 +67,12 @@ enum EndingType {
 
 class Game {
 public:
+    // public constants
+    static const SizeType CHECKPOINT_INTERVAL = 8;  // turns between checkpoints
+
     // public lifecycle
     // no default constructor -- use Game::New()
-    // ~Game(void);  implicitly defined destructor
+    ~Game(void);
 
     // public operators
     operator Board(void) const;
@@ -61,28 +81,42 @@ public:
     operator HandOpts(void) const;
     operator Hands(void) const;  // all hands
     operator String(void) const;
+    operator Turns(void) const;  // the turns up to the current position
 
     // misc public methods
     void          ActivateNextHand(void);
     Tiles         ActiveTiles(void) const;
+    void          AddObserver(Observers::FunctionType*, void* arg);
     void          AddServer(Address const&, Socket const&);
+    void          AddSuggestion(String const& key, Move const&) const;
     String        BestRunReport(void) const;
+    void          CheckClock(void);
     static void   ConsoleGame(void);
     SizeType      CountStock(void) const;
     void          Disable(void);
     void          DisableServers(Address const&);
+    EndingType    Ending(void) const;
     bool          DrawTiles(SizeType cnt, Hand&, Tiles&);
     String        EndBonus(void);
+    bool          FindSuggestion(String const& key, Move&) const;
     bool          FinishTurn(Move const&);
     SizeType      HandSize(void) const;
     bool          Initialize(void);
+    static Game*  Load(String const& filespec);
     SizeType      MustPlay(void) const;
     static Game*  New(GameOpt const&, HandOpts const&, Socket const& client);
+    bool          OpenJournal(String const& filespec);
+    bool          PutMoveToClient(Move const&);
     void          Redo(void);
+    void          RemoveObserver(Observers::FunctionType*, void* arg);
     void          Restart(void);
     void          Save(void);
+    bool          SaveBinary(String const& filespec);
     int           Seconds(Hand&) const;
     SecondsType   SecondsPerHand(void) const;
+    void          SeekTurn(SizeType turn);
+    void          SelectContext(void);
+    Random        SplitGenerator(void) const;
     void          StartClock(void);
     String        StockBagString(void) const;
     void          StopClock(void);
@@ -91,6 +125,7 @@ public:
     void          Undo(void);
     Indices       UndoTiles(void) const;
     Hands         UnplayableHands(void) const;
+    Tiles         UnseenTiles(void) const;
 
     // public inquiry methods
     bool AmClient(void) const;
@@ -100,6 +135,7 @@ public:
     bool HasUnsavedChanges(void) const;
     bool IsClockRunning(void) const;
     bool IsConnectedToServer(Address const&) const;
+    bool IsContextSelected(void) const;
     bool IsDisabled(void) const;
     bool IsLegalMove(Move const&) const;
     bool IsLegalMove(Move const&, UmType& reason) const;
@@ -107,47 +143,89 @@ public:
     bool IsOutOfTime(void) const;
     bool IsOver(void) const;
     bool IsPaused(void) const;
+    bool IsPlayableMove(Move const&) const;
     bool IsStockEmpty(void) const;
 
 private:
     // private constants
+    static const SizeType JOURNAL_GROWTH_MAX = 2;   // journal records per turn in the history before compaction
+    static const String   JOURNAL_MARKER;           // first line of every journal
     static const SizeType STUCK_THRESHOLD = 7;  // turns before game is declared "stuck" 
 
     // private data
     bool             mAmClient;
     String           mBestRunReport;
     Board            mBoard;         // extensible playing surface
+    std::vector<Checkpoint>
+                     mCheckpoints;   // snapshots after every CHECKPOINT_INTERVAL turns, for SeekTurn()
     Socket           mClient;        // socket for communicating with the client (if a server)
+    int              mClockSeconds;  // clock display last reported by CheckClock()
+    GameContext      mContext;       // configuration and tile table for this game
     String           mFilespec;      // associated file for load/save
     String           mFirstTurnMessage;
     Hands            mHands;         // all hands being played
     Turns            mHistory;       // history of turns for undo/redo
+    Journal          mJournal;       // append-only record of the turns, if journaling
+    bool             mMovePut;       // SERVER:  the playable hand's move was put before FinishTurn()
     SizeType         mMustPlay;      // min number of tiles to play, zero after the first turn
+    Observers        mObservers;     // callbacks notified of changes
     GameOpt const    mOptions;
     Hands::Iterator miPlayableHand;  // whose turn it is
-    Turns::Iterator miRedo;          // current position in the history
-    Tiles            mStockBag;      // stock bag from which tiles are drawn
+    Random           mRandom;        // pseudo-random generator for draws, seeded from mSeed
+    SizeType         mRedoIndex;     // current position in the history
+    SeedType         mSeed;          // chosen at the start of the game
+    StockBag         mStockBag;      // stock bag from which tiles are drawn
+    mutable SuggestionCache
+                     mSuggestions;   // recent results of Partial::Suggest(), not part of the game state
     bool             mUnsavedChanges;
 
     // private lifecycle
     Game(GameOpt const&, HandOpts const&, Socket const& client);
+    explicit Game(GameOpt const&);
     Game(Game const&);  // not copyable
 
     // private operators
     Game& operator=(Game const&);  // not assignable
 
     // misc private methods
+    void       AddHands(HandOpts const&);
     void       AddTurn(Turn const&);
+    Tiles      AllTiles(void) const;
     bool       ConnectToServers(void);
     void       DescribeScores(void) const;
     void       DescribeStatus(void) const;
-    EndingType Ending(void) const;
     void       FindBestRun(void);
     bool       FirstTurnConsole(void);
+    String     JournalHeader(void) const;
+    static String
+               JournalRecord(SizeType index, Turn const&);
     bool       NextTurnConsole(void);
+    void       NotifyHands(void) const;
+    void       NotifyMove(Move const&, EventType) const;
+    void       NotifyTiles(EventType, String const& handName, Cells const&,
+                   Tiles const&) const;
+    void       NotifyTurn(void);
     void       PlayConsole(void);
     void       PutLineToEachServer(String const&);
+    bool       Replay(SizeType redoIndex);
+    void       RestoreCheckpoint(Checkpoint const&);
+    void       TakeCheckpoint(void);
+    bool       Unpack(GameFile&);
+    bool       Unpack(GameText&);
+    bool       UnpackHands(HandOpts const&);
+    bool       UnpackHistory(Tiles const& allTiles, Turns const&,
+                   SizeType redoIndex);
+    bool       UnpackJournal(GameText&);
     Strings    WinningHands(void) const;
     ScoreType  WinningScore(void) const;
+    bool       WriteJournal(String const& filespec);
+
+    // private inquiry methods
+    bool AreValidDeals(void) const;
+    bool IsValidRedo(void) const;
 };
+
+// global utility functions
+String ending_to_string(EndingType);
+
 #endif  // !defined(GAME_HPP_INCLUDED)
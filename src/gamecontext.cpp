@@ -0,0 +1,102 @@
+// File:     gamecontext.cpp
+// Location: src
+// Purpose:  implement GameContext class
+// Author:   Stephen Gold sgold@sonic.net
+// (c) Copyright 2012 Stephen Gold
+// Distributed under the terms of the GNU General Public License
+
+/*
+This file is part of the Gold Tile Game.
+
+The Gold Tile Game is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by the 
+Free Software Foundation, either version 3 of the License, or (at your 
+option) any later version.
+
+The Gold Tile Game is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY 
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License 
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with the Gold Tile Game.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gamecontext.hpp"
+
+
+// static data
+
+GameContext               GameContext::msDefault;
+THREAD_LOCAL GameContext* GameContext::mspSelected = NULL;
+
+
+// lifecycle
+
+GameContext::GameContext(void):
+    mBonusProbability(0.0)
+{
+    mGrid = GRID_4WAY;
+    mHeight = Cell::HEIGHT_MAX;
+    mWidth = Cell::WIDTH_MAX;
+    mWrapFlag = false;
+
+    mAttrCnt = 0;
+    mIdCnt = 0;
+    mPackedMask = 0;
+
+    mpYieldArgument = NULL;
+    mpYieldFunction = NULL;
+
+    mNextId = Tile::ID_FIRST;
+}
+
+/*
+Configure a context for a game.  The Cell and Tile classes
+configure themselves through the selected context, so this
+context is selected temporarily.  The yield callback is inherited
+from the context which was current, so that a callback installed
+at startup applies to every game.
+*/
+GameContext::GameContext(GameOpt const& rGameOpt):
+    mBonusProbability(0.0)
+{
+    GameContext const& r_current = Current();
+    mpYieldArgument = r_current.mpYieldArgument;
+    mpYieldFunction = r_current.mpYieldFunction;
+
+    GameContext* const p_selected = mspSelected;
+    mspSelected = this;
+
+    Cell::Configure(rGameOpt);
+    Tile::Configure(rGameOpt);
+
+    mspSelected = p_selected;
+}
+
+// The implicitly defined destructor is fine.
+
+
+// misc methods
+
+/* static */ GameContext& GameContext::Current(void) {
+    GameContext* p_result = mspSelected;
+    if (p_result == NULL) {
+        p_result = &msDefault;
+    }
+
+    return *p_result;
+}
+
+/* static */ void GameContext::Select(GameContext* pContext) {
+    mspSelected = pContext;
+}
+
+
+// inquiry methods
+
+bool GameContext::IsCurrent(void) const {
+    bool const result = (&Current() == this);
+
+    return result;
+}
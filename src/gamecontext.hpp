@@ -0,0 +1,114 @@
+#ifndef GAMECONTEXT_HPP_INCLUDED
+#define GAMECONTEXT_HPP_INCLUDED
+
+// File:     gamecontext.hpp
+// Location: src
+// Purpose:  declare GameContext class
+// Author:   Stephen Gold sgold@sonic.net
+// (c) Copyright 2012 Stephen Gold
+// Distributed under the terms of the GNU General Public License
+
+/*
+This file is part of the Gold Tile Game.
+
+The Gold Tile Game is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by the 
+Free Software Foundation, either version 3 of the License, or (at your 
+option) any later version.
+
+The Gold Tile Game is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY 
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License 
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with the Gold Tile Game.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+A GameContext object represents the configuration shared by every
+Cell, Combo, and Tile in a particular game:  the shape and size of
+the grid, the attributes of tiles, and the table of tile options.
+Each game owns a context, so several games can coexist in one process,
+and games on different threads can run concurrently.
+
+The GameContext class is implemented with a thread-local pointer to the
+context selected for each thread.  The Cell, Combo, Tile, and Partial
+classes consult the selected context wherever they used to consult
+static data, so a thread must select a game's context (using Select())
+before operating on that game.  A thread which hasn't selected any
+context uses a default context, as configured before any game.
+The Workers class passes the caller's selection on to its threads.
+*/
+
+#include <vector>       // HASA std::vector
+#include "cell.hpp"     // HASA GridType
+#include "fraction.hpp" // HASA Fraction
+#include "tile.hpp"     // HASA Tile::IdType
+
+class GameContext {
+public:
+    // public types
+    typedef void YieldFunctionType(void*, bool& cancel);
+
+    // public lifecycle
+    GameContext(void);  // as configured before any game
+    explicit GameContext(GameOpt const&);
+    // ~GameContext(void);  implicitly defined destructor
+
+    // misc public methods
+    static GameContext& Current(void);
+    static void         Select(GameContext*);  // NULL selects the default
+
+    // public inquiry methods
+    bool IsCurrent(void) const;
+
+private:
+    // Only the classes which used to keep this data in static members
+    // may access it.
+    friend class Cell;
+    friend class Combo;
+    friend class Partial;
+    friend class Tile;
+
+    // private constants
+    static const unsigned REGION_CNT = 2;  // one table per Tile::RegionType
+
+    // private data, used by the Cell class
+    GridType   mGrid;
+    RowType    mHeight;    // must be even and <= Cell::HEIGHT_MAX
+    ColumnType mWidth;     // must be even and <= Cell::WIDTH_MAX
+    bool       mWrapFlag;  // coordinates wrap around
+
+    // private data, used by the Combo class
+    AttrCntType           mAttrCnt;     // number of attributes per tile
+    std::vector<bool>     mCompatible;  // indexed by first ID times mIdCnt plus second ID
+    ComboCntType          mIdCnt;       // number of IDs, or 0 if too many combinations
+    Combo::PackedType     mPackedMask;  // low bit of each attribute in use
+    std::vector<AttrType> mValueMax;    // max value for each tile attribute
+
+    // private data, used by the Partial class
+    void*              mpYieldArgument;
+    YieldFunctionType* mpYieldFunction;
+
+    // private data, used by the Tile class
+    std::vector<AttrType> mAttrs[REGION_CNT];  // Combo::AttrCnt() attributes per slot
+    std::vector<bool>     mBonus[REGION_CNT];  // one bonus flag per slot
+    Fraction              mBonusProbability;
+    std::vector<Combo::IdType>
+                          mComboIds[REGION_CNT]; // combo IDs, if Combo::HasIds()
+    Tile::IdType          mNextId;
+    std::vector<Combo::PackedType>
+                          mPacked[REGION_CNT];   // packed attributes, if Combo::CanPack()
+
+    static GameContext msDefault;  // used by threads which haven't selected a context
+    static THREAD_LOCAL GameContext*
+                       mspSelected; // context selected by the current thread, or NULL
+
+    // private lifecycle
+    GameContext(GameContext const&);  // not copyable
+
+    // private operators
+    GameContext& operator=(GameContext const&);  // not assignable
+};
+#endif  // !defined(GAMECONTEXT_HPP_INCLUDED)
@@ -0,0 +1,160 @@
+// File:     gameevent.cpp
+// Location: src
+// Purpose:  implement GameEvent class
+// Author:   Stephen Gold sgold@sonic.net
+// (c) Copyright 2012 Stephen Gold
+// Distributed under the terms of the GNU General Public License
+
+/*
+This file is part of the Gold Tile Game.
+
+The Gold Tile Game is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by the 
+Free Software Foundation, either version 3 of the License, or (at your 
+option) any later version.
+
+The Gold Tile Game is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY 
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License 
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with the Gold Tile Game.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gameevent.hpp"
+
+
+// static functions
+
+static String type_to_string(EventType type) {
+    String result;
+
+    switch (type) {
+    case EVENT_TILES_PLACED:
+        result = "placed";
+        break;
+    case EVENT_TILES_REMOVED:
+        result = "removed";
+        break;
+    case EVENT_HAND_CHANGED:
+        result = "hand";
+        break;
+    case EVENT_SCORE_CHANGED:
+        result = "score";
+        break;
+    case EVENT_CLOCK_TICKED:
+        result = "clock";
+        break;
+    case EVENT_TURN_ADVANCED:
+        result = "turn";
+        break;
+    default:
+        FAIL();
+    }
+
+    return result;
+}
+
+
+// lifecycle
+
+GameEvent::GameEvent(EventType type, String const& rHandName)
+:   mHandName(rHandName)
+{
+    mScore = 0;
+    mSeconds = 0;
+    mTurn = 0;
+    mType = type;
+}
+
+// The implicitly defined copy constructor is OK.
+// The implicitly defined destructor is OK.
+
+
+// operators
+
+// The implicitly defined assignment operator is OK.
+
+GameEvent::operator Cells(void) const {
+    return mCells;
+}
+
+GameEvent::operator EventType(void) const {
+    return mType;
+}
+
+// Convert to a string for logging or for a network mirror.
+GameEvent::operator String(void) const {
+    String result = "event{" + ::type_to_string(mType);
+    if (!mHandName.IsEmpty()) {
+        result += " " + mHandName;
+    }
+
+    switch (mType) {
+    case EVENT_TILES_PLACED:
+    case EVENT_TILES_REMOVED:
+        result += " " + String(mCells) + " " + String(mTiles);
+        break;
+    case EVENT_HAND_CHANGED:
+        result += " " + String(mTiles);
+        break;
+    case EVENT_SCORE_CHANGED:
+        result += " " + String(mScore);
+        break;
+    case EVENT_CLOCK_TICKED:
+        result += " " + String(long(mSeconds));
+        break;
+    case EVENT_TURN_ADVANCED:
+        result += " " + String(unsigned(mTurn));
+        break;
+    default:
+        FAIL();
+    }
+    result += "}";
+
+    return result;
+}
+
+GameEvent::operator Tiles(void) const {
+    return mTiles;
+}
+
+
+// misc methods
+
+String GameEvent::HandName(void) const {
+    return mHandName;
+}
+
+ScoreType GameEvent::Score(void) const {
+    return mScore;
+}
+
+int GameEvent::Seconds(void) const {
+    return mSeconds;
+}
+
+void GameEvent::SetCells(Cells const& rCells) {
+    mCells = rCells;
+}
+
+void GameEvent::SetScore(ScoreType score) {
+    mScore = score;
+}
+
+void GameEvent::SetSeconds(int seconds) {
+    mSeconds = seconds;
+}
+
+void GameEvent::SetTiles(Tiles const& rTiles) {
+    mTiles = rTiles;
+}
+
+void GameEvent::SetTurn(SizeType turn) {
+    mTurn = turn;
+}
+
+SizeType GameEvent::Turn(void) const {
+    return mTurn;
+}
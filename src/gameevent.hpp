@@ -0,0 +1,90 @@
+#ifndef GAMEEVENT_HPP_INCLUDED
+#define GAMEEVENT_HPP_INCLUDED
+
+// File:     gameevent.hpp
+// Location: src
+// Purpose:  declare GameEvent class
+// Author:   Stephen Gold sgold@sonic.net
+// (c) Copyright 2012 Stephen Gold
+// Distributed under the terms of the GNU General Public License
+
+/*
+This file is part of the Gold Tile Game.
+
+The Gold Tile Game is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by the 
+Free Software Foundation, either version 3 of the License, or (at your 
+option) any later version.
+
+The Gold Tile Game is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY 
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License 
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with the Gold Tile Game.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/*
+A GameEvent object represents a change to a Game or Partial, reported to
+observers so that views and network mirrors can update only what changed.
+
+Which fields are meaningful depends on the type of event:
+  EVENT_TILES_PLACED, EVENT_TILES_REMOVED:  cells and tiles
+  EVENT_HAND_CHANGED:  hand name and the hand's new tiles
+  EVENT_SCORE_CHANGED:  hand name and the hand's new score
+  EVENT_CLOCK_TICKED:  hand name and the seconds displayed on its clock
+  EVENT_TURN_ADVANCED:  name of the newly playable hand and the turn index
+*/
+
+#include "cells.hpp"  // HASA Cells
+#include "tiles.hpp"  // HASA Tiles
+
+enum EventType {
+    EVENT_TILES_PLACED,
+    EVENT_TILES_REMOVED,
+    EVENT_HAND_CHANGED,
+    EVENT_SCORE_CHANGED,
+    EVENT_CLOCK_TICKED,
+    EVENT_TURN_ADVANCED
+};
+
+
+class GameEvent {
+public:
+    // public lifecycle
+    // no default constructor
+    GameEvent(EventType, String const& handName);
+    // GameEvent(GameEvent const&);  implicitly defined copy constructor
+    // ~GameEvent(void);  implicitly defined destructor
+
+    // public operators
+    // GameEvent& operator=(GameEvent const&);  implicitly defined assignment operator
+    operator Cells(void) const;
+    operator EventType(void) const;
+    operator String(void) const;
+    operator Tiles(void) const;
+
+    // misc public methods
+    String    HandName(void) const;
+    ScoreType Score(void) const;
+    int       Seconds(void) const;
+    void      SetCells(Cells const&);
+    void      SetScore(ScoreType);
+    void      SetSeconds(int);
+    void      SetTiles(Tiles const&);
+    void      SetTurn(SizeType);
+    SizeType  Turn(void) const;
+
+private:
+    // private data
+    Cells     mCells;     // cells where tiles were placed or removed
+    String    mHandName;
+    ScoreType mScore;
+    int       mSeconds;   // as displayed on the clock
+    Tiles     mTiles;     // tiles placed or removed, or the contents of the hand
+    SizeType  mTurn;      // index of the turn in the game history
+    EventType mType;
+};
+#endif  // !defined(GAMEEVENT_HPP_INCLUDED)
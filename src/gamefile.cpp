@@ -0,0 +1,374 @@
+// File:     gamefile.cpp
+// Location: src
+// Purpose:  implement GameFile class
+// Author:   Stephen Gold sgold@sonic.net
+// (c) Copyright 2012 Stephen Gold
+// Distributed under the terms of the GNU General Public License
+
+/*
+This file is part of the Gold Tile Game.
+
+The Gold Tile Game is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by the 
+Free Software Foundation, either version 3 of the License, or (at your 
+option) any later version.
+
+The Gold Tile Game is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY 
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License 
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with the Gold Tile Game.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <fstream>
+#include "gamefile.hpp"
+#include "hands.hpp"
+
+
+// static constants
+
+const uint8_t GameFile::MAGIC[4] = { 'G', 'T', 'G', 'B' };
+
+
+// lifecycle
+
+GameFile::GameFile(void) {
+    mIsGood = true;
+    mpMap = NULL;
+    mpNext = NULL;
+    mpEnd = NULL;
+
+    for (unsigned i_byte = 0; i_byte < sizeof(MAGIC); i_byte++) {
+        PutByte(MAGIC[i_byte]);
+    }
+    PutByte(uint8_t(VERSION));
+    PutByte(uint8_t(VERSION >> 8));
+}
+
+// Map an existing file and check its header.
+GameFile::GameFile(String const& rFilespec) {
+    mpMap = new FileMap(rFilespec);
+    ASSERT(mpMap != NULL);
+
+    mIsGood = mpMap->IsValid();
+    mpNext = NULL;
+    mpEnd = NULL;
+    if (mIsGood) {
+        mpNext = mpMap->Bytes();
+        mpEnd = mpNext + mpMap->Size();
+    }
+
+    for (unsigned i_byte = 0; i_byte < sizeof(MAGIC); i_byte++) {
+        if (GetByte() != MAGIC[i_byte]) {
+            mIsGood = false;
+        }
+    }
+    uint16_t version = GetByte();
+    version |= uint16_t(GetByte()) << 8;
+    if (version != VERSION) {
+        mIsGood = false;
+    }
+}
+
+GameFile::~GameFile(void) {
+    delete mpMap;
+}
+
+
+// misc methods
+
+uint8_t GameFile::GetByte(void) {
+    uint8_t result = 0;
+
+    if (mpNext < mpEnd) {
+        result = *mpNext;
+        mpNext++;
+    } else {
+        mIsGood = false;
+    }
+
+    return result;
+}
+
+SizeType GameFile::GetCount(void) {
+    SizeType const result = GetUnsigned();
+
+    return result;
+}
+
+// Decode a list of tile IDs written by PutIds().
+Tiles GameFile::GetIds(void) {
+    Tiles result;
+
+    SizeType const cnt = GetCount();
+    Tile::IdType id = 0;
+    for (SizeType i_id = 0; i_id < cnt && mIsGood; i_id++) {
+        id += GetSigned();
+        if (Tile::IsValid(id) && !result.Contains(id)) {
+            result.Add(id);
+        } else {
+            mIsGood = false;
+        }
+    }
+
+    return result;
+}
+
+// Decode a zigzag-encoded integer.
+int32_t GameFile::GetSigned(void) {
+    uint32_t const zigzag = GetUnsigned();
+    int32_t const result = int32_t((zigzag >> 1) ^ (0 - (zigzag & 1)));
+
+    return result;
+}
+
+String GameFile::GetString(void) {
+    SizeType const length = GetCount();
+
+    String result;
+    if (mIsGood && length <= SizeType(mpEnd - mpNext)) {
+        result = std::string((char const*)mpNext, length);
+        mpNext += length;
+    } else {
+        mIsGood = false;
+    }
+
+    return result;
+}
+
+/*
+Decode the table written by PutTileTable(), recreating each tile with
+its ID and options.  Call this only after Tile::Configure().
+*/
+Tiles GameFile::GetTileTable(void) {
+    Tiles result;
+
+    SizeType const cnt = GetCount();
+    AttrCntType const attr_cnt = Combo::AttrCnt();
+    Tile::IdType id = 0;
+    for (SizeType i_tile = 0; i_tile < cnt && mIsGood; i_tile++) {
+        id += GetSigned();
+
+        TileOpt opt;
+        for (AttrIndexType i_attr = 0; i_attr < attr_cnt; i_attr++) {
+            AttrType const value = AttrType(GetUnsigned());
+            if (value < Combo::ValueCnt(i_attr)) {
+                opt.SetAttr(i_attr, value);
+            } else {
+                mIsGood = false;
+            }
+        }
+        bool const has_bonus = (GetByte() != 0);
+        opt.SetBonus(has_bonus);
+
+        if (mIsGood && id >= Tile::ID_FIRST && id < Tile::ID_MAX
+         && !result.Contains(id)) {
+            Tile const tile(id, opt);
+            result.Add(id);
+        } else {
+            mIsGood = false;
+        }
+    }
+
+    return result;
+}
+
+// Decode a turn written by PutTurn().
+Turn GameFile::GetTurn(Hands const& rHands) {
+    SizeType const i_hand = GetCount();
+    SizeType const must_play = GetCount();
+    ScoreType const points = GetUnsigned();
+    bool const resign_flag = (GetByte() != 0);
+
+    String hand_name;
+    if (i_hand < rHands.Count()) {
+        hand_name = rHands[i_hand].Name();
+    } else {
+        mIsGood = false;
+    }
+
+    Move move;
+    SizeType const place_cnt = GetCount();
+    for (SizeType i_place = 0; i_place < place_cnt && mIsGood; i_place++) {
+        Tile::IdType const id = GetSigned();
+        RowType const row = GetSigned();
+        ColumnType const column = GetSigned();
+        if (Tile::IsValid(id)) {
+            move.Add(Tile(id), Cell(row, column));
+        } else {
+            mIsGood = false;
+        }
+    }
+    Tiles const swap = GetIds();
+    if (resign_flag) {
+        move.MakeResign(swap);
+    } else {
+        Tiles::ConstIterator i_id;
+        for (i_id = swap.begin(); i_id != swap.end(); i_id++) {
+            move.AddSwapTile(Tile(*i_id));
+        }
+    }
+    Tiles const draw = GetIds();
+
+    Turn result(move, hand_name, must_play);
+    result.SetDraw(draw);
+    result.SetPoints(points);
+
+    return result;
+}
+
+// Decode a variable-length integer, seven bits per byte, low bits first.
+uint32_t GameFile::GetUnsigned(void) {
+    uint32_t result = 0;
+
+    unsigned shift = 0;
+    uint8_t byte = 0;
+    do {
+        byte = GetByte();
+        result |= uint32_t(byte & 0x7f) << shift;
+        shift += 7;
+    } while ((byte & 0x80) != 0 && shift < 35);
+
+    if ((byte & 0x80) != 0) {
+        // too many bytes for 32 bits
+        mIsGood = false;
+    }
+
+    return result;
+}
+
+void GameFile::PutByte(uint8_t byte) {
+    ASSERT(mpMap == NULL);
+
+    mBuffer.push_back(byte);
+}
+
+void GameFile::PutCount(SizeType cnt) {
+    PutUnsigned(cnt);
+}
+
+// Encode a list of tile IDs, each as its difference from the previous one.
+void GameFile::PutIds(Tiles const& rTiles) {
+    PutCount(rTiles.Count());
+
+    Tile::IdType previous = 0;
+    Tiles::ConstIterator i_id;
+    for (i_id = rTiles.begin(); i_id != rTiles.end(); i_id++) {
+        Tile::IdType const id = *i_id;
+        PutSigned(id - previous);
+        previous = id;
+    }
+}
+
+// Encode a signed integer so that small magnitudes have small codes.
+void GameFile::PutSigned(int32_t value) {
+    uint32_t const zigzag = (uint32_t(value) << 1) ^ uint32_t(value >> 31);
+    PutUnsigned(zigzag);
+}
+
+void GameFile::PutString(String const& rString) {
+    SizeType const length = SizeType(rString.size());
+    PutCount(length);
+    mBuffer.insert(mBuffer.end(), rString.begin(), rString.end());
+}
+
+// Encode the ID and options of every tile in a set.
+void GameFile::PutTileTable(Tiles const& rTiles) {
+    PutCount(rTiles.Count());
+
+    AttrCntType const attr_cnt = Combo::AttrCnt();
+    Tile::IdType previous = 0;
+    Tiles::ConstIterator i_id;
+    for (i_id = rTiles.begin(); i_id != rTiles.end(); i_id++) {
+        Tile const tile = Tile(*i_id);
+        Tile::IdType const id = tile.Id();
+        PutSigned(id - previous);
+        previous = id;
+
+        for (AttrIndexType i_attr = 0; i_attr < attr_cnt; i_attr++) {
+            PutUnsigned(tile.Attr(i_attr));
+        }
+        PutByte(tile.HasBonus() ? 1 : 0);
+    }
+}
+
+/*
+Encode a turn:  the index of its hand, the must-play count, the points,
+the resignation flag, the placed tiles with their cells, the swapped
+(or resigned) tiles, and the tiles drawn.
+*/
+void GameFile::PutTurn(Turn const& rTurn, Hands const& rHands) {
+    Hands::ConstIterator const i_hand = rHands.Find(rTurn.HandName());
+    ASSERT(i_hand != rHands.end());
+    PutCount(SizeType(i_hand - rHands.begin()));
+    PutCount(rTurn.MustPlay());
+    PutUnsigned(rTurn.Points());
+
+    Move const move = Move(rTurn);
+    PutByte(move.IsResign() ? 1 : 0);
+
+    SizeType place_cnt = 0;
+    Move::ConstIterator i_tile_cell;
+    for (i_tile_cell = move.Begin(); i_tile_cell != move.End(); i_tile_cell++) {
+        if (!i_tile_cell->IsSwap()) {
+            place_cnt++;
+        }
+    }
+    PutCount(place_cnt);
+
+    Tiles swap;
+    for (i_tile_cell = move.Begin(); i_tile_cell != move.End(); i_tile_cell++) {
+        Tile const tile = Tile(*i_tile_cell);
+        if (i_tile_cell->IsSwap()) {
+            swap.Add(tile.Id());
+        } else {
+            Cell const cell = Cell(*i_tile_cell);
+            PutSigned(tile.Id());
+            PutSigned(cell.Row());
+            PutSigned(cell.Column());
+        }
+    }
+    PutIds(swap);
+    PutIds(rTurn.Draw());
+}
+
+// Encode a variable-length integer, seven bits per byte, low bits first.
+void GameFile::PutUnsigned(uint32_t value) {
+    while (value >= 0x80) {
+        PutByte(uint8_t(value | 0x80));
+        value >>= 7;
+    }
+    PutByte(uint8_t(value));
+}
+
+// size of the encoded contents (in bytes)
+SizeType GameFile::Size(void) const {
+    SizeType result = SizeType(mBuffer.size());
+    if (mpMap != NULL) {
+        result = mpMap->Size();
+    }
+
+    return result;
+}
+
+bool GameFile::Write(String const& rFilespec) const {
+    ASSERT(mpMap == NULL);
+
+    std::ofstream file(rFilespec, std::ios::binary);
+    if (!mBuffer.empty()) {
+        file.write((char const*)&mBuffer[0], mBuffer.size());
+    }
+    file.close();
+    bool const result = !file.fail();
+
+    return result;
+}
+
+
+// inquiry methods
+
+bool GameFile::IsGood(void) const {
+    return mIsGood;
+}
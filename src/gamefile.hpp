@@ -0,0 +1,98 @@
+#ifndef GAMEFILE_HPP_INCLUDED
+#define GAMEFILE_HPP_INCLUDED
+
+// File:     gamefile.hpp
+// Location: src
+// Purpose:  declare GameFile class
+// Author:   Stephen Gold sgold@sonic.net
+// (c) Copyright 2012 Stephen Gold
+// Distributed under the terms of the GNU General Public License
+
+/*
+This file is part of the Gold Tile Game.
+
+The Gold Tile Game is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by the 
+Free Software Foundation, either version 3 of the License, or (at your 
+option) any later version.
+
+The Gold Tile Game is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY 
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License 
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with the Gold Tile Game.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+A GameFile object represents a saved game in the binary format, either
+being built in memory for writing or mapped from a file for reading.
+
+The format begins with a header:  the four bytes of MAGIC followed by
+a two-byte VERSION.  The rest is a sequence of fields, in the order the
+caller puts them.  Counts, IDs, and cell coordinates are variable-length
+integers (seven bits per byte, with signed values zigzag-encoded), and
+lists of tile IDs are delta-encoded, so most fields occupy a single byte.
+A reader decodes the fields in place from a FileMap, without any text
+parsing except for the options.  Reading past the end of the file, or
+decoding a value which is out of range, makes the GameFile bad.
+*/
+
+#include <vector>       // HASA std::vector
+#include "filemap.hpp"  // HASA FileMap
+#include "turn.hpp"     // USES Turn
+
+class GameFile {
+public:
+    // public constants
+    static const uint16_t VERSION = 1;
+
+    // public lifecycle
+    GameFile(void);  // for writing
+    explicit GameFile(String const& filespec);  // for reading
+    ~GameFile(void);
+
+    // misc public methods
+    SizeType GetCount(void);
+    String   GetString(void);
+    Tiles    GetTileTable(void);
+    Turn     GetTurn(Hands const&);
+    void     PutCount(SizeType);
+    void     PutString(String const&);
+    void     PutTileTable(Tiles const&);
+    void     PutTurn(Turn const&, Hands const&);
+    SizeType Size(void) const;
+    bool     Write(String const& filespec) const;
+
+    // public inquiry methods
+    bool IsGood(void) const;
+
+private:
+    // private constants
+    static const uint8_t MAGIC[4];
+
+    // private data
+    std::vector<uint8_t> mBuffer;  // encoded contents, if writing
+    bool                 mIsGood;  // false after a decoding error
+    FileMap*             mpMap;    // mapped contents, if reading
+    uint8_t const*       mpNext;   // next byte to decode, if reading
+    uint8_t const*       mpEnd;    // end of the mapped contents, if reading
+
+    // private lifecycle
+    GameFile(GameFile const&);  // not copyable
+
+    // private operators
+    GameFile& operator=(GameFile const&);  // not assignable
+
+    // misc private methods
+    uint8_t  GetByte(void);
+    Tiles    GetIds(void);
+    int32_t  GetSigned(void);
+    uint32_t GetUnsigned(void);
+    void     PutByte(uint8_t);
+    void     PutIds(Tiles const&);
+    void     PutSigned(int32_t);
+    void     PutUnsigned(uint32_t);
+};
+#endif  // !defined(GAMEFILE_HPP_INCLUDED)
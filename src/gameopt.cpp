@@ -39,18 +39,39 @@ GameOpt::GameOpt(void) {
     Validate();
 }
 
+/*
+Parse options written by operator String().  Text which can't be parsed
+leaves the options invalid rather than failing, since it may come from
+a file or the network, so check IsValid() before using them.
+*/
 GameOpt::GameOpt(String const& rString) {
+    mMinutesPerHand = MINUTES_PER_HAND_DEFAULT;
+    mRandomizeFlag = true;
+    mSeed = SEED_DEFAULT;
+    mStyle = GAME_STYLE_DEFAULT;
+    Standardize();
+
+    bool is_good = true;
     Strings const lines(rString, "\n");
     Strings::ConstIterator i_line;
-    for (i_line = lines.Begin(); i_line != lines.End(); i_line++) {
+    for (i_line = lines.Begin(); i_line != lines.End() && is_good; i_line++) {
         String const line = *i_line;
         Strings const fields(line, "=");
-        ASSERT(fields.Count() == 2); // TODO recovery
+        if (fields.Count() != 2) {
+            is_good = false;
+            break;
+        }
         String const name = fields.First();
         String const value = fields.Second();
+        bool const is_flag = (value == "true" || value == "false");
         if (name == "AttrCnt") {
-            mAttrCnt = ::string_to_attr_cnt(value);
-            mMaxAttrValues.resize(mAttrCnt);
+            long const attr_cnt = long(value);
+            is_good = (attr_cnt >= Combo::ATTR_CNT_MIN
+                    && attr_cnt <= Combo::ATTR_CNT_MAX);
+            if (is_good) {
+                mAttrCnt = ::string_to_attr_cnt(value);
+                mMaxAttrValues.resize(mAttrCnt);
+            }
         } else if (name == "BoardHeight") {
             mBoardHeight = ::string_to_index(value);
         } else if (name == "BoardWidth") {
@@ -60,29 +81,47 @@ GameOpt::GameOpt(String const& rString) {
         } else if (name == "ClonesPerCombo") {
             mClonesPerCombo = SizeType(long(value));
         } else if (name == "DoesBoardWrap") {
-            mDoesBoardWrap = bool(value);
+            is_good = is_flag;
+            mDoesBoardWrap = is_flag && bool(value);
         } else if (name == "Grid") {
-            mGrid = ::string_to_grid(value);
+            long const grid = long(value);
+            is_good = (grid == GRID_TRIANGLE || grid == GRID_4WAY
+                    || grid == GRID_HEX || grid == GRID_8WAY);
+            if (is_good) {
+                mGrid = ::string_to_grid(value);
+            }
         } else if (name == "HandsDealt") {
             mHandsDealt = SizeType(long(value));
         } else if (name == "HandSize") {
             mHandSize = SizeType(long(value));
         } else if (name.HasPrefix("MaxAttrValue")) {
             String const suffix = name.Suffix("MaxAttrValue");
-            AttrType const index = AttrType(long(suffix));
-            mMaxAttrValues[index] = ::string_to_max_attr(value);
+            long const index = long(suffix);
+            long const max_attr = long(value);
+            is_good = (index >= 0
+                    && index < long(mMaxAttrValues.size())
+                    && max_attr + 1 >= Combo::VALUE_CNT_MIN
+                    && max_attr + 1 <= Combo::VALUE_CNT_MAX);
+            if (is_good) {
+                mMaxAttrValues[index] = ::string_to_max_attr(value);
+            }
         } else if (name == "MinutesPerHand") {
             mMinutesPerHand = MinutesType(long(value));
         } else if (name == "RandomizeFlag") {
-            mRandomizeFlag = bool(value);
+            is_good = is_flag;
+            mRandomizeFlag = is_flag && bool(value);
         } else if (name == "Seed") {
             mSeed = long(value);
         } else if (name == "Style") {
             mStyle = ::string_to_game_style(value);
         } else {
-            FAIL();  // TODO recovery
+            is_good = false;
         }
     }
+
+    if (!is_good) {
+        mStyle = GAME_STYLE_NONE;
+    }
 }
 
 // The implicitly defined copy constructor is OK.
@@ -413,13 +452,27 @@ String GameOpt::Description(void) const {
     return result;
 }
 
+// Choose the seed for the pseudo-random generator at the start of a game.
+SeedType GameOpt::GeneratorSeed(void) const {
+    SeedType result = mSeed; 
+    if (mRandomizeFlag || !IsDebug()) {
+        result = ::milliseconds();
+    }
+
+    return result;
+}
+
 // Return true if successful, false if canceled.
+// Return false if the connection fails or the options are invalid.
 bool GameOpt::GetFromClient(Socket& rClient) {
     String opt_text;
-    bool const was_successful = rClient.GetParagraph(opt_text);
+    bool was_successful = rClient.GetParagraph(opt_text);
     if (was_successful) {
-        *this = GameOpt(opt_text);
-        Validate();
+        GameOpt const opt = GameOpt(opt_text);
+        was_successful = opt.IsValid();
+        if (was_successful) {
+            *this = opt;
+        }
     }
 
     return was_successful;
@@ -480,15 +533,6 @@ MinutesType GameOpt::MinutesPerHand(void) const {
     return mMinutesPerHand;
 }
 
-void GameOpt::ReseedGenerator(void) const {
-    // Re-seed the pseudo-random generator at the start of a game.
-    SeedType seed = mSeed; 
-    if (mRandomizeFlag || !IsDebug()) {
-        seed = ::milliseconds();
-    }
-    Fraction::ReseedGenerator(seed);
-}
-
 SecondsType GameOpt::SecondsPerHand(void) const {
     SecondsType const result = MinutesPerHand() * SECONDS_PER_MINUTE;
 
@@ -675,27 +719,7 @@ ComboCntType GameOpt::TotalTileCnt(void) const {
 }
 
 void GameOpt::Validate(void) const {
-    ASSERT(mAttrCnt >= Combo::ATTR_CNT_MIN);
-    ASSERT(mAttrCnt <= Combo::ATTR_CNT_MAX);
-    ASSERT(::is_even(mBoardHeight));
-    ASSERT(mBoardHeight >= Cell::HEIGHT_MIN);
-    ASSERT(mBoardHeight <= Cell::HEIGHT_MAX);
-    ASSERT(::is_even(mBoardWidth));
-    ASSERT(mBoardWidth >= Cell::WIDTH_MIN);
-    ASSERT(mBoardWidth <= Cell::WIDTH_MAX);
-    ASSERT(mBonusPercent < 100);
-#ifdef _CONSOLE
-    ASSERT(!mDoesBoardWrap);
-    ASSERT(mGrid == GRID_4WAY);
-#endif  // defined(_CONSOLE)
-    ASSERT(mHandsDealt >= HANDS_DEALT_MIN);
-    ASSERT(mHandSize >= HAND_SIZE_MIN);
-    ASSERT(mMinutesPerHand >= MINUTES_PER_HAND_MIN);
-    ASSERT(IsDebug() || mRandomizeFlag);
-    ASSERT(mStyle != GAME_STYLE_NONE);
-#ifdef _CONSOLE
-    ASSERT(mStyle != GAME_STYLE_CHALLENGE);
-#endif  // defined(_CONSOLE)
+    ASSERT(IsValid());
 }
 
 
@@ -763,4 +787,61 @@ bool GameOpt::IsPractice(void) const {
 
 bool GameOpt::IsRandomized(void) const {
     return mRandomizeFlag;
+}
+
+// Check the options without asserting, since they may come from a file or the network.
+bool GameOpt::IsValid(void) const {
+    bool result = mAttrCnt >= Combo::ATTR_CNT_MIN
+               && mAttrCnt <= Combo::ATTR_CNT_MAX
+               && ::is_even(mBoardHeight)
+               && mBoardHeight >= Cell::HEIGHT_MIN
+               && mBoardHeight <= Cell::HEIGHT_MAX
+               && ::is_even(mBoardWidth)
+               && mBoardWidth >= Cell::WIDTH_MIN
+               && mBoardWidth <= Cell::WIDTH_MAX
+               && mBonusPercent >= 0
+               && mBonusPercent < 100
+               && (mGrid == GRID_TRIANGLE || mGrid == GRID_4WAY
+                || mGrid == GRID_HEX || mGrid == GRID_8WAY)
+               && mHandsDealt >= HANDS_DEALT_MIN
+               && mHandSize >= HAND_SIZE_MIN
+               && mMinutesPerHand >= MINUTES_PER_HAND_MIN
+               && mStyle != GAME_STYLE_NONE
+               && (IsDebug() || mRandomizeFlag);
+#ifdef _CONSOLE
+    result = result
+          && !mDoesBoardWrap
+          && mGrid == GRID_4WAY
+          && mStyle != GAME_STYLE_CHALLENGE;
+#endif  // defined(_CONSOLE)
+
+    // Count the combinations, giving up once there are more than tile IDs.
+    ComboCntType combo_cnt = 1;
+    for (AttrIndexType i_attr = 0; result && i_attr < mAttrCnt; i_attr++) {
+        AttrType value_cnt = Combo::VALUE_CNT_DEFAULT;
+        if (i_attr < mMaxAttrValues.size()) {
+            value_cnt = AttrType(mMaxAttrValues[i_attr] + 1);
+        }
+        combo_cnt *= value_cnt;
+        result = value_cnt >= Combo::VALUE_CNT_MIN
+              && value_cnt <= Combo::VALUE_CNT_MAX
+              && combo_cnt <= ComboCntType(Tile::ID_MAX);
+    }
+    result = result && combo_cnt >= Combo::COMBINATION_CNT_MIN;
+#ifdef _GUI
+    result = result && combo_cnt <= Combo::COMBINATION_CNT_MAX;
+#endif  // defined(_GUI)
+
+    // Every tile needs an ID, and there must be enough tiles to deal every hand.
+    if (result) {
+        ComboCntType const id_cnt = Tile::ID_MAX - Tile::ID_FIRST;
+        result = (mClonesPerCombo < id_cnt/combo_cnt);
+    }
+    if (result) {
+        ComboCntType const tile_cnt = combo_cnt * (1 + mClonesPerCombo);
+        result = mHandSize <= tile_cnt
+              && mHandsDealt <= tile_cnt/mHandSize;
+    }
+
+    return result;
 }
\ No newline at end of file
@@ -79,13 +79,13 @@ public:
     ComboCntType ComboCnt(void) const;
     AttrType     CountAttrValues(AttrIndexType) const;
     String       Description(void) const;
+    SeedType     GeneratorSeed(void) const;
     bool         GetFromClient(Socket&);
     void         GetUserChoice(void);
     SizeType     HandsDealt(void) const;
     SizeType     HandSize(void) const;
     AttrType     MaxAttrValue(AttrIndexType) const;
     MinutesType  MinutesPerHand(void) const;
-    void         ReseedGenerator(void) const;
     SecondsType  SecondsPerHand(void) const;
     SeedType     Seed(void) const;
     void         SetAttrCnt(AttrCntType);
@@ -124,6 +124,7 @@ public:
     bool IsFriendly(void) const;
     bool IsPractice(void) const;
     bool IsRandomized(void) const;
+    bool IsValid(void) const;
 
 private:
     // private constants
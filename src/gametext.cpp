@@ -0,0 +1,412 @@
+// File:     gametext.cpp
+// Location: src
+// Purpose:  implement GameText class
+// Author:   Stephen Gold sgold@sonic.net
+// (c) Copyright 2012 Stephen Gold
+// Distributed under the terms of the GNU General Public License
+
+/*
+This file is part of the Gold Tile Game.
+
+The Gold Tile Game is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by the 
+Free Software Foundation, either version 3 of the License, or (at your 
+option) any later version.
+
+The Gold Tile Game is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY 
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License 
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with the Gold Tile Game.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <cstring>      // memcmp
+#include "gametext.hpp"
+#include "handopts.hpp"
+#include "strings.hpp"
+
+
+// lifecycle
+
+GameText::GameText(String const& rFilespec):
+    mMap(rFilespec)
+{
+    mIsGood = mMap.IsValid();
+    mpNext = NULL;
+    mpEnd = NULL;
+    if (mIsGood) {
+        mpNext = (char const*)mMap.Bytes();
+        mpEnd = mpNext + mMap.Size();
+    }
+}
+
+// The implicitly defined destructor is fine.
+
+
+// misc methods
+
+// Read a character if it's the expected one.
+bool GameText::Accept(char ch) {
+    bool const result = (mpNext < mpEnd && *mpNext == ch);
+    if (result) {
+        mpNext++;
+    }
+
+    return result;
+}
+
+// Read a literal if it's the expected one.
+bool GameText::Accept(TextType literal) {
+    SizeType const length = SizeType(::strlen(literal));
+
+    bool const result = mIsGood
+                     && length <= SizeType(mpEnd - mpNext)
+                     && ::memcmp(mpNext, literal, length) == 0;
+    if (result) {
+        mpNext += length;
+    }
+
+    return result;
+}
+
+Tiles GameText::AllTiles(void) const {
+    return mAllTiles;
+}
+
+// Read a literal.
+void GameText::Expect(TextType literal) {
+    SizeType const length = SizeType(::strlen(literal));
+
+    if (mIsGood 
+     && length <= SizeType(mpEnd - mpNext)
+     && ::memcmp(mpNext, literal, length) == 0)
+    {
+        mpNext += length;
+    } else {
+        mIsGood = false;
+    }
+}
+
+char GameText::GetChar(void) {
+    char result = '\0';
+
+    if (mIsGood && mpNext < mpEnd) {
+        result = *mpNext;
+        mpNext++;
+    } else {
+        mIsGood = false;
+    }
+
+    return result;
+}
+
+/*
+Read the hands, as written by Hands::operator String(), and return their
+options along with their names.  The clocks and scores are skipped, since
+replaying the history recreates them.
+*/
+HandOpts GameText::GetHands(Strings& rNames) {
+    HandOpts result;
+
+    Expect("hands{");
+    do {
+        Expect("Milliseconds=");
+        GetLine();
+        Expect("Name=");
+        String const name = GetLine();
+        Expect("ResignedFlag=");
+        GetLine();
+        Expect("Score=");
+        GetLine();
+        Expect("Tiles=");
+        GetTiles();
+        Expect("\n");
+
+        String const options = GetParagraph();
+        if (mIsGood) {
+            HandOpt const hand_opt(options);
+            result.Append(hand_opt);
+            rNames.Append(name);
+        }
+    } while (mIsGood && Accept(' '));
+    Expect("}");
+
+    return result;
+}
+
+// Read the rest of a line, discarding the newline.
+String GameText::GetLine(void) {
+    String const result = GetUntil('\n');
+    Expect("\n");
+
+    return result;
+}
+
+// Read the tiles and cells of a move, as written by Move::operator String().
+Move GameText::GetMove(void) {
+    Move result;
+
+    Expect("move{");
+    bool const resign_flag = Accept('r');
+    if (resign_flag) {
+        Expect("esign ");
+    }
+
+    Tiles swap;
+    while (mIsGood && !Accept('}')) {
+        if (!swap.IsEmpty() || result.Count() > 0) {
+            Expect(" ");
+        }
+        Tile::IdType const id = GetNumber();
+        Expect("@");
+        if (!mIsGood || !Tile::IsValid(id)) {
+            mIsGood = false;
+        } else if (Accept('s')) {
+            Expect("wap");
+            if (swap.Contains(id)) {
+                mIsGood = false;
+            } else {
+                swap.Add(id);
+            }
+        } else {
+            Expect("(");
+            RowType const row = GetNumber();
+            Expect(",");
+            ColumnType const column = GetNumber();
+            Expect(")");
+            result.Add(Tile(id), Cell(row, column));
+        }
+    }
+
+    if (resign_flag) {
+        result.MakeResign(swap);
+    } else {
+        Tiles::ConstIterator i_id;
+        for (i_id = swap.begin(); i_id != swap.end(); i_id++) {
+            result.AddSwapTile(Tile(*i_id));
+        }
+    }
+
+    return result;
+}
+
+// Read a decimal integer, with an optional minus sign.
+long GameText::GetNumber(void) {
+    bool const negative = Accept('-');
+
+    long result = 0;
+    SizeType digit_cnt = 0;
+    while (mpNext < mpEnd && *mpNext >= '0' && *mpNext <= '9' && digit_cnt < 10) {
+        result = 10*result + (*mpNext - '0');
+        mpNext++;
+        digit_cnt++;
+    }
+    if (digit_cnt == 0 || (mpNext < mpEnd && *mpNext >= '0' && *mpNext <= '9')) {
+        // no digits, or too many
+        mIsGood = false;
+    }
+    if (negative) {
+        result = -result;
+    }
+
+    return result;
+}
+
+/*
+Find the game options, which follow the line of the stock bag at the end
+of the file.  This doesn't move the read position.
+*/
+String GameText::GetOptions(void) {
+    TextType const key = "\nStockBag=";
+    SizeType const length = SizeType(::strlen(key));
+
+    String result;
+    char const* p_line = NULL;
+    if (mIsGood && SizeType(mpEnd - mpNext) >= length) {
+        for (char const* p_char = mpEnd - length; p_char >= mpNext; p_char--) {
+            if (::memcmp(p_char, key, length) == 0) {
+                p_line = p_char + 1;
+                break;
+            }
+        }
+    }
+
+    if (p_line != NULL) {
+        char const* const p_newline = (char const*)::memchr(p_line, '\n', mpEnd - p_line);
+        if (p_newline != NULL) {
+            result = std::string(p_newline + 1, mpEnd - p_newline - 1);
+        } else {
+            mIsGood = false;
+        }
+    } else {
+        mIsGood = false;
+    }
+
+    return result;
+}
+
+/*
+Read a tile, as written by Tile::operator String(), and recreate it with
+its ID and options.  A tile which was already read must have the same
+options as before.  Call this only after Tile::Configure().  Return
+ID_NONE on failure.
+*/
+Tile::IdType GameText::GetTile(void) {
+    Tile::IdType const id = GetNumber();
+    Expect(":");
+
+    TileOpt opt;
+    AttrCntType const attr_cnt = Combo::AttrCnt();
+    for (AttrIndexType i_attr = 0; i_attr < attr_cnt; i_attr++) {
+        char const ch = GetChar();
+        AttrType const value = AttrType(ch - 'A');
+        if (ch >= 'A' && value < Combo::ValueCnt(i_attr)) {
+            opt.SetAttr(i_attr, value);
+        } else {
+            mIsGood = false;
+        }
+    }
+    bool const has_bonus = Accept(TileOpt::BONUS_CHARACTER);
+    opt.SetBonus(has_bonus);
+
+    Tile::IdType result = Tile::ID_NONE;
+    if (!mIsGood || id < Tile::ID_FIRST || id >= Tile::ID_MAX) {
+        mIsGood = false;
+    } else if (mAllTiles.Contains(id)) {
+        // Reject a conflicting redefinition, rather than overwrite the tile.
+        Tile const tile(id);
+        if (tile.HasOpt(opt)) {
+            result = id;
+        } else {
+            mIsGood = false;
+        }
+    } else {
+        Tile const tile(id, opt);
+        mAllTiles.Add(id);
+        result = id;
+    }
+
+    return result;
+}
+
+// Read lines up to and including a blank line, as written by GameOpt and HandOpt.
+String GameText::GetParagraph(void) {
+    char const* const p_first = mpNext;
+    while (mIsGood && !Accept('\n')) {
+        GetLine();
+    }
+
+    String result;
+    if (mIsGood) {
+        result = std::string(p_first, mpNext - p_first);
+    }
+
+    return result;
+}
+
+// Read a set of tiles, as written by Tiles::operator String().
+Tiles GameText::GetTiles(void) {
+    Tiles result;
+
+    Expect("tiles{");
+    if (!Accept('}')) {
+        do {
+            Tile::IdType const id = GetTile();
+            if (mIsGood && !result.Contains(id)) {
+                result.Add(id);
+            } else {
+                mIsGood = false;
+            }
+        } while (mIsGood && Accept(' '));
+        Expect("}");
+    }
+
+    return result;
+}
+
+// Read a turn, as written by Turn::operator String().
+Turn GameText::GetTurn(void) {
+    Expect("turn{");
+    ScoreType const points = ScoreType(GetNumber());
+    Expect(" ");
+    SizeType const must_play = SizeType(GetNumber());
+    Expect(" ");
+    Move const move = GetMove();
+    Expect(" ");
+    Tiles const draw = GetTiles();
+    Expect(" ");
+    String const hand_name = GetUntil('}');
+    Expect("}");
+
+    Turn result(move, hand_name, must_play);
+    result.SetDraw(draw);
+    result.SetPoints(points);
+
+    return result;
+}
+
+// Read a history, as written by Turns::operator String().
+Turns GameText::GetTurns(void) {
+    Turns result;
+
+    Expect("turns{");
+    if (!Accept('}')) {
+        do {
+            Turn const turn = GetTurn();
+            result.Append(turn);
+        } while (mIsGood && Accept(' '));
+        Expect("}");
+    }
+
+    return result;
+}
+
+// Read up to (but not including) a delimiter.
+String GameText::GetUntil(char delimiter) {
+    String result;
+
+    char const* p_delimiter = NULL;
+    if (mIsGood) {
+        p_delimiter = (char const*)::memchr(mpNext, delimiter, mpEnd - mpNext);
+    }
+    if (p_delimiter != NULL) {
+        result = std::string(mpNext, p_delimiter - mpNext);
+        mpNext = p_delimiter;
+    } else {
+        mIsGood = false;
+    }
+
+    return result;
+}
+
+// Skip a block of text enclosed in (possibly nested) braces.
+void GameText::SkipBlock(void) {
+    Expect("{");
+
+    SizeType depth = 1;
+    while (mIsGood && depth > 0) {
+        char const ch = GetChar();
+        if (ch == '{') {
+            depth++;
+        } else if (ch == '}') {
+            depth--;
+        }
+    }
+}
+
+
+// inquiry methods
+
+// Check whether a complete line (ending with a newline) remains to be read.
+bool GameText::HasLine(void) const {
+    bool const result = mIsGood
+        && ::memchr(mpNext, '\n', mpEnd - mpNext) != NULL;
+
+    return result;
+}
+
+bool GameText::IsGood(void) const {
+    return mIsGood;
+}
@@ -0,0 +1,90 @@
+#ifndef GAMETEXT_HPP_INCLUDED
+#define GAMETEXT_HPP_INCLUDED
+
+// File:     gametext.hpp
+// Location: src
+// Purpose:  declare GameText class
+// Author:   Stephen Gold sgold@sonic.net
+// (c) Copyright 2012 Stephen Gold
+// Distributed under the terms of the GNU General Public License
+
+/*
+This file is part of the Gold Tile Game.
+
+The Gold Tile Game is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by the 
+Free Software Foundation, either version 3 of the License, or (at your 
+option) any later version.
+
+The Gold Tile Game is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY 
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License 
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with the Gold Tile Game.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+A GameText object represents a game saved in one of the text formats:
+that of Game::operator String() or the journal written by Game::Save(),
+mapped for reading.
+
+The GameText class tokenizes the mapped file in place, in a single pass
+from beginning to end, validating the syntax as it goes.  Tiles are
+recreated (with their IDs and options) as they are read, so the game
+options, which operator String() puts last, are located first by
+scanning backward from the end of the file.  Reading past the end of
+the file, or text which doesn't match the format, makes the GameText bad.
+*/
+
+#include "filemap.hpp"  // HASA FileMap
+#include "tiles.hpp"    // HASA Tiles
+#include "turns.hpp"    // USES Turns
+
+class GameText {
+public:
+    // public lifecycle
+    explicit GameText(String const& filespec);
+    // ~GameText(void);  implicitly defined destructor
+
+    // misc public methods
+    bool     Accept(TextType);
+    Tiles    AllTiles(void) const;
+    void     Expect(TextType);
+    HandOpts GetHands(Strings& rNames);
+    String   GetLine(void);
+    long     GetNumber(void);
+    String   GetOptions(void);
+    String   GetParagraph(void);
+    Tiles    GetTiles(void);
+    Turn     GetTurn(void);
+    Turns    GetTurns(void);
+    void     SkipBlock(void);
+
+    // public inquiry methods
+    bool HasLine(void) const;
+    bool IsGood(void) const;
+
+private:
+    // private data
+    Tiles       mAllTiles;  // every tile read so far
+    bool        mIsGood;    // false after a syntax error
+    FileMap     mMap;       // the mapped file
+    char const* mpEnd;      // end of the mapped file
+    char const* mpNext;     // next character to read
+
+    // private lifecycle
+    GameText(GameText const&);  // not copyable
+
+    // private operators
+    GameText& operator=(GameText const&);  // not assignable
+
+    // misc private methods
+    bool         Accept(char);
+    char         GetChar(void);
+    Move         GetMove(void);
+    Tile::IdType GetTile(void);
+    String       GetUntil(char);
+};
+#endif  // !defined(GAMETEXT_HPP_INCLUDED)
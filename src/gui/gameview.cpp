@@ -30,6 +30,16 @@ along with the Gold Tile Game.  If not, see <http://www.gnu.org/licenses/>.
 #include "strings.hpp"
 
 
+// static callback functions
+
+// callback for changes to the partial move
+static void observe(void* pArgument, GameEvent const& rEvent) {
+    GameView* const view = (GameView*)pArgument;
+
+    view->HandleEvent(rEvent);
+}
+
+
 // lifecycle
 
 GameView::GameView(Game const* pGame)
@@ -40,6 +50,7 @@ GameView::GameView(Game const* pGame)
 {
     mpMenuBar = NULL;
     mPadPixels = PAD_PIXELS_DEFAULT;
+    mPaintedSwapFlag = false;
     mRecenterLeftX = 0;
     mRecenterRightX = 0;
     mTargetCellFlag = false;
@@ -47,6 +58,8 @@ GameView::GameView(Game const* pGame)
 
     SetBoardTileSize(TILE_SIZE_DEFAULT);
     SetHandTileSize(TILE_SIZE_DEFAULT);
+
+    AddObserver(&::observe, (void*)this);
 }
 
 // The implicitly defined destructor is OK.
@@ -70,6 +83,17 @@ Area GameView::CellArea(PlaceType place) const {
     return result;
 }
 
+// the part of the client area occupied by a board cell
+Rect GameView::CellRect(Cell const& rCell) const {
+    LogicalXType const center_x = CellX(rCell.Column());
+    LogicalYType const center_y = CellY(rCell.Row());
+    Point const center(center_x, center_y);
+    Area const cell_area = CellArea(PLACE_BOARD);
+    Rect const result(center, cell_area);
+
+    return result;
+}
+
 LogicalXType GameView::CellX(ColumnType column) const {
     PixelCntType const grid_unit = GridUnitX();
     LogicalXType const result = mStartCell.X() + grid_unit*column;
@@ -187,8 +211,11 @@ void GameView::DrawBoard(Canvas& rCanvas, unsigned showLayer) {
     if (IsLocalUsersTurn() && !mTargetCellFlag && CountHinted() == 1) {
         mTargetCell = FirstHinted();
         mTargetCellFlag = true;
+        InvalidateCells(Cells(mTargetCell));
     }
 
+    Cells hints;
+
     for (RowType row = top_see_row; row >= bottom_see_row; row--) {
         LogicalYType const center_y = CellY(row);
         for (ColumnType column = left_see_column; column <= right_see_column; column++) {
@@ -212,6 +239,9 @@ void GameView::DrawBoard(Canvas& rCanvas, unsigned showLayer) {
                     } else {
                         bool const empty = IsEmpty(wrap_cell);
                         bool const hinted = IsHinted(wrap_cell);
+                        if (hinted) {
+                            hints.Add(cell);
+                        }
                         unsigned layer = 0;
                         if (hinted || empty) {
                             layer = 1;
@@ -223,6 +253,31 @@ void GameView::DrawBoard(Canvas& rCanvas, unsigned showLayer) {
             }
         }
     }
+
+    if (showLayer == 1) {
+        /*
+        Hints follow from the whole position, so they can appear, vanish,
+        or change color in cells which no event mentioned.  Repaint any
+        such cells.
+        */
+        bool const swap_flag = (swap_cnt > 0);
+        bool const recolor_flag = (swap_flag != mPaintedSwapFlag);
+        Cells changed;
+        Cells::ConstIterator i_cell;
+        for (i_cell = hints.begin(); i_cell != hints.end(); i_cell++) {
+            if (recolor_flag || !mPaintedHints.Contains(*i_cell)) {
+                changed.Add(*i_cell);
+            }
+        }
+        for (i_cell = mPaintedHints.begin(); i_cell != mPaintedHints.end(); i_cell++) {
+            if (!hints.Contains(*i_cell)) {
+                changed.Add(*i_cell);
+            }
+        }
+        InvalidateCells(changed);
+        mPaintedHints = hints;
+        mPaintedSwapFlag = swap_flag;
+    }
 }
 
 void GameView::DrawCell(
@@ -371,6 +426,10 @@ Rect GameView::DrawHandHeader(
         rCanvas.DrawTextLine(clock_box, clock_text);
     }
 
+    // Remember where the header is, for InvalidateHeader().
+    mHeaderRects.erase(name_text);
+    mHeaderRects.insert(HeaderPair(name_text, result));
+
     return result;
 }
 
@@ -871,6 +930,101 @@ PixelCntType GameView::GridUnitY(void) const {
     return result;
 }
 
+/*
+Invalidate the parts of the window affected by a change to the game or
+to the partial move:  the cells where tiles were placed or removed, the
+area of a changed hand, and the header of a changed score or clock.
+*/
+void GameView::HandleEvent(GameEvent const& rEvent) {
+    if (mpGame == NULL || mpWindow == NULL) {
+        return;
+    }
+
+    EventType const type = rEvent;
+    String const hand_name = rEvent.HandName();
+    switch (type) {
+    case EVENT_TILES_PLACED:
+    case EVENT_TILES_REMOVED: {
+        Cells const cells = rEvent;
+        InvalidateCells(cells);
+        break;
+                              }
+    case EVENT_HAND_CHANGED:
+        InvalidateHand(hand_name);
+        break;
+    case EVENT_SCORE_CHANGED:
+        if (mpMenuBar->AreScoresVisible()) {
+            InvalidateHeader(hand_name);
+        }
+        break;
+    case EVENT_CLOCK_TICKED:
+        if (mpMenuBar->AreClocksVisible()) {
+            InvalidateHeader(hand_name);
+        }
+        break;
+    case EVENT_TURN_ADVANCED: {
+        // The hands trade places between the left and right of the window.
+        Area const client_area = mpWindow->ClientArea();
+        InvalidateColumns(0, mRecenterLeftX + mPadPixels);
+        InvalidateColumns(mRecenterRightX - mPadPixels, client_area.Width());
+        break;
+                              }
+    default:
+        FAIL();
+    }
+}
+
+void GameView::InvalidateCells(Cells const& rCells) {
+    if (mpWindow == NULL) {
+        return;
+    }
+
+    Cells::ConstIterator i_cell;
+    for (i_cell = rCells.begin(); i_cell != rCells.end(); i_cell++) {
+        Rect const rect = CellRect(*i_cell);
+        mpWindow->Invalidate(rect);
+    }
+}
+
+// Invalidate a strip of the client area, top to bottom.
+void GameView::InvalidateColumns(LogicalXType leftX, LogicalXType rightX) {
+    if (mpWindow == NULL || rightX <= leftX) {
+        return;
+    }
+
+    Area const client_area = mpWindow->ClientArea();
+    PixelCntType const width = PixelCntType(rightX - leftX);
+    Rect const strip(0, leftX, width, client_area.Height());
+    mpWindow->Invalidate(strip);
+}
+
+/*
+Invalidate the side of the window where a hand is shown:  the playable
+hand on the left, the others on the right.  A hand's height affects
+the position of whatever is drawn below it, so take the whole side.
+*/
+void GameView::InvalidateHand(String const& rHandName) {
+    ASSERT(mpGame != NULL);
+
+    Hand const playable_hand = *mpGame;
+    if (rHandName == playable_hand.Name()) {
+        InvalidateColumns(0, mRecenterLeftX + mPadPixels);
+    } else {
+        Area const client_area = mpWindow->ClientArea();
+        InvalidateColumns(mRecenterRightX - mPadPixels, client_area.Width());
+    }
+}
+
+void GameView::InvalidateHeader(String const& rHandName) {
+    HeaderMap::const_iterator const i_header = mHeaderRects.find(rHandName);
+    if (i_header == mHeaderRects.end()) {
+        InvalidateHand(rHandName);
+    } else {
+        Rect const rect = i_header->second;
+        mpWindow->Invalidate(rect);
+    }
+}
+
 void GameView::LoadUserOptions(User const& rUser) {
     mDisplayModes = DisplayModes(rUser);
     ASSERT(mDisplayModes.MarkingCnt() <= Markings::MARKING_CNT_MAX);
@@ -926,6 +1080,8 @@ void GameView::Repaint(Canvas& rCanvas) {
 
     } else {
         Area const client_area = mpWindow->ClientArea();
+        LogicalXType const old_left_x = mRecenterLeftX;
+        LogicalXType const old_right_x = mRecenterRightX;
         mRecenterLeftX = 0;
         mRecenterRightX = client_area.Width();
         mTileMap.clear();
@@ -936,12 +1092,25 @@ void GameView::Repaint(Canvas& rCanvas) {
         DrawPlayableHand(rCanvas);
         DrawPlayableTiles(rCanvas);
         DrawBoard(rCanvas, 2);
+
+        // If a side of the window changed width, repaint what it uncovered.
+        if (mRecenterLeftX != old_left_x) {
+            LogicalXType const right_x = (mRecenterLeftX > old_left_x) ? mRecenterLeftX : old_left_x;
+            InvalidateColumns(0, right_x + mPadPixels);
+        }
+        if (mRecenterRightX != old_right_x) {
+            LogicalXType const left_x = (mRecenterRightX < old_right_x) ? mRecenterRightX : old_right_x;
+            InvalidateColumns(left_x - mPadPixels, client_area.Width());
+        }
     }
 
     rCanvas.Close();
 }
 
 void GameView::ResetTargetCell(void) {
+    if (mTargetCellFlag) {
+        InvalidateCells(Cells(mTargetCell));
+    }
     mTargetCellFlag = false;
 }
 
@@ -1009,7 +1178,25 @@ void GameView::SetHandTileSize(TileSizeType size) {
     ASSERT(::is_even(mHandTileWidth));
 }
 
+// Change which tiles are highlighted, invalidating the cells of any on the board.
 void GameView::SetWarmTiles(Indices const& rIndices) {
+    Board const& r_board = BoardReference();
+    Cells cells;
+    Indices::ConstIterator i_id;
+    for (i_id = mWarmTiles.begin(); i_id != mWarmTiles.end(); i_id++) {
+        Cell cell;
+        if (r_board.LocateTile(Tile::IdType(*i_id), cell)) {
+            cells.Add(cell);
+        }
+    }
+    for (i_id = rIndices.begin(); i_id != rIndices.end(); i_id++) {
+        Cell cell;
+        if (r_board.LocateTile(Tile::IdType(*i_id), cell)) {
+            cells.Add(cell);
+        }
+    }
+    InvalidateCells(cells);
+
     mWarmTiles = rIndices;
 }
 
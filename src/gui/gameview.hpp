@@ -31,6 +31,8 @@ area of a window.
 
 The GameView class extends the Partial class with drawing methods.
 Drawing is performed on a temporary Canvas owned by the caller.
+Changes to the game and to the partial move invalidate only the parts
+of the window they affect.
 */
 
 #include "partial.hpp"           // ISA Partial
@@ -68,6 +70,7 @@ public:
     Cell       GetPointCell(Point const&) const;
     Tile::IdType 
                GetTileId(Point const&) const;
+    void       HandleEvent(GameEvent const&);
     void       LoadUserOptions(User const&);
     void       MoveTarget(int rows, int cols);
     void       Recenter(void);
@@ -103,14 +106,19 @@ private:
     typedef TileMap::const_iterator  TileConstIterator;
     typedef std::pair<TileConstIterator,TileConstIterator> 
                                      TileConstIteratorPair;
+    typedef std::map<String,Rect>    HeaderMap;
+    typedef std::pair<String,Rect>   HeaderPair;
 
     // private data
     PixelCntType mBoardTileWidth;
     DisplayModes mDisplayModes;
     Rect         mHandRect;
     PixelCntType mHandTileWidth;
+    HeaderMap    mHeaderRects;  // where each hand's header was last painted
     MenuBar*    mpMenuBar;
     PixelCntType mPadPixels;
+    Cells        mPaintedHints; // hinted cells as last painted
+    bool         mPaintedSwapFlag; // hinted cells were last painted in swap colors
     LogicalXType mRecenterLeftX;
     LogicalXType mRecenterRightX;
     Point        mStartCell;
@@ -129,6 +137,7 @@ private:
 
     // misc private methods
     Area          CellArea(PlaceType) const;
+    Rect          CellRect(Cell const&) const;
     LogicalXType  CellX(ColumnType) const;
     LogicalYType  CellY(RowType) const;
     String        ClockText(Hand&) const;
@@ -149,6 +158,10 @@ private:
     void          DrawUnplayableHands(Canvas&);
     PixelCntType  GridUnitX(void) const;
     PixelCntType  GridUnitY(void) const;
+    void          InvalidateCells(Cells const&);
+    void          InvalidateColumns(LogicalXType leftX, LogicalXType rightX);
+    void          InvalidateHand(String const& handName);
+    void          InvalidateHeader(String const& handName);
     String        ScoreText(Hand const&, bool playable) const;
     Area          TileArea(Point const&) const;
     Area          TileArea(PlaceType) const;
@@ -130,6 +130,13 @@ static void CALLBACK think(void* pArgument) {
 }
 #endif  // defined(_WINDOWS)
 
+// callback for changes to the game
+static void observe(void* pArgument, GameEvent const& rEvent) {
+    GameWindow* const window = (GameWindow*)pArgument;
+
+    window->HandleGameEvent(rEvent);
+}
+
 static void yield(void* pArgument, bool& rCancel) {
     GameWindow* const window = (GameWindow*)pArgument;
 
@@ -355,6 +362,14 @@ void GameWindow::HandleButtonUp(Point const& rMouse) {
 }
 
 // SERVER
+/*
+Respond to a change in the game.  The view invalidates just the parts of
+the window which changed, and menus aren't updated because they would flicker.
+*/
+void GameWindow::HandleGameEvent(GameEvent const& rEvent) {
+    mGameView.HandleEvent(rEvent);
+}
+
 void GameWindow::HandleInvitation(Socket& rSocket) {
     Address const address = rSocket.Peer();
     String const address_string = address;
@@ -386,9 +401,18 @@ void GameWindow::HandleInvitation(Socket& rSocket) {
             delete p_new_game;
         }
     }
+
+    // A game which failed to start may have cleared the selected context.
+    if (HasGame()) {
+        mpGame->SelectContext();
+    }
 }
 
 void GameWindow::HandleMenuCommand(IdType command) {
+    // Commands which only change the game or the partial move are
+    // reported by events, which repaint just the affected parts.
+    bool repaint_flag = true;
+
     switch (command) {
         // Arrow keys
     case IDM_UP:
@@ -440,6 +464,7 @@ void GameWindow::HandleMenuCommand(IdType command) {
         ASSERT(!IsGamePaused());
         bool pass_flag = (command == IDM_PASS);
         Play(pass_flag);
+        repaint_flag = false;
                         }
                         break;
 
@@ -448,6 +473,7 @@ void GameWindow::HandleMenuCommand(IdType command) {
         ASSERT(!IsGameOver());
         ASSERT(!IsGamePaused());
         mGameView.Reset();
+        repaint_flag = false;
         break;
 
     case IDM_SUGGEST:
@@ -457,6 +483,7 @@ void GameWindow::HandleMenuCommand(IdType command) {
         mGameView.Reset();
         ASSERT(mThinkMode == THINK_IDLE);
         mThinkMode = THINK_SUGGEST;
+        repaint_flag = false;
         break;
 
     case IDM_PAUSE:
@@ -469,6 +496,7 @@ void GameWindow::HandleMenuCommand(IdType command) {
         ASSERT(!IsGameOver());
         ASSERT(!IsGamePaused());
         mGameView.SwapAll();
+        repaint_flag = false;
         break;
 
     case IDM_RESIGN:
@@ -476,12 +504,14 @@ void GameWindow::HandleMenuCommand(IdType command) {
         ASSERT(!IsGameOver());
         ASSERT(!IsGamePaused());
         ResignHand();
+        repaint_flag = false;
         break;
 
     case IDM_RESTART:
         ASSERT(HasGame());
         ASSERT(!IsGamePaused());
         RestartGame();
+        repaint_flag = false;
         break;
 
     case IDM_UNDO:
@@ -489,6 +519,7 @@ void GameWindow::HandleMenuCommand(IdType command) {
         ASSERT(!IsGamePaused());
         ASSERT(mpGame->CanUndo());
         UndoTurn();
+        repaint_flag = false;
         break;
 
     case IDM_REDO:
@@ -496,6 +527,7 @@ void GameWindow::HandleMenuCommand(IdType command) {
         ASSERT(!IsGamePaused());
         ASSERT(mpGame->CanRedo());
         RedoTurn();
+        repaint_flag = false;
         break;
 
     case IDM_AUTOPAUSE:
@@ -617,7 +649,9 @@ void GameWindow::HandleMenuCommand(IdType command) {
 
     if (command != IDM_EXIT) {
         UpdateMenuBar();
-        ForceRepaint();
+        if (repaint_flag) {
+            ForceRepaint();
+        }
     }
 }
 
@@ -713,11 +747,10 @@ LRESULT GameWindow::HandleMessage(MessageType message, WPARAM wParam, LPARAM lPa
         int const timer_id = int(wParam);
         if (timer_id == ID_CLOCK_TIMER) {
             if (mpMenuBar->AreClocksVisible() && !IsGamePaused() && !IsGameOver()) {
-                // don't update menus because they would flicker
-                ForceRepaint();  // to update the playable hand's clock display
-            } else {
-                SetTimer(TIMEOUT_MSEC, timer_id);
+                // repaints (via HandleGameEvent) only if the display changed
+                mpGame->CheckClock();
             }
+            SetTimer(TIMEOUT_MSEC, timer_id);
         }
         break;
                    }
@@ -986,6 +1019,11 @@ STEP4:
         SetGame(p_new_game);
     } else {
         delete p_new_game;
+
+        // Deleting the new game cleared the selected context.
+        if (HasGame()) {
+            mpGame->SelectContext();
+        }
     }
 }
 #endif  // defined(_WINDOWS)
@@ -1294,10 +1332,16 @@ void GameWindow::SetGame(Game* pGame) {
     GameStyleType old_style = GAME_STYLE_NONE;
     if (HasGame()) {
         old_style = mpGame->Style();
+        mpGame->RemoveObserver(&::observe, (void*)this);
         //delete mpGame;
     }
 
     mpGame = pGame;
+    if (HasGame()) {
+        // The GUI thread operates on this game from now on.
+        mpGame->SelectContext();
+        mpGame->AddObserver(&::observe, (void*)this);
+    }
 
     DoneWaiting();
 
@@ -1430,7 +1474,7 @@ void GameWindow::Think(void) {
             mThinkMode = THINK_IDLE;
         }
 
-        ForceRepaint();
+        // The changes were reported by events, which repaint what they affect.
         UpdateMenuBar();
     }
 }
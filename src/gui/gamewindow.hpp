@@ -56,6 +56,7 @@ public:
     // misc public methods
     long         DragTileDeltaX(void) const;
     long         DragTileDeltaY(void) const;
+    void         HandleGameEvent(GameEvent const&);
 #ifdef _WINDOWS
     Win::LRESULT HandleMessage(MessageType, Win::WPARAM, Win::LPARAM);
 #endif  // defined(_WINDOWS)
@@ -260,6 +260,19 @@ void Window::InfoBox(TextType message, TextType title) {
 #endif // defined(_WINDOWS)
 }
 
+void Window::Invalidate(Rect const& rRect) {
+#ifdef _WINDOWS
+    if (!mDestroyedFlag) {
+        HWND const this_window = *this;
+        ASSERT(this_window != NULL);
+        RECT const rect = rRect;
+        BOOL const erase = TRUE;
+        BOOL const success = Win::InvalidateRect(this_window, &rect, erase);
+        ASSERT(success != 0);
+    }
+#endif // defined(_WINDOWS)
+}
+
 #ifdef _WINDOWS
 void Window::Initialize(CREATESTRUCT const& rCreateStruct) {
     BaseWindow::Initialize(rCreateStruct);
@@ -69,6 +69,7 @@ public:
     Win::LRESULT  HandleMessage(MessageType, Win::WPARAM, Win::LPARAM);
 #endif  // defined(_WINDOWS)
     void          InfoBox(TextType message, TextType title);
+    void          Invalidate(Rect const&);  // repaint part of the client area
     int           MessageDispatchLoop(void);
 #ifdef _WINDOWS
     Win::HDC      PaintDevice(void) const;
@@ -23,8 +23,10 @@ along with the Gold Tile Game.  If not, see <http://www.gnu.org/licenses/>.
 */
 
 #include <iostream>
+#include "engine.hpp"
 #include "network.hpp"
 #include "partial.hpp"
+#include "stockbag.hpp"
 
 
 // lifecycle
@@ -153,13 +155,37 @@ void Hand::DisableServer(void) {
 }
 
 Move Hand::GetAutomaticMove(Game const& rGame) const {
-    Fraction skip_probability = SkipProbability();
-    if (rGame.MustPlay() > 0) {
-        skip_probability = 0.0;
+    Move result;
+
+    if (mOptions.Strategy() == STRATEGY_EXPECTIMAX) {
+        Engine engine(rGame, mOptions.Level());
+        result = engine.BestMove();
+#ifdef _CONSOLE
+        if (engine.CountPlayouts() > 0) {
+            std::cout << ::plural(engine.CountPlayouts(), "playout")
+                << " on " << ::plural(engine.CountThreads(), "thread")
+                << " at " << unsigned(engine.PlayoutsPerSecond())
+                << " per second" << std::endl;
+        }
+#endif // defined(_CONSOLE)
+
+    } else if (mOptions.Strategy() == STRATEGY_BUDGETED) {
+        Partial partial(&rGame, HINT_NONE, 0.0);
+        if (rGame.MustPlay() == 0) {
+            partial.SetNodeBudget(mOptions.NodeBudget());
+        }
+        partial.Suggest();
+        result = partial.GetMove(false);
+
+    } else {
+        Fraction skip_probability = SkipProbability();
+        if (rGame.MustPlay() > 0) {
+            skip_probability = 0.0;
+        }
+        Partial partial(&rGame, HINT_NONE, skip_probability);
+        partial.Suggest();
+        result = partial.GetMove(false);
     }
-    Partial partial(&rGame, HINT_NONE, skip_probability);
-    partial.Suggest();
-    Move result = partial.GetMove(false);
 
     DescribeName();
     std::cout << " " << result.Description() << "." << std::endl;
@@ -167,7 +193,7 @@ Move Hand::GetAutomaticMove(Game const& rGame) const {
     return result;
 }
 
-// Return true if successful, false if canceled.
+// Return true if successful, false if canceled or garbled.
 bool Hand::GetRemoteMove(Move& rMove) {
     ASSERT(IsRemote());
 
@@ -176,7 +202,8 @@ bool Hand::GetRemoteMove(Move& rMove) {
     }
 
     String move_string;
-    bool const success = mSocket.GetLine(move_string);
+    bool const success = mSocket.GetLine(move_string)
+                      && Move::IsValid(move_string, true);
     if (success) {
         rMove = Move(move_string, true);
 #ifdef _CONSOLE
@@ -229,7 +256,7 @@ void Hand::RemoveTiles(Tiles const& rTiles) {
     mTiles.Purge(rTiles);
 }
 
-void Hand::Resign(Tiles& rBag) {
+void Hand::Resign(StockBag& rBag) {
     ASSERT(!IsClockRunning());
     ASSERT(!HasResigned());
 
@@ -302,7 +329,7 @@ void Hand::SubtractScore(ScoreType points) {
     mScore = new_score;
 }
 
-void Hand::Unresign(Tiles& rBag, Tiles const& rHand) {
+void Hand::Unresign(StockBag& rBag, Tiles const& rHand) {
     ASSERT(HasResigned());
     ASSERT(!IsClockRunning());
 
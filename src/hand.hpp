@@ -64,7 +64,7 @@ public:
     String      PlayerName(void) const;
     void        RemoveTile(Tile const&);
     void        RemoveTiles(Tiles const&);
-    void        Resign(Tiles& bag);
+    void        Resign(StockBag& bag);
     void        Restart(void);
     ScoreType   Score(void) const;
     SecondsType Seconds(void) const;
@@ -73,7 +73,7 @@ public:
     void        StartClock(void);
     SecondsType StopClock(void);
     void        SubtractScore(ScoreType);
-    void        Unresign(Tiles& bag, Tiles const& hand);
+    void        Unresign(StockBag& bag, Tiles const& hand);
 
     // public inquiry methods
     bool HasGoneOut(void) const;
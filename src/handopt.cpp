@@ -34,33 +34,60 @@ HandOpt::HandOpt(void):
 {
     mAutomaticFlag = false;
     mRemoteFlag = false;
+    mStrategy = STRATEGY_DEFAULT;
 }
 
+/*
+Parse options written by operator String().  Text which can't be parsed
+leaves the options invalid rather than failing, since it may come from
+a file or the network, so check IsValid() before using them.
+*/
 HandOpt::HandOpt(String const& rString):
     mSkipProbability(0.0)
 {
+    mAutomaticFlag = false;
+    mRemoteFlag = false;
+    mStrategy = STRATEGY_DEFAULT;
+
+    bool is_good = true;
     Strings const lines(rString, "\n");
     Strings::ConstIterator i_line;
-    for (i_line = lines.Begin(); i_line != lines.End(); i_line++) {
+    for (i_line = lines.Begin(); i_line != lines.End() && is_good; i_line++) {
         String const line = *i_line;
         Strings const fields(line, "=");
-        ASSERT(fields.Count() == 2); // TODO recovery
+        if (fields.Count() != 2) {
+            is_good = false;
+            break;
+        }
         String const name = fields.First();
         String const value = fields.Second();
+        bool const is_flag = (value == "true" || value == "false");
         if (name == "PlayerName") {
             mPlayerName = value;
         } else if (name == "AutomaticFlag") {
-            mAutomaticFlag = bool(value);
+            is_good = is_flag;
+            mAutomaticFlag = is_flag && bool(value);
         } else if (name == "RemoteFlag") {
-            mRemoteFlag = bool(value);
+            is_good = is_flag;
+            mRemoteFlag = is_flag && bool(value);
         } else if (name == "SkipProbability") {
-            mSkipProbability = value;
+            double const probability = value;
+            is_good = (probability >= 0.0 && probability <= 1.0);
+            if (is_good) {
+                mSkipProbability = Fraction(probability);
+            }
+        } else if (name == "Strategy") {
+            mStrategy = string_to_strategy(value);
         } else if (name == "Address") {
             mAddress = Address(value);
         } else {
-            FAIL(); // TODO recovery
+            is_good = false;
         }
     }
+
+    if (!is_good) {
+        mStrategy = STRATEGY_NONE;
+    }
 }
 
 HandOpt::HandOpt(GameStyleType gameStyle, Strings const& rPlayerNames):
@@ -85,6 +112,7 @@ HandOpt::HandOpt(GameStyleType gameStyle, Strings const& rPlayerNames):
 
     mAutomaticFlag = false;
     mRemoteFlag = false;
+    mStrategy = STRATEGY_DEFAULT;
 }
 
 HandOpt::HandOpt(
@@ -100,6 +128,7 @@ HandOpt::HandOpt(
     mAutomaticFlag = isAutomatic;
     SetPlayerName(rPlayerName);
     mRemoteFlag = isRemote;
+    mStrategy = STRATEGY_DEFAULT;
 }
 
 // The implicitly defined copy constructor is OK.
@@ -122,6 +151,7 @@ HandOpt::operator String(void) const {
     result += "RemoteFlag=" + String(mRemoteFlag) + "\n";
     if (IsAutomatic()) {
         result += "SkipProbability=" + String(mSkipProbability) + "\n";
+        result += "Strategy=" + strategy_to_string(mStrategy) + "\n";
     }
     if (IsRemote()) {
         String const address_string = mAddress;
@@ -142,6 +172,11 @@ String HandOpt::Description(void) const {
     if (mAutomaticFlag) {
         LevelType const level = Level();
         result += String(", a computer playing at level ") + String(level);
+        if (mStrategy == STRATEGY_EXPECTIMAX) {
+            result += " with lookahead";
+        } else if (mStrategy == STRATEGY_BUDGETED) {
+            result += " with a budget of " + ::plural(NodeBudget(), "node");
+        }
     } else {
         if (mRemoteFlag) {
             String const address_string = mAddress;
@@ -164,6 +199,14 @@ HandOpt::LevelType HandOpt::Level(void) const {
     return result;
 }
 
+// number of partial moves a budgeted search may examine
+SizeType HandOpt::NodeBudget(void) const {
+    LevelType const level = Level();
+    SizeType const result = NODES_AT_LEVEL_MIN << (level - LEVEL_MIN);
+
+    return result;
+}
+
 String HandOpt::PlayerName(void) const {
     return mPlayerName;
 }
@@ -207,6 +250,12 @@ void HandOpt::SetRemote(void) {
     ASSERT(IsRemote());
 }
 
+void HandOpt::SetStrategy(StrategyType strategy) {
+    ASSERT(strategy != STRATEGY_NONE);
+
+    mStrategy = strategy;
+}
+
 void HandOpt::SetPlayerName(String const& rPlayerName) {
     mPlayerName = rPlayerName;
     mPlayerName.Capitalize();
@@ -224,6 +273,10 @@ Fraction HandOpt::SkipProbability(void) const {
     return mSkipProbability;
 }
 
+StrategyType HandOpt::Strategy(void) const {
+    return mStrategy;
+}
+
 
 // inquiry methods
 
@@ -245,7 +298,9 @@ bool HandOpt::IsRemote(void) const {
 
 bool HandOpt::IsValid(void) const {
     bool const valid_address = !IsRemote() || mAddress.IsValid();
-    bool const result = valid_address && !mPlayerName.IsEmpty();
+    bool const result = valid_address
+                     && !mPlayerName.IsEmpty()
+                     && mStrategy != STRATEGY_NONE;
 
     return result;
 }
@@ -285,8 +340,37 @@ GameStyleType string_to_game_style(String const& rString) {
         result = GAME_STYLE_FRIENDLY;
     } else if (rString == "challenge") {
         result = GAME_STYLE_CHALLENGE;
-    } else {
+    }
+    return result;
+}
+
+StrategyType string_to_strategy(String const& rString) {
+    StrategyType result = STRATEGY_NONE;
+    if (rString == "greedy") {
+        result = STRATEGY_GREEDY;
+    } else if (rString == "expectimax") {
+        result = STRATEGY_EXPECTIMAX;
+    } else if (rString == "budgeted") {
+        result = STRATEGY_BUDGETED;
+    }
+    return result;
+}
+
+String strategy_to_string(StrategyType strategy) {
+    String result;
+    switch (strategy) {
+    case STRATEGY_GREEDY:
+        result = "greedy";
+        break;
+    case STRATEGY_EXPECTIMAX:
+        result = "expectimax";
+        break;
+    case STRATEGY_BUDGETED:
+        result = "budgeted";
+        break;
+    default:
         FAIL();
     }
+
     return result;
 }
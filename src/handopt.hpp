@@ -47,6 +47,14 @@ enum GameStyleType {
 #endif  // !defined(_DEBUG)
 };
 
+enum StrategyType {
+    STRATEGY_NONE,
+    STRATEGY_GREEDY,      // best immediate score via Partial::Suggest()
+    STRATEGY_EXPECTIMAX,  // Monte Carlo lookahead via Engine
+    STRATEGY_BUDGETED,    // best-first search with a fixed node budget
+    STRATEGY_DEFAULT = STRATEGY_GREEDY
+};
+
 typedef int32_t SecondsType;  // up to 78 years
 
 class HandOpt {
@@ -58,6 +66,7 @@ public:
     static const LevelType LEVEL_DEFAULT = 10;
     static const LevelType LEVEL_MAX = 10;
     static const LevelType LEVEL_MIN = 2;
+    static const SizeType NODES_AT_LEVEL_MIN = 16;  // doubles with each level
 
     // public lifecycle
     HandOpt(void);
@@ -76,6 +85,7 @@ public:
     // misc public methods
     String    Description(void) const;
     LevelType Level(void) const;
+    SizeType  NodeBudget(void) const;
     String    PlayerName(void) const;
     void      Serverize(Address const& client, Address const& server);
     void      SetAddress(Address const&);
@@ -84,7 +94,10 @@ public:
     void      SetLocalUser(void);
     void      SetPlayerName(String const&);
     void      SetRemote(void);
+    void      SetStrategy(StrategyType);
     Fraction  SkipProbability(void) const;
+    StrategyType
+              Strategy(void) const;
 
     // public inquiry methods
     bool IsAutomatic(void) const;
@@ -99,6 +112,8 @@ private:
     String   mPlayerName;
     bool     mRemoteFlag;
     Fraction mSkipProbability;  // for automatic hands only, else 0.0
+    StrategyType
+             mStrategy;         // for automatic hands only
 
     // private methods
     void      SetSkipProbability(Fraction const&);
@@ -107,5 +122,7 @@ private:
 // global utility functions
 String        game_style_to_string(GameStyleType);
 GameStyleType string_to_game_style(String const&);
+StrategyType  string_to_strategy(String const&);
+String        strategy_to_string(StrategyType);
 
 #endif  // !defined(HANDOPT_HPP_INCLUDED)
@@ -108,6 +108,10 @@ bool HandOpts::GetFromClient(Socket& rClient, SizeType handCnt) {
             break;
         }
         HandOpt const hand_opt = HandOpt(hand_opt_string);
+        success = hand_opt.IsValid();
+        if (!success) {
+            break;
+        }
         Append(hand_opt);
     }
 
@@ -120,7 +124,7 @@ void HandOpts::GetUserChoice(SizeType handCnt) {
         while (name.IsEmpty()) {
             std::cout << "Who will play the " 
                 << ::ordinal(i_hand + 1)
-                << " hand?\n ('computer' or 'network' or the name of a local user) ";
+                << " hand?\n ('computer' or 'expert' or 'steady' or 'network' or the name of a local user) ";
             std::getline(std::cin, name);
             name.Capitalize();
         }
@@ -132,6 +136,16 @@ void HandOpts::GetUserChoice(SizeType handCnt) {
             opt.SetPlayerName(name);
             opt.SetAutomatic();
 
+        } else if (name == "Expert") {
+            opt.SetPlayerName(name);
+            opt.SetAutomatic();
+            opt.SetStrategy(STRATEGY_EXPECTIMAX);
+
+        } else if (name == "Steady") {
+            opt.SetPlayerName(name);
+            opt.SetAutomatic();
+            opt.SetStrategy(STRATEGY_BUDGETED);
+
         } else if (name == "Network") {
             String remote_name;
             while (remote_name.IsEmpty()) {
@@ -66,6 +66,20 @@ SizeType Hands::Count(void) const {
     return result;
 }
 
+Hands::ConstIterator Hands::Find(String const& rName) const {
+    ASSERT(!rName.IsEmpty());
+
+    ConstIterator i_hand;
+    for (i_hand = begin(); i_hand != end(); i_hand++) {
+        if (i_hand->Name() == rName) {
+            return i_hand;
+        }
+    }
+
+    FAIL(); // not found
+    return i_hand;
+}
+
 Hands::Iterator Hands::Find(String const& rName) {
     ASSERT(!rName.IsEmpty());
 
@@ -0,0 +1,403 @@
+// File:     host.cpp
+// Location: src
+// Purpose:  implement Host class
+// Author:   Stephen Gold sgold@sonic.net
+// (c) Copyright 2012 Stephen Gold
+// Distributed under the terms of the GNU General Public License
+
+/*
+This file is part of the Gold Tile Game.
+
+The Gold Tile Game is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by the
+Free Software Foundation, either version 3 of the License, or (at your
+option) any later version.
+
+The Gold Tile Game is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with the Gold Tile Game.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <iostream>     // cout
+#include "game.hpp"
+#include "handopts.hpp"
+#include "host.hpp"
+#include "hostedgame.hpp"
+#include "network.hpp"
+#include "reactor.hpp"
+#include "searchpool.hpp"
+#include "strings.hpp"
+#include "workers.hpp"
+
+
+// static callback functions
+
+#ifdef _REACTOR
+// callback for a session's reactor when a client connects
+static void host_accept(Reactor& rReactor, void* pArgument, Socket& rSocket) {
+    Host* const p_host = (Host*)pArgument;
+
+    p_host->AddConnection(rReactor, rSocket);
+}
+
+// callback for a session's reactor to check for the end of the session
+static void host_check(Reactor& rReactor, void* pArgument) {
+    Host* const p_host = (Host*)pArgument;
+
+    p_host->CheckReactor(rReactor);
+}
+#endif  // defined(_REACTOR)
+
+// callback for worker threads
+static void host_session(void* pArgument, SizeType) {
+    Host* const p_host = (Host*)pArgument;
+
+    p_host->RunSession();
+}
+
+
+// lifecycle
+
+Host::Host(StrategyType strategy, HandOpt::LevelType level, SizeType gameCntMax) {
+    ASSERT(strategy != STRATEGY_NONE);
+    ASSERT(level >= HandOpt::LEVEL_MIN);
+    ASSERT(level <= HandOpt::LEVEL_MAX);
+
+    mAcceptedCnt = 0;
+    mFailedCnt = 0;
+    mGameCnt = 0;
+    mGameCntMax = gameCntMax;
+    mLastReport = 0;
+    mLevel = level;
+    mpSearches = NULL;
+    mMoveCnt = 0;
+    mMoveMsecMax = 0;
+    mMoveMsecTotal = 0;
+    mStartTime = 0;
+    mStrategy = strategy;
+    mTurnCnt = 0;
+}
+
+// The implicitly defined destructor is fine.
+
+
+// operators
+
+// The caller should hold the totals mutex (or have stopped the sessions).
+Host::operator String(void) const {
+    MsecIntervalType const elapsed = ::milliseconds() - mStartTime;
+    double const seconds = (elapsed > 0) ? elapsed/1000.0 : 1.0;
+
+    String result = ::plural(mGameCnt, "game") + " and "
+        + ::plural(mTurnCnt, "turn") + " in " + String(seconds) + " seconds ("
+        + String(mGameCnt/seconds) + " games and "
+        + String(mTurnCnt/seconds) + " turns per second)";
+    if (mFailedCnt > 0) {
+        result += ", " + String(unsigned(mFailedCnt)) + " abandoned";
+    }
+    if (mMoveCnt > 0) {
+        double const mean = double(mMoveMsecTotal)/mMoveCnt;
+        result += ", automatic move latency " + String(mean) + " msec mean, "
+            + String(unsigned(mMoveMsecMax)) + " msec max";
+    }
+
+    return result;
+}
+
+
+// misc methods
+
+#ifdef _REACTOR
+// Host a game for a new connection, unless enough have been accepted already.
+void Host::AddConnection(Reactor& rReactor, Socket& rSocket) {
+    ASSERT(rSocket.IsValid());
+
+    if (ClaimConnection()) {
+        // The hosted game deletes itself when its game ends.
+        ASSERT(mpSearches != NULL);
+        new HostedGame(*this, rReactor, *mpSearches, rSocket);
+    } else {
+        rSocket.Close();
+    }
+}
+#endif  // defined(_REACTOR)
+
+// Add the totals of a finished (or abandoned) game.
+void Host::AddGame(
+    bool wasSuccessful,
+    SizeType turnCnt,
+    SizeType moveCnt,
+    uint64_t moveMsecTotal,
+    MsecIntervalType moveMsecMax)
+{
+    mTotalsMutex.Lock();
+    if (wasSuccessful) {
+        mGameCnt++;
+    } else {
+        mFailedCnt++;
+    }
+    mMoveCnt += moveCnt;
+    mMoveMsecTotal += moveMsecTotal;
+    if (moveMsecMax > mMoveMsecMax) {
+        mMoveMsecMax = moveMsecMax;
+    }
+    mTurnCnt += turnCnt;
+
+    MsecIntervalType const now = ::milliseconds();
+    if (now - mLastReport >= REPORT_INTERVAL_MSEC) {
+        std::cerr << String(*this) << std::endl;
+        mLastReport = now;
+    }
+    mTotalsMutex.Unlock();
+}
+
+#ifdef _REACTOR
+// Stop a session's reactor once it has nothing more to do.
+void Host::CheckReactor(Reactor& rReactor) {
+    if (!IsAccepting() && rReactor.CountConnections() == 0) {
+        rReactor.Stop();
+    } else {
+        rReactor.StartTimer(CHECK_INTERVAL_MSEC, &::host_check, this);
+    }
+}
+#endif  // defined(_REACTOR)
+
+// Count a new connection.  Return false if enough have been accepted already.
+bool Host::ClaimConnection(void) {
+    bool result = false;
+
+    mTotalsMutex.Lock();
+    if (mGameCntMax == 0 || mAcceptedCnt < mGameCntMax) {
+        mAcceptedCnt++;
+        result = true;
+    }
+    mTotalsMutex.Unlock();
+
+    return result;
+}
+
+// Play one game for the client connected to a socket, then close it.
+void Host::PlayGame(Socket& rSocket) {
+    ASSERT(rSocket.IsValid());
+
+    GameOpt game_opt;
+    HandOpts hand_opts;
+    bool was_successful = game_opt.GetFromClient(rSocket);
+    if (was_successful) {
+        SizeType const hand_cnt = game_opt.HandsDealt();
+        was_successful = hand_opts.GetFromClient(rSocket, hand_cnt);
+    }
+
+    // The game selects its own context for this thread.
+    Game* p_game = NULL;
+    if (was_successful) {
+        PrepareHandOpts(rSocket, hand_opts);
+        p_game = Network::AcceptInvitation(rSocket, game_opt, hand_opts);
+        was_successful = (p_game != NULL) && p_game->Initialize();
+    }
+
+    SizeType turn_cnt = 0;
+    SizeType move_cnt = 0;
+    MsecIntervalType move_msec_max = 0;
+    uint64_t move_msec_total = 0;
+    while (was_successful && !p_game->IsOver()) {
+        if (turn_cnt > 0) {
+            p_game->ActivateNextHand();
+        }
+        p_game->StartClock();
+        Hand playable = Hand(*p_game);
+        if (playable.IsRemote()) {
+            // Don't trust the client with the server's assertions.
+            Move move;
+            was_successful = playable.GetRemoteMove(move)
+                && p_game->IsPlayableMove(move)
+                && p_game->FinishTurn(move);
+        } else {
+            MsecIntervalType const start = ::milliseconds();
+            Move const move = playable.GetAutomaticMove(*p_game);
+            was_successful = p_game->FinishTurn(move);
+            MsecIntervalType const msec = ::milliseconds() - start;
+            move_cnt++;
+            move_msec_total += msec;
+            if (msec > move_msec_max) {
+                move_msec_max = msec;
+            }
+        }
+        turn_cnt++;
+    }
+    delete p_game;
+    if (rSocket.IsValid()) {
+        rSocket.Close();
+    }
+
+    AddGame(was_successful, turn_cnt, move_cnt, move_msec_total, move_msec_max);
+}
+
+// Serverize the hand options of an invitation and automate the server's hands.
+void Host::PrepareHandOpts(Socket const& rSocket, HandOpts& rHandOpts) const {
+    Address const client_address = rSocket.Peer();
+    Address const server_address = rSocket.Local();
+    rHandOpts.Serverize(client_address, server_address);
+
+    for (SizeType i_hand = 0; i_hand < rHandOpts.Count(); i_hand++) {
+        HandOpt& r_hand_opt = rHandOpts[i_hand];
+        if (!r_hand_opt.IsRemote()) {
+            r_hand_opt.SetAutomatic();
+            r_hand_opt.SetLevel(mLevel);
+            r_hand_opt.SetStrategy(mStrategy);
+        }
+    }
+}
+
+// Host games on the given number of threads until enough have been accepted.
+void Host::Run(SizeType threadCnt) {
+    mStartTime = ::milliseconds();
+    mLastReport = mStartTime;
+
+#ifdef _REACTOR
+    // The sessions mostly wait on their reactors, so the automatic moves
+    // get as many threads again.
+    mpSearches = new SearchPool(threadCnt);
+#endif  // defined(_REACTOR)
+
+    Workers workers(threadCnt);
+    SizeType const session_cnt = workers.Count();
+    workers.Run(&::host_session, this, session_cnt);
+
+    delete mpSearches;
+    mpSearches = NULL;
+}
+
+#ifdef _REACTOR
+
+// Host many games at once, until enough have been accepted and played.
+void Host::RunSession(void) {
+    Reactor reactor;
+
+    // Every session's reactor waits on the same listen sockets.
+    Socket listen_ipv4;
+    Socket listen_ipv6;
+    Network::GetListenSockets(listen_ipv4, listen_ipv6);
+    if (listen_ipv4.IsValid()) {
+        reactor.AddListen(listen_ipv4, &::host_accept, this);
+    }
+    if (listen_ipv6.IsValid()) {
+        reactor.AddListen(listen_ipv6, &::host_accept, this);
+    }
+
+    reactor.StartTimer(CHECK_INTERVAL_MSEC, &::host_check, this);
+    reactor.Run();
+}
+
+#else  // !defined(_REACTOR)
+
+// Accept and play games one at a time.
+void Host::RunSession(void) {
+    while (IsAccepting()) {
+        Socket socket = Network::CheckForConnection();
+        if (!socket.IsValid()) {
+            ::pause_milliseconds(ACCEPT_PAUSE_MSEC);
+        } else if (ClaimConnection()) {
+            PlayGame(socket);
+        } else {
+            socket.Close();
+        }
+    }
+}
+
+#endif  // !defined(_REACTOR)
+
+
+// inquiry methods
+
+// Return false once enough connections have been accepted.
+bool Host::IsAccepting(void) const {
+    mTotalsMutex.Lock();
+    bool const result = (mGameCntMax == 0 || mAcceptedCnt < mGameCntMax);
+    mTotalsMutex.Unlock();
+
+    return result;
+}
+
+
+#ifdef _HOST
+
+// command-line utility to host many network games at once
+
+static void usage(void) {
+    std::cerr << "usage:  gold-tile-host [-j THREADS] [-h STRATEGY:LEVEL] "
+        << "[-n GAMES] [-p PORT]" << std::endl;
+}
+
+int main(int argCnt, char** argValues) {
+    String hand_spec = "greedy:10";
+    SizeType game_cnt_max = 0;
+    String port = Network::LISTEN_PORT_DEFAULT;
+#ifdef _REACTOR
+    // Each session hosts many games and each search thread chooses
+    // moves for all of them, so one of each per processor suffices.
+    SizeType thread_cnt = 0;
+#else  // !defined(_REACTOR)
+    // Most games are waiting on their clients, so use plenty of threads.
+    SizeType thread_cnt = Workers::THREAD_CNT_MAX;
+#endif  // !defined(_REACTOR)
+
+    int i_arg = 1;
+    while (i_arg + 1 < argCnt && argValues[i_arg][0] == '-') {
+        String const flag = argValues[i_arg];
+        String const value = argValues[i_arg + 1];
+        if (flag == "-h") {
+            hand_spec = value;
+        } else if (flag == "-j") {
+            thread_cnt = SizeType(long(value));
+        } else if (flag == "-n") {
+            game_cnt_max = SizeType(long(value));
+        } else if (flag == "-p") {
+            port = value;
+        } else {
+            ::usage();
+            return EXIT_FAILURE;
+        }
+        i_arg += 2;
+    }
+    if (i_arg != argCnt) {
+        ::usage();
+        return EXIT_FAILURE;
+    }
+
+    Strings const fields(hand_spec, ":");
+    if (fields.Count() != 2) {
+        ::usage();
+        return EXIT_FAILURE;
+    }
+    StrategyType const strategy = ::string_to_strategy(fields.First());
+    HandOpt::LevelType const level = HandOpt::LevelType(long(fields.Second()));
+    if (strategy == STRATEGY_NONE
+     || level < HandOpt::LEVEL_MIN
+     || level > HandOpt::LEVEL_MAX) {
+        ::usage();
+        return EXIT_FAILURE;
+    }
+
+    Network network(port);
+    std::cerr << Network::AddressReport() << std::endl
+        << "Hosting games on " << Network::DescribeListenPort() << "."
+        << std::endl;
+
+    // Discard the console output of the games themselves.
+    std::streambuf* const p_stdout = std::cout.rdbuf(NULL);
+
+    Host host(strategy, level, game_cnt_max);
+    host.Run(thread_cnt);
+
+    std::cout.rdbuf(p_stdout);
+    std::cerr << String(host) << std::endl;
+
+    return EXIT_SUCCESS;
+}
+
+#endif  // defined(_HOST)
@@ -0,0 +1,100 @@
+#ifndef HOST_HPP_INCLUDED
+#define HOST_HPP_INCLUDED
+
+// File:     host.hpp
+// Location: src
+// Purpose:  declare Host class
+// Author:   Stephen Gold sgold@sonic.net
+// (c) Copyright 2012 Stephen Gold
+// Distributed under the terms of the GNU General Public License
+
+/*
+This file is part of the Gold Tile Game.
+
+The Gold Tile Game is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by the
+Free Software Foundation, either version 3 of the License, or (at your
+option) any later version.
+
+The Gold Tile Game is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with the Gold Tile Game.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+A Host object represents a headless server which accepts every invitation
+from a client and plays many network games at once.  The hands which a
+client assigns to the server are played automatically, and no local user
+is consulted.
+
+The Host class encapsulates the strategy for the automatic hands and the
+running totals.  Each thread of a Workers object runs a session.  Where
+a Reactor is available, each session hosts many games at once as
+HostedGame objects, stepping each game whenever its client's lines
+arrive, while a SearchPool chooses the automatic moves on threads of
+its own.  Elsewhere, a session accepts a connection and plays one game
+to its end, over and over.  Each game selects its own GameContext, and
+the totals are updated under a mutex.
+*/
+
+#include "handopt.hpp"  // HASA StrategyType
+#include "mutex.hpp"    // HASA Mutex
+
+class Host {
+public:
+    // public lifecycle
+    Host(StrategyType, HandOpt::LevelType, SizeType gameCntMax);
+    // ~Host(void);  implicitly defined destructor
+
+    // public operators
+    operator String(void) const;  // one-line report of the totals
+
+    // misc public methods
+    void AddConnection(Reactor&, Socket&);
+    void AddGame(bool wasSuccessful, SizeType turnCnt, SizeType moveCnt,
+                 uint64_t moveMsecTotal, MsecIntervalType moveMsecMax);
+    void CheckReactor(Reactor&);
+    void PlayGame(Socket&);
+    void PrepareHandOpts(Socket const&, HandOpts&) const;
+    void Run(SizeType threadCnt);
+    void RunSession(void);  // invoked by worker threads
+
+private:
+    // private constants
+    static const MsecIntervalType ACCEPT_PAUSE_MSEC = 10;     // between checks for a connection
+    static const MsecIntervalType CHECK_INTERVAL_MSEC = 1000;  // between checks for the end of a session
+    static const MsecIntervalType REPORT_INTERVAL_MSEC = 10000;
+
+    // private data
+    SizeType           mAcceptedCnt;    // connections accepted
+    SizeType           mFailedCnt;      // games abandoned before the end
+    SizeType           mGameCnt;        // games played to the end
+    SizeType           mGameCntMax;     // connections to accept, or 0 for no limit
+    MsecIntervalType   mLastReport;     // time of the last periodic report
+    HandOpt::LevelType mLevel;          // for the automatic hands
+    SearchPool*        mpSearches;      // chooses moves for the reactors, or NULL
+    SizeType           mMoveCnt;        // moves chosen by the automatic hands
+    MsecIntervalType   mMoveMsecMax;    // latency of the slowest such move
+    uint64_t           mMoveMsecTotal;  // total latency of those moves
+    MsecIntervalType   mStartTime;
+    StrategyType       mStrategy;       // for the automatic hands
+    mutable Mutex      mTotalsMutex;
+    SizeType           mTurnCnt;        // turns played by all hands
+
+    // private lifecycle
+    Host(Host const&);  // not copyable
+
+    // private operators
+    Host& operator=(Host const&);  // not assignable
+
+    // misc private methods
+    bool ClaimConnection(void);
+
+    // private inquiry methods
+    bool IsAccepting(void) const;
+};
+#endif  // !defined(HOST_HPP_INCLUDED)
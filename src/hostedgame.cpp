@@ -0,0 +1,342 @@
+// File:     hostedgame.cpp
+// Location: src
+// Purpose:  implement HostedGame class
+// Author:   Stephen Gold sgold@sonic.net
+// (c) Copyright 2012 Stephen Gold
+// Distributed under the terms of the GNU General Public License
+
+/*
+This file is part of the Gold Tile Game.
+
+The Gold Tile Game is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by the
+Free Software Foundation, either version 3 of the License, or (at your
+option) any later version.
+
+The Gold Tile Game is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with the Gold Tile Game.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "hostedgame.hpp"
+
+#ifdef _REACTOR
+
+#include "game.hpp"
+#include "host.hpp"
+#include "network.hpp"
+#include "searchpool.hpp"
+
+
+// static callback functions
+
+// callback for the reactor when a line arrives or the client is lost
+static void hosted_game_ready(Reactor&, void* pArgument, bool lost) {
+    HostedGame* const p_hosted = (HostedGame*)pArgument;
+
+    if (lost) {
+        p_hosted->Finish(false);
+    } else {
+        p_hosted->Advance();
+    }
+}
+
+// callback posted by the search pool once the local move is chosen
+static void hosted_game_searched(Reactor&, void* pArgument) {
+    HostedGame* const p_hosted = (HostedGame*)pArgument;
+
+    p_hosted->FinishSearch();
+}
+
+// callback for the reactor when the client has been silent too long
+static void hosted_game_timeout(Reactor&, void* pArgument) {
+    HostedGame* const p_hosted = (HostedGame*)pArgument;
+
+    p_hosted->Finish(false);
+}
+
+
+// static functions
+
+// Count the lines the client sends after a move:  one if tiles are drawn.
+static SizeType count_draw_lines(Move const& rMove) {
+    SizeType result = 0;
+    if (!rMove.IsResign() && Tiles(rMove).Count() > 0) {
+        result = 1;
+    }
+
+    return result;
+}
+
+
+// lifecycle
+
+HostedGame::HostedGame(
+    Host& rHost,
+    Reactor& rReactor,
+    SearchPool& rSearches,
+    Socket const& rSocket)
+:
+    mSocket(rSocket)
+{
+    ASSERT(rSocket.IsValid());
+
+    mLostFlag = false;
+    mMoveCnt = 0;
+    mMoveMsecMax = 0;
+    mMoveMsecTotal = 0;
+    mMoveStart = 0;
+    mpGame = NULL;
+    mpHost = &rHost;
+    mpReactor = &rReactor;
+    mpSearches = &rSearches;
+    mParagraphCnt = 0;
+    mPhase = PHASE_INVITATION;
+    mTurnCnt = 0;
+
+    mpReactor->AddConnection(mSocket, &::hosted_game_ready, this);
+    mTimer = mpReactor->StartTimer(IDLE_MSEC_MAX, &::hosted_game_timeout, this);
+}
+
+HostedGame::~HostedGame(void) {
+    ASSERT(mPhase != PHASE_SEARCH);
+
+    mpReactor->CancelTimer(mTimer);
+    mpReactor->CloseConnection(mSocket);
+    delete mpGame;
+}
+
+
+// misc methods
+
+// Take as many steps as the lines which have arrived allow.
+void HostedGame::Advance(void) {
+    // Several games share this thread.
+    if (mpGame != NULL) {
+        mpGame->SelectContext();
+    }
+    mpReactor->CancelTimer(mTimer);
+    mTimer = 0;
+
+    while (mPhase != PHASE_OVER && mPhase != PHASE_SEARCH
+        && mSocket.CountLines() >= CountLinesNeeded())
+    {
+        bool const was_successful = Step();
+        if (!was_successful) {
+            Finish(false);
+            return;
+        }
+    }
+
+    if (mPhase == PHASE_OVER) {
+        Finish(true);
+        return;
+    }
+
+    // Send whatever the client's connection didn't take right away.
+    mpReactor->FlushConnection(mSocket);
+    if (mPhase != PHASE_SEARCH) {
+        // A search may take a while, so the client isn't timed during one.
+        mTimer = mpReactor->StartTimer(IDLE_MSEC_MAX, &::hosted_game_timeout, this);
+    }
+}
+
+// Count the complete lines which the current phase will get.
+SizeType HostedGame::CountLinesNeeded(void) const {
+    SizeType result = 0;
+
+    switch (mPhase) {
+    case PHASE_INVITATION:
+    case PHASE_REMOTE_MOVE:
+        result = 1;
+        break;
+    case PHASE_DEAL:
+        result = 1 + mGameOpt.HandsDealt();  // the stock bag, then each hand's deal
+        break;
+    case PHASE_ECHO:
+        result = 1 + ::count_draw_lines(mMove);
+        break;
+    case PHASE_REMOTE_DRAW:
+        result = ::count_draw_lines(mMove);
+        break;
+    case PHASE_LOCAL_MOVE:
+    case PHASE_SEARCH:
+    case PHASE_OVER:
+        break;
+    default:
+        FAIL();
+    }
+
+    return result;
+}
+
+// Report the totals of the game to the host, and delete this object.
+// During a search, wait for the search to finish first.
+void HostedGame::Finish(bool wasSuccessful) {
+    if (mPhase == PHASE_SEARCH) {
+        ASSERT(!wasSuccessful);
+        mLostFlag = true;
+        return;
+    }
+
+    mpHost->AddGame(wasSuccessful, mTurnCnt, mMoveCnt, mMoveMsecTotal,
+        mMoveMsecMax);
+    delete this;
+}
+
+// Send the move chosen by the search pool, then resume the exchange.
+void HostedGame::FinishSearch(void) {
+    ASSERT(mPhase == PHASE_SEARCH);
+
+    mPhase = PHASE_ECHO;
+    if (mLostFlag) {
+        Finish(false);
+        return;
+    }
+
+    mpGame->SelectContext();
+    bool const was_successful = mpGame->PutMoveToClient(mMove);
+    if (!was_successful) {
+        Finish(false);
+        return;
+    }
+
+    // Resume timing the client, and take whatever steps its lines allow.
+    Advance();
+}
+
+// Get one line of the invitation.  Accept the invitation once it's complete.
+bool HostedGame::GetInvitation(void) {
+    String line;
+    bool result = mSocket.GetLine(line);
+    if (!result) {
+        return false;
+    }
+
+    if (!line.IsEmpty()) {
+        mParagraph += line + "\n";
+        result = (mParagraph.Length() <= Socket::PARAGRAPH_LENGTH_MAX);
+        return result;
+    }
+
+    // A blank line ends the game options or the options of a hand.
+    // Options the client garbled cancel this game, not the host.
+    if (mParagraphCnt == 0) {
+        mGameOpt = GameOpt(mParagraph);
+        result = mGameOpt.IsValid();
+    } else {
+        HandOpt const hand_opt = HandOpt(mParagraph);
+        result = hand_opt.IsValid();
+        if (result) {
+            mHandOpts.Append(hand_opt);
+        }
+    }
+    if (!result) {
+        return false;
+    }
+    mParagraph.MakeEmpty();
+    mParagraphCnt++;
+
+    if (mHandOpts.Count() == mGameOpt.HandsDealt()) {
+        mpHost->PrepareHandOpts(mSocket, mHandOpts);
+        result = mSocket.PutLine(Network::ACCEPT);
+        mPhase = PHASE_DEAL;
+    }
+
+    return result;
+}
+
+// Start the next turn, or end the game.
+void HostedGame::StartTurn(void) {
+    ASSERT(mpGame != NULL);
+
+    if (mpGame->IsOver()) {
+        mpGame->EndBonus();
+        mPhase = PHASE_OVER;
+        return;
+    }
+
+    if (mTurnCnt > 0) {
+        mpGame->ActivateNextHand();
+    }
+    mTurnCnt++;
+    mpGame->StartClock();
+
+    Hand const playable = Hand(*mpGame);
+    if (playable.IsRemote()) {
+        mPhase = PHASE_REMOTE_MOVE;
+    } else {
+        mPhase = PHASE_LOCAL_MOVE;
+    }
+}
+
+// Take one step, which won't wait for the client.  Return false on failure.
+bool HostedGame::Step(void) {
+    ASSERT(mSocket.CountLines() >= CountLinesNeeded());
+
+    bool result = true;
+
+    switch (mPhase) {
+    case PHASE_INVITATION:
+        result = GetInvitation();
+        break;
+
+    case PHASE_DEAL:
+        // The game selects its own context for this thread.
+        mpGame = Game::New(mGameOpt, mHandOpts, mSocket);
+        result = (mpGame != NULL) && mpGame->Initialize();
+        if (result) {
+            StartTurn();
+        }
+        break;
+
+    case PHASE_LOCAL_MOVE:
+        // Searches run on the pool's threads, leaving this one
+        // free to serve the other games.
+        mMoveStart = ::milliseconds();
+        mPhase = PHASE_SEARCH;
+        mpSearches->Start(*mpGame, mMove, *mpReactor,
+            &::hosted_game_searched, this);
+        break;
+
+    case PHASE_ECHO: {
+        result = mpGame->FinishTurn(mMove);
+        MsecIntervalType const msec = ::milliseconds() - mMoveStart;
+        mMoveCnt++;
+        mMoveMsecTotal += msec;
+        if (msec > mMoveMsecMax) {
+            mMoveMsecMax = msec;
+        }
+        if (result) {
+            StartTurn();
+        }
+        break;
+    }
+
+    case PHASE_REMOTE_MOVE: {
+        // Don't trust the client with the server's assertions.
+        Hand playable = Hand(*mpGame);
+        result = playable.GetRemoteMove(mMove) && mpGame->IsPlayableMove(mMove);
+        mPhase = PHASE_REMOTE_DRAW;
+        break;
+    }
+
+    case PHASE_REMOTE_DRAW:
+        result = mpGame->FinishTurn(mMove);
+        if (result) {
+            StartTurn();
+        }
+        break;
+
+    default:
+        FAIL();
+    }
+
+    return result;
+}
+
+#endif  // defined(_REACTOR)
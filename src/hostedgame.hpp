@@ -0,0 +1,110 @@
+#ifndef HOSTEDGAME_HPP_INCLUDED
+#define HOSTEDGAME_HPP_INCLUDED
+
+// File:     hostedgame.hpp
+// Location: src
+// Purpose:  declare HostedGame class
+// Author:   Stephen Gold sgold@sonic.net
+// (c) Copyright 2012 Stephen Gold
+// Distributed under the terms of the GNU General Public License
+
+/*
+This file is part of the Gold Tile Game.
+
+The Gold Tile Game is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by the
+Free Software Foundation, either version 3 of the License, or (at your
+option) any later version.
+
+The Gold Tile Game is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with the Gold Tile Game.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+A HostedGame object represents a network game which a Host plays with
+one client, driven by the events of a Reactor, so that a single thread
+can host many games at once.
+
+The HostedGame class encapsulates the client's socket, the Game, and the
+phase of the exchange with the client.  Each phase waits until every
+line it will get from the client has arrived, so no read ever blocks the
+reactor's thread.  Moves for local hands are chosen by a SearchPool,
+and the game sits idle until the pool posts the move back.  A timer
+abandons the game if the client stays silent for too long.  A HostedGame
+deletes itself when its game ends, but not while a search is using it.
+*/
+
+#include "gameopt.hpp"   // HASA GameOpt
+#include "handopts.hpp"  // HASA HandOpts
+#include "move.hpp"      // HASA Move
+#include "reactor.hpp"   // HASA Reactor::TimerType
+
+#ifdef _REACTOR
+
+class HostedGame {
+public:
+    // public lifecycle
+    HostedGame(Host&, Reactor&, SearchPool&, Socket const&);
+
+    // misc public methods
+    void Advance(void);              // invoked when lines arrive
+    void Finish(bool wasSuccessful);  // invoked when the client is lost or silent
+    void FinishSearch(void);         // invoked when the local move is chosen
+
+private:
+    // private types
+    enum PhaseType {
+        PHASE_INVITATION,   // getting the game options and hand options
+        PHASE_DEAL,         // getting the stock bag and the deal
+        PHASE_LOCAL_MOVE,   // choosing a move for a local hand
+        PHASE_SEARCH,       // waiting for the search pool to choose it
+        PHASE_ECHO,         // getting the client's echo of that move
+        PHASE_REMOTE_MOVE,  // getting a move by a remote hand
+        PHASE_REMOTE_DRAW,  // getting the tiles drawn after that move
+        PHASE_OVER
+    };
+
+    // private constants
+    static const MsecIntervalType IDLE_MSEC_MAX = 600000;  // allow 10 minutes per move
+
+    // private data
+    GameOpt            mGameOpt;
+    HandOpts           mHandOpts;
+    bool               mLostFlag;       // client lost during a search
+    Move               mMove;           // the move being finished
+    SizeType           mMoveCnt;        // moves chosen by the local hands
+    MsecIntervalType   mMoveMsecMax;    // latency of the slowest such move
+    uint64_t           mMoveMsecTotal;  // total latency of those moves
+    MsecIntervalType   mMoveStart;      // when the current local move was started
+    Game*              mpGame;
+    Host*              mpHost;
+    Reactor*           mpReactor;
+    SearchPool*        mpSearches;
+    String             mParagraph;      // partial paragraph of the invitation
+    SizeType           mParagraphCnt;   // complete paragraphs of the invitation
+    PhaseType          mPhase;
+    Socket             mSocket;         // connection to the client
+    Reactor::TimerType mTimer;          // for abandoning the game, or 0
+    SizeType           mTurnCnt;        // turns started
+
+    // private lifecycle
+    ~HostedGame(void);  // deleted by Finish()
+    HostedGame(HostedGame const&);  // not copyable
+
+    // private operators
+    HostedGame& operator=(HostedGame const&);  // not assignable
+
+    // misc private methods
+    SizeType CountLinesNeeded(void) const;
+    bool     GetInvitation(void);
+    void     StartTurn(void);
+    bool     Step(void);
+};
+
+#endif  // defined(_REACTOR)
+#endif  // !defined(HOSTEDGAME_HPP_INCLUDED)
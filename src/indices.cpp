@@ -180,3 +180,12 @@ bool Indices::IsEmpty(void) const {
 
     return result;
 }
+
+// Check a save/send string before parsing it, since it may come from the network.
+/* static */ bool Indices::IsValid(String const& rString) {
+    bool const has_prefix = rString.HasPrefix(PREFIX);
+    bool const has_suffix = rString.HasSuffix(SUFFIX);
+    bool const result = (has_prefix && has_suffix);
+
+    return result;
+}
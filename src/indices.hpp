@@ -33,7 +33,7 @@ The Indices class is implemented by applying the "set" container
 template (from the Standard Template Library) to IndexType.
 */
 
-#include <climits>    // USES LONG_MAX
+#include <cstdint>    // USES INT32_MAX
 #include <set>        // ISA std::set
 #include "string.hpp" // USES String
 
@@ -47,8 +47,8 @@ public:
     typedef std::set<IndexType>::iterator               Iterator;
 
     // public constants
-    static const IndexType INDEX_MAX = LONG_MAX;
-    static const IndexType INDEX_MIN = LONG_MIN;
+    static const IndexType INDEX_MAX = INT32_MAX;
+    static const IndexType INDEX_MIN = INT32_MIN;
 
     // public lifecycle
     Indices(void);
@@ -72,8 +72,9 @@ public:
     void      Remove(IndexType);
 
     // public inquiry methods
-    bool Contains(IndexType) const;
-    bool IsEmpty(void) const;
+    bool        Contains(IndexType) const;
+    bool        IsEmpty(void) const;
+    static bool IsValid(String const&);
 
 private:
     // private constants
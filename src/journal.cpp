@@ -0,0 +1,150 @@
+// File:     journal.cpp
+// Location: src
+// Purpose:  implement Journal class
+// Author:   Stephen Gold sgold@sonic.net
+// (c) Copyright 2012 Stephen Gold
+// Distributed under the terms of the GNU General Public License
+
+/*
+This file is part of the Gold Tile Game.
+
+The Gold Tile Game is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by the 
+Free Software Foundation, either version 3 of the License, or (at your 
+option) any later version.
+
+The Gold Tile Game is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY 
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License 
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with the Gold Tile Game.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <cstdio>    // rename, remove
+#include <fstream>   // ofstream
+#include "journal.hpp"
+
+
+// static constants
+
+const String Journal::TEMP_SUFFIX(".tmp");
+
+
+// lifecycle
+
+Journal::Journal(void) {
+    mRecordCnt = 0;
+}
+
+Journal::~Journal(void) {
+    Close();
+}
+
+
+// misc methods
+
+void Journal::Append(String const& rRecord) {
+    ASSERT(IsOpen());
+
+    mPending.Append(rRecord);
+    mRecordCnt++;
+    if (mPending.Count() >= BATCH_SIZE) {
+        Flush();
+    }
+}
+
+// Write any pending records and stop journaling.
+void Journal::Close(void) {
+    if (IsOpen()) {
+        Flush();
+        mFilespec = String();
+        mRecordCnt = 0;
+    }
+
+    ASSERT(!IsOpen());
+}
+
+SizeType Journal::CountRecords(void) const {
+    return mRecordCnt;
+}
+
+String Journal::Filespec(void) const {
+    return mFilespec;
+}
+
+// Write pending records to the end of the file.  Return false on failure.
+bool Journal::Flush(void) {
+    ASSERT(IsOpen());
+
+    if (mPending.Count() == 0) {
+        return true;
+    }
+
+    std::ofstream file;
+    file.open(mFilespec, std::ios::out | std::ios::app);
+    Strings::ConstIterator i_record;
+    for (i_record = mPending.Begin(); i_record != mPending.End(); i_record++) {
+        file << *i_record << "\n";
+    }
+    file.close();
+
+    bool const result = !file.fail();
+    if (result) {
+        mPending.MakeEmpty();
+    }
+
+    return result;
+}
+
+/*
+Start (or restart) the journal with a header and zero or more records,
+replacing any existing file.  Return false on failure, in which case
+any existing file is left as it was.
+*/
+bool Journal::Open(
+    String const& rFilespec,
+    String const& rHeader,
+    Strings const& rRecords)
+{
+    ASSERT(!rFilespec.IsEmpty());
+
+    String const temp_filespec = rFilespec + TEMP_SUFFIX;
+    std::ofstream file;
+    file.open(temp_filespec, std::ios::out | std::ios::trunc);
+    file << rHeader;
+    Strings::ConstIterator i_record;
+    for (i_record = rRecords.Begin(); i_record != rRecords.End(); i_record++) {
+        file << *i_record << "\n";
+    }
+    file.close();
+
+    bool result = !file.fail();
+    if (result) {
+#ifdef WIN32
+        // rename() won't replace an existing file on Windows.
+        ::remove(rFilespec);
+#endif  // defined(WIN32)
+        result = (::rename(temp_filespec, rFilespec) == 0);
+    }
+
+    if (result) {
+        mFilespec = rFilespec;
+        mPending.MakeEmpty();
+        mRecordCnt = rRecords.Count();
+    } else {
+        ::remove(temp_filespec);
+    }
+
+    return result;
+}
+
+
+// inquiry methods
+
+bool Journal::IsOpen(void) const {
+    bool const result = !mFilespec.IsEmpty();
+
+    return result;
+}
@@ -0,0 +1,77 @@
+#ifndef JOURNAL_HPP_INCLUDED
+#define JOURNAL_HPP_INCLUDED
+
+// File:     journal.hpp
+// Location: src
+// Purpose:  declare Journal class
+// Author:   Stephen Gold sgold@sonic.net
+// (c) Copyright 2012 Stephen Gold
+// Distributed under the terms of the GNU General Public License
+
+/*
+This file is part of the Gold Tile Game.
+
+The Gold Tile Game is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by the 
+Free Software Foundation, either version 3 of the License, or (at your 
+option) any later version.
+
+The Gold Tile Game is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY 
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License 
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with the Gold Tile Game.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/*
+A Journal object represents an append-only file recording a game:
+a header written once, followed by one line per record.
+
+The Journal class buffers appended records in memory and writes them to
+the end of the file in batches of BATCH_SIZE, so that a record costs one
+line of output rather than a rewrite of the whole file.  Open() writes a
+complete file (header plus records) to a temporary file and then renames
+it over the journal, so the journal is never left half-written.  Game uses
+Open() both to start the journal and to compact it.
+*/
+
+#include "strings.hpp"  // HASA Strings
+
+
+class Journal {
+public:
+    // public lifecycle
+    Journal(void);
+    ~Journal(void);
+
+    // misc public methods
+    void     Append(String const& record);
+    void     Close(void);
+    SizeType CountRecords(void) const;
+    String   Filespec(void) const;
+    bool     Flush(void);
+    bool     Open(String const& filespec, String const& header, Strings const& records);
+
+    // public inquiry methods
+    bool IsOpen(void) const;
+
+private:
+    // private constants
+    static const SizeType BATCH_SIZE = 8;  // records buffered before a write
+    static const String   TEMP_SUFFIX;
+
+    // private data
+    String   mFilespec;   // empty if not open
+    Strings  mPending;    // records not yet written
+    SizeType mRecordCnt;  // records in the journal, including pending ones
+
+    // private lifecycle
+    Journal(Journal const&);  // not copyable
+
+    // private operators
+    Journal& operator=(Journal const&);  // not assignable
+};
+#endif  // !defined(JOURNAL_HPP_INCLUDED)
@@ -26,6 +26,7 @@ along with the Gold Tile Game.  If not, see <http://www.gnu.org/licenses/>.
 #include "cells.hpp"
 #include "move.hpp"
 #include "strings.hpp"
+#include "tileids.hpp"
 #include "tiles.hpp"
 
 
@@ -44,7 +45,7 @@ Move::Move(void) {
 
 // The implicitly defined copy constructor is fine.
 
-// Parse a save/send string.
+// Parse a save/send string; check it with IsValid() first if it's untrusted.
 Move::Move(String const& rString, bool remoteFlag) {
     bool const has_prefix = rString.HasPrefix(PREFIX);
     bool const has_suffix = rString.HasSuffix(SUFFIX);
@@ -306,6 +307,28 @@ bool Move::IsPlay(void) const {
     return result;
 }
 
+// Check a save/send string before parsing it, since it may come from the network.
+/* static */ bool Move::IsValid(String const& rString, bool remoteFlag) {
+    bool const has_prefix = rString.HasPrefix(PREFIX);
+    bool const has_suffix = rString.HasSuffix(SUFFIX);
+    bool result = (has_prefix && has_suffix);
+
+    if (result) {
+        String const body = rString.Suffix(PREFIX).Prefix(SUFFIX);
+        Strings const words(body, SEPARATOR);
+        Strings::ConstIterator i_word;
+        for (i_word = words.Begin(); i_word != words.End(); i_word++) {
+            String const word = *i_word;
+            if (word != RESIGN && !TileCell::IsValid(word, remoteFlag)) {
+                result = false;
+                break;
+            }
+        }
+    }
+
+    return result;
+}
+
 bool Move::RepeatsCell(void) const {
     bool result = false;
 
@@ -333,7 +356,7 @@ bool Move::RepeatsTile(void) const {
     bool result = false;
 
     if (Count() > 1) {
-        Indices tiles_seen;
+        TileIds tiles_seen;
         ConstIterator i_tile_cell;
 
         for (i_tile_cell = Begin(); i_tile_cell != End(); i_tile_cell++) {
@@ -71,13 +71,14 @@ public:
     void     MakeResign(Tiles const&);
 
     // public inquiry methods
-    bool InvolvesSwap(void) const;
-    bool IsPass(void) const;
-    bool IsPlay(void) const;
-    bool IsPureSwap(void) const;
-    bool IsResign(void) const;
-    bool RepeatsCell(void) const;
-    bool RepeatsTile(void) const;
+    bool        InvolvesSwap(void) const;
+    bool        IsPass(void) const;
+    bool        IsPlay(void) const;
+    bool        IsPureSwap(void) const;
+    bool        IsResign(void) const;
+    static bool IsValid(String const&, bool remote);
+    bool        RepeatsCell(void) const;
+    bool        RepeatsTile(void) const;
 
 private:
     // private types
@@ -0,0 +1,93 @@
+// File:     mutex.cpp
+// Location: src
+// Purpose:  implement Mutex class
+// Author:   Stephen Gold sgold@sonic.net
+// (c) Copyright 2012 Stephen Gold
+// Distributed under the terms of the GNU General Public License
+
+/*
+This file is part of the Gold Tile Game.
+
+The Gold Tile Game is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by the
+Free Software Foundation, either version 3 of the License, or (at your
+option) any later version.
+
+The Gold Tile Game is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with the Gold Tile Game.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "mutex.hpp"
+#ifdef _QT
+# include <QMutex>
+typedef QMutex NativeType;
+#elif defined(WIN32)
+# include "gui/win_types.hpp"
+typedef Win::CRITICAL_SECTION NativeType;
+#else  // POSIX threads
+# include <pthread.h>
+typedef pthread_mutex_t NativeType;
+#endif  // POSIX threads
+
+
+// lifecycle
+
+Mutex::Mutex(void) {
+    NativeType* const p_native = new NativeType;
+    ASSERT(p_native != NULL);
+#ifdef _QT
+    // QMutex is ready to use.
+#elif defined(WIN32)
+    Win::InitializeCriticalSection(p_native);
+#else  // POSIX threads
+    int const error = ::pthread_mutex_init(p_native, NULL);
+    ASSERT(error == 0);
+#endif  // POSIX threads
+
+    mpNative = p_native;
+}
+
+Mutex::~Mutex(void) {
+    NativeType* const p_native = (NativeType*)mpNative;
+#ifdef _QT
+    // nothing to release
+#elif defined(WIN32)
+    Win::DeleteCriticalSection(p_native);
+#else  // POSIX threads
+    ::pthread_mutex_destroy(p_native);
+#endif  // POSIX threads
+
+    delete p_native;
+}
+
+
+// misc methods
+
+void Mutex::Lock(void) {
+    NativeType* const p_native = (NativeType*)mpNative;
+#ifdef _QT
+    p_native->lock();
+#elif defined(WIN32)
+    Win::EnterCriticalSection(p_native);
+#else  // POSIX threads
+    int const error = ::pthread_mutex_lock(p_native);
+    ASSERT(error == 0);
+#endif  // POSIX threads
+}
+
+void Mutex::Unlock(void) {
+    NativeType* const p_native = (NativeType*)mpNative;
+#ifdef _QT
+    p_native->unlock();
+#elif defined(WIN32)
+    Win::LeaveCriticalSection(p_native);
+#else  // POSIX threads
+    int const error = ::pthread_mutex_unlock(p_native);
+    ASSERT(error == 0);
+#endif  // POSIX threads
+}
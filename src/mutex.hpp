@@ -0,0 +1,58 @@
+#ifndef MUTEX_HPP_INCLUDED
+#define MUTEX_HPP_INCLUDED
+
+// File:     mutex.hpp
+// Location: src
+// Purpose:  declare Mutex class
+// Author:   Stephen Gold sgold@sonic.net
+// (c) Copyright 2012 Stephen Gold
+// Distributed under the terms of the GNU General Public License
+
+/*
+This file is part of the Gold Tile Game.
+
+The Gold Tile Game is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by the
+Free Software Foundation, either version 3 of the License, or (at your
+option) any later version.
+
+The Gold Tile Game is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with the Gold Tile Game.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+A Mutex object represents a lock which at most one thread may hold
+at a time.
+
+The Mutex class encapsulates a pointer to the native lock:  a QMutex (Qt),
+a CRITICAL_SECTION (Windows), or a pthread_mutex_t (POSIX).
+*/
+
+#include "project.hpp"
+
+class Mutex {
+public:
+    // public lifecycle
+    Mutex(void);
+    ~Mutex(void);
+
+    // misc public methods
+    void Lock(void);
+    void Unlock(void);
+
+private:
+    // private data
+    void* mpNative;  // the native lock
+
+    // private lifecycle
+    Mutex(Mutex const&);  // not copyable
+
+    // private operators
+    Mutex& operator=(Mutex const&);  // not assignable
+};
+#endif  // !defined(MUTEX_HPP_INCLUDED)
@@ -28,13 +28,13 @@ along with the Gold Tile Game.  If not, see <http://www.gnu.org/licenses/>.
 #include "game.hpp"
 
 #ifdef _POSIX
+# include <cerrno>      // errno
 namespace Posix {
 # include <errno.h>     // EWOULDBLOCK
 # include <netdb.h>     // getaddrinfo()
 };
 using Posix::accept;
 using Posix::connect;
-using Posix::__errno_location;
 using Posix::freeaddrinfo;
 using Posix::getaddrinfo;
 using Posix::IPPROTO_TCP;
@@ -153,6 +153,25 @@ Network::~Network(void) {
 
 // misc methods
 
+/*
+SERVER:  Accept an invitation from a client, without asking anyone.
+The hand options must already be serverized.
+*/
+/* static */  Game* Network::AcceptInvitation(
+    Socket& rSocket,
+    GameOpt const& rGameOpt,
+    HandOpts const& rServerHandOpts)
+{
+    Game* p_result = NULL;
+    bool const was_successful = rSocket.PutLine(ACCEPT);
+    if (was_successful) {
+        p_result = Game::New(rGameOpt, rServerHandOpts, rSocket);
+    }
+
+    // The caller should check for NULL before calling p_result->Initialize().
+    return p_result;
+}
+
 /* static */  String Network::AddressReport(void) {
     // Get list of addresses.
     Strings const list = Address::ListAll();
@@ -203,7 +222,7 @@ Network::~Network(void) {
     SOCKET data_socket = INVALID_SOCKET;
 
     if (msListenIpv4.IsValid()) {
-        SOCKET const listen_socket = SOCKET(Socket::HandleType(msListenIpv4));
+        SOCKET const listen_socket = SOCKET(intptr_t(Socket::HandleType(msListenIpv4)));
         data_socket = accept(listen_socket, NULL, NULL);
         if (data_socket == INVALID_SOCKET) {
             int const error_code = ErrorCode();
@@ -212,7 +231,7 @@ Network::~Network(void) {
         }
     }
     if (data_socket == INVALID_SOCKET && msListenIpv6.IsValid()) {
-        SOCKET const listen_socket = SOCKET(Socket::HandleType(msListenIpv6));
+        SOCKET const listen_socket = SOCKET(intptr_t(Socket::HandleType(msListenIpv6)));
         data_socket = accept(listen_socket, NULL, NULL);
         if (data_socket == INVALID_SOCKET) {
             int const error_code = ErrorCode();
@@ -301,7 +320,7 @@ Network::~Network(void) {
         WaitingFor(response_event);
         Socket::HandleType const data_handle = OpenServer(address_list, rAddress);
         DoneWaiting();
-        data_socket = SOCKET(data_handle);
+        data_socket = SOCKET(intptr_t(data_handle));
         if (data_socket != INVALID_SOCKET) {
             break;
         }
@@ -391,10 +410,7 @@ Network::~Network(void) {
         rSocket.PutLine(DECLINE);
         rSocket.Close();
     } else {  // accepted
-        bool const was_successful = rSocket.PutLine(ACCEPT);
-        if (was_successful) {
-            p_result = Game::New(rGameOpt, server_hand_opts, rSocket);
-        }
+        p_result = AcceptInvitation(rSocket, rGameOpt, server_hand_opts);
     }
 
     // The caller should check for NULL before calling p_result->Initialize().
@@ -440,6 +456,14 @@ Network::~Network(void) {
 }
 #endif  // !defined(_QT)
 
+#ifndef _QT
+// SERVER:  Get copies of the listen sockets, for a Reactor to wait on.
+/* static */  void Network::GetListenSockets(Socket& rIpv4, Socket& rIpv6) {
+    rIpv4 = msListenIpv4;
+    rIpv6 = msListenIpv6;
+}
+#endif  // !defined(_QT)
+
 // CLIENT:  Invite a server to participate in the current game.
 /* static */  bool Network::InviteServer(Socket& rSocket, Game const& rGame) {
     Address const peer = rSocket.Peer();
@@ -55,6 +55,7 @@ public:
     ~Network(void);
 
     // misc public methods
+    static Game*  AcceptInvitation(Socket&, GameOpt const&, HandOpts const&);
     static String AddressReport(void);
     static Socket CheckForConnection(void);
     static bool   ConnectToServer(Address const&, Game&);
@@ -62,6 +63,9 @@ public:
     static String DescribeListenPort(void);
     static int    ErrorCode(void);
     static void   Fail(TextType operation);
+#ifndef _QT
+    static void   GetListenSockets(Socket& ipv4, Socket& ipv6);
+#endif  // !defined(_QT)
     static void   Notice(String const&);
     static bool   Question(String const&);
 #ifdef _GUI
@@ -73,7 +77,11 @@ public:
 
 private:
     // private constants
+#ifdef _HOST
+    static const int MAX_CONNECTION_CNT = 64;  // many clients may connect at once
+#else  // !defined(_HOST)
     static const int MAX_CONNECTION_CNT = 1;
+#endif  // !defined(_HOST)
     static const long PORT_MAX = 65535;
     static const long PORT_MIN = 1024;
 
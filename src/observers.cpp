@@ -0,0 +1,92 @@
+// File:     observers.cpp
+// Location: src
+// Purpose:  implement Observers class
+// Author:   Stephen Gold sgold@sonic.net
+// (c) Copyright 2012 Stephen Gold
+// Distributed under the terms of the GNU General Public License
+
+/*
+This file is part of the Gold Tile Game.
+
+The Gold Tile Game is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by the 
+Free Software Foundation, either version 3 of the License, or (at your 
+option) any later version.
+
+The Gold Tile Game is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY 
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License 
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with the Gold Tile Game.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "observers.hpp"
+
+
+// lifecycle
+
+Observers::Observers(void) {
+}
+
+Observers::Observers(Observers const&) {
+    // The copy has no observers.
+}
+
+// The implicitly defined destructor is OK.
+
+
+// operators
+
+Observers& Observers::operator=(Observers const&) {
+    // Keep this object's own observers.
+    return *this;
+}
+
+
+// misc methods
+
+void Observers::Add(FunctionType* pFunction, void* pArgument) {
+    ASSERT(pFunction != NULL);
+
+    Observer const observer(pFunction, pArgument);
+    mList.push_back(observer);
+}
+
+SizeType Observers::Count(void) const {
+    SizeType const result = SizeType(mList.size());
+
+    return result;
+}
+
+// Invoke each observer in the order added.
+void Observers::Notify(GameEvent const& rEvent) const {
+    std::vector<Observer>::const_iterator i_observer;
+    for (i_observer = mList.begin(); i_observer != mList.end(); i_observer++) {
+        FunctionType* const p_function = i_observer->first;
+        void* const p_argument = i_observer->second;
+        (*p_function)(p_argument, rEvent);
+    }
+}
+
+void Observers::Remove(FunctionType* pFunction, void* pArgument) {
+    Observer const observer(pFunction, pArgument);
+
+    std::vector<Observer>::iterator i_observer;
+    for (i_observer = mList.begin(); i_observer != mList.end(); i_observer++) {
+        if (*i_observer == observer) {
+            mList.erase(i_observer);
+            break;
+        }
+    }
+}
+
+
+// inquiry methods
+
+bool Observers::IsEmpty(void) const {
+    bool const result = mList.empty();
+
+    return result;
+}
@@ -0,0 +1,74 @@
+#ifndef OBSERVERS_HPP_INCLUDED
+#define OBSERVERS_HPP_INCLUDED
+
+// File:     observers.hpp
+// Location: src
+// Purpose:  declare Observers class
+// Author:   Stephen Gold sgold@sonic.net
+// (c) Copyright 2012 Stephen Gold
+// Distributed under the terms of the GNU General Public License
+
+/*
+This file is part of the Gold Tile Game.
+
+The Gold Tile Game is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by the 
+Free Software Foundation, either version 3 of the License, or (at your 
+option) any later version.
+
+The Gold Tile Game is distributed in the hope that it will be useful, but 
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY 
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License 
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with the Gold Tile Game.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/*
+An Observers object represents the set of callbacks to be notified of the
+changes to a Game or Partial.  Each observer is a function together with an
+argument to pass it, as for the Workers and yield callbacks.
+
+Observers are attached to an object rather than to its value, so a copy
+of an Observers object (for instance in a copy of a Partial made during
+a search) starts out empty, and assignment leaves the target's observers
+unchanged.
+*/
+
+#include <utility>        // HASA std::pair
+#include <vector>         // HASA std::vector
+#include "gameevent.hpp"  // USES GameEvent
+
+
+class Observers {
+public:
+    // public types
+    typedef void FunctionType(void*, GameEvent const&);
+
+    // public lifecycle
+    Observers(void);
+    Observers(Observers const&);
+    // ~Observers(void);  implicitly defined destructor
+
+    // public operators
+    Observers& operator=(Observers const&);
+
+    // misc public methods
+    void     Add(FunctionType*, void* arg);
+    SizeType Count(void) const;
+    void     Notify(GameEvent const&) const;
+    void     Remove(FunctionType*, void* arg);
+
+    // public inquiry methods
+    bool IsEmpty(void) const;
+
+private:
+    // private types
+    typedef std::pair<FunctionType*, void*> Observer;
+
+    // private data
+    std::vector<Observer> mList;
+};
+#endif  // !defined(OBSERVERS_HPP_INCLUDED)
@@ -24,12 +24,7 @@ along with the Gold Tile Game.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "game.hpp"
 #include "partial.hpp"
-
-
-// static data
-
-void*                       Partial::mspYieldArgument = NULL;
-Partial::YieldFunctionType* Partial::mspYieldFunction = NULL;
+#include "random.hpp"
 
 
 // lifecycle
@@ -39,6 +34,7 @@ Partial::Partial(
     HintType strength, 
     Fraction const& rSkipProbability)
 :
+    mNodeBudget(0),
     mSkipProbability(rSkipProbability)
 {
     Reset(pGame, strength, rSkipProbability);
@@ -72,6 +68,11 @@ void Partial::Activate(Tile::IdType id) {
     mHintedCellsValid = false;
 }
 
+// Register a callback to be notified of changes to the move in progress.
+void Partial::AddObserver(Observers::FunctionType* pFunction, void* pArgument) {
+    mObservers.Add(pFunction, pArgument);
+}
+
 // Add cells from rBasis to the hint-set if they are valid next
 // steps for the given Tile.
 void Partial::AddValidNextUses(
@@ -104,6 +105,13 @@ void Partial::BoardToHand(void) {
     --mPlayedTileCnt;
     mHintedCellsValid = false;
 
+    if (!mObservers.IsEmpty()) {
+        Move removed;
+        removed.Add(Tile(mActiveId), cell);
+        NotifyTiles(EVENT_TILES_REMOVED, removed);
+        NotifyHand();
+    }
+
     ASSERT(mBoard.HasEmptyCell(cell));
     ASSERT(!IsOnBoard(mActiveId));
     ASSERT(IsInHand(mActiveId));
@@ -147,6 +155,64 @@ SizeType Partial::CountTiles(void) const {
     return result; 
 }
 
+/*
+Choose which tiles to swap when no play scores.  Only the tiles of a single
+compatible run are worth keeping, so the candidates for keeping are built
+up one compatible tile at a time, and each is valued against the tiles
+which the hand can't see.  Clones of kept tiles are swapped.
+*/
+void Partial::ChooseSwap(void) {
+    ASSERT(HasGame());
+    ASSERT(CountPlayed() == 0);
+
+    if (mpGame->CountStock() == 0) {
+        return;  // pass
+    }
+
+    Tiles const unseen = mpGame->UnseenTiles();
+    Tiles const unique = mTiles.UniqueTiles();
+
+    // the odds that a random unseen tile is compatible with a single given tile
+    double single_odds = 0.0;
+    if (!unseen.IsEmpty() && !unique.IsEmpty()) {
+        SizeType compatible_cnt = 0;
+        Tiles::ConstIterator i_tile;
+        for (i_tile = unique.begin(); i_tile != unique.end(); i_tile++) {
+            Tiles const one = Tiles(Tile(*i_tile));
+            Tiles::ConstIterator i_unseen;
+            for (i_unseen = unseen.begin(); i_unseen != unseen.end(); i_unseen++) {
+                if (one.AreAllCompatibleWith(Tile(*i_unseen))) {
+                    compatible_cnt++;
+                }
+            }
+        }
+        single_odds = double(compatible_cnt)/double(unique.Count()*unseen.Count());
+    }
+
+    Tiles best_keep;
+    double best_value = -1.0;
+    Tiles const keep;
+    SizeType keeps_left = SWAP_KEEP_CNT_MAX;
+    FindBestKeep(keep, unique, unseen, single_odds, keeps_left, best_keep, best_value);
+    if (best_value < 0.0) {
+        return;  // pass
+    }
+
+    Tiles::ConstIterator i_tile;
+    for (i_tile = mTiles.begin(); i_tile != mTiles.end(); i_tile++) {
+        Tile const tile = *i_tile;
+        Tile::IdType const id = tile.Id();
+        if (!best_keep.Contains(id) && !mSwapIds.Contains(id)) {
+            mSwapIds.Add(id);
+        }
+    }
+    mHintedCellsValid = false;
+    NotifyHand();
+
+    ASSERT(CountSwap() > 0);
+    ASSERT(CountSwap() <= mpGame->CountStock());
+}
+
 void Partial::Deactivate(void) {
     if (mActiveId != Tile::ID_NONE) {
         mActiveId = Tile::ID_NONE;     
@@ -154,30 +220,89 @@ void Partial::Deactivate(void) {
     }
 }
 
-// RECURSIVE
-void Partial::FindBestMove(Partial& rBest, ScoreType& rBestPoints) const {
+/*
+RECURSIVE
+Value the swap which keeps a particular run, then try each way of extending
+the run by one more compatible tile.  Candidates are consumed in order, so
+each run is visited at most once.  The number of runs visited is bounded
+by a count rather than a clock, so the choice is reproducible.
+*/
+void Partial::FindBestKeep(
+    Tiles const& rKeep,
+    Tiles const& rCandidates,
+    Tiles const& rUnseen,
+    double singleOdds,
+    SizeType& rKeepsLeft,
+    Tiles& rBestKeep,
+    double& rBestValue) const
+{
+    ASSERT(rKeepsLeft > 0);
+    --rKeepsLeft;
+
+    SizeType const swap_cnt = CountTiles() - rKeep.Count();
+    if (swap_cnt > 0 && swap_cnt <= mpGame->CountStock()) {
+        double const value = KeepValue(rKeep, swap_cnt, rUnseen, singleOdds);
+        if (value > rBestValue) {
+            rBestKeep = rKeep;
+            rBestValue = value;
+        }
+    }
+
+    Tiles remainder(rCandidates);
+    while (!remainder.IsEmpty() && rKeepsLeft > 0) {
+        Tile const tile = remainder.PullFirstTile();
+        if (rKeep.AreAllCompatibleWith(tile)) {
+            Tiles keep(rKeep);
+            keep.Add(tile);
+            FindBestKeep(keep, remainder, rUnseen, singleOdds, rKeepsLeft, rBestKeep, rBestValue);
+        }
+    }
+}
+
+/*
+RECURSIVE
+Score every child of this partial move.  If the search might be cut short
+by the node budget or canceled, then explore the children in order of
+decreasing promise:  first by points, then bonus tiles, then by how often
+the same placement led to a new best move earlier in the search (the history
+heuristic), so that good moves are found early.  Otherwise explore each
+child as soon as it's scored, which is cheaper.
+
+Either way, a move replaces the best so far only if it scores more points,
+or the same points but comes first in the order of the tiles and cells, so
+the choice among equal moves doesn't depend on the order of exploration.
+
+Return false if the search was canceled.
+*/
+bool Partial::FindBestMove(
+    Partial& rBest,
+    ScoreType& rBestPoints,
+    Path& rBestPath,
+    Path& rPath,
+    History& rHistory,
+    Random& rRandom,
+    SizeType& rNodesLeft) const
+{
     ASSERT(HasGame());
 
     Partial temp = *this; // make a temporary copy
     temp.Deactivate();
     temp.SetHintStrength(HINT_USABLE_SELECTED);
-    ScoreType const points = temp.Points();
 
-    if (points > rBestPoints) {        
-        rBest = temp;
-        rBestPoints = points;
-    }
+    GameContext const& r_context = GameContext::Current();
+    bool const is_ordered = (mNodeBudget > 0 || r_context.mpYieldFunction != NULL);
 
+    Children children;
+    SizeType child_index = 0;
+    bool canceled = false;
     Tiles::ConstIterator i_tile;
-    for (i_tile = mTiles.begin(); i_tile != mTiles.end(); i_tile++) {
+    for (i_tile = mTiles.begin(); i_tile != mTiles.end() && rNodesLeft > 0; i_tile++) {
         Tile const tile = *i_tile;
         Tile::IdType const id = tile.Id();
-        if (temp.IsInHand(id) && !mSkipProbability.RandomBool()) {
-            bool canceled = false;
-
+        if (temp.IsInHand(id) && !mSkipProbability.RandomBool(rRandom)) {
             Yields(canceled);
             if (canceled) {
-                break;
+                return false;
             }
 
             temp.Activate(id);
@@ -185,19 +310,80 @@ void Partial::FindBestMove(Partial& rBest, ScoreType& rBestPoints) const {
             Cells const cells = temp.mHintedCells;
 
             Cells::ConstIterator i_cell;
-            for (i_cell = cells.begin(); i_cell != cells.end(); i_cell++) {
-                Yields(canceled);
-                if (canceled) {
-                    break;
+            for (i_cell = cells.begin(); i_cell != cells.end() && rNodesLeft > 0; i_cell++) {
+                TileCell const placement(tile, *i_cell);
+                temp.HandToCell(*i_cell);
+                --rNodesLeft;
+                rPath.push_back(child_index);
+                ScoreType const points = temp.Points();
+                if (points > rBestPoints
+                 || (points == rBestPoints && rPath < rBestPath))
+                {
+                    rBest = temp;
+                    rBest.Deactivate();
+                    rBestPoints = points;
+                    rBestPath = rPath;
+                    rHistory[placement]++;
                 }
 
-                temp.HandToCell(*i_cell);
-                temp.FindBestMove(rBest, rBestPoints);
+                if (is_ordered) {
+                    // Tie-breakers are fractions of a point, so they never outrank points.
+                    double rank = points;
+                    if (tile.HasBonus()) {
+                        rank += 0.5;
+                    }
+                    History::const_iterator const i_history = rHistory.find(placement);
+                    if (i_history != rHistory.end()) {
+                        double const successes = i_history->second;
+                        rank += 0.25*successes/(1.0 + successes);
+                    }
+                    // Children of equal rank keep the order of the tiles and cells.
+                    Child const child(child_index, placement);
+                    children.insert(Children::value_type(-rank, child));
+                } else {
+                    bool const completed = temp.FindBestMove(rBest,
+                        rBestPoints, rBestPath, rPath, rHistory, rRandom,
+                        rNodesLeft);
+                    if (!completed) {
+                        return false;
+                    }
+                }
+                rPath.pop_back();
                 temp.BoardToHand();
+                child_index++;
             }
             temp.Deactivate();
-        }    
+        }
+    }
+
+    Children::const_iterator i_child;
+    for (i_child = children.begin(); i_child != children.end() && rNodesLeft > 0; i_child++) {
+        Yields(canceled);
+        if (canceled) {
+            return false;
+        }
+
+        SizeType const index = i_child->second.first;
+        TileCell const placement = i_child->second.second;
+        Tile const tile = Tile(placement);
+        ScoreType const best_points = rBestPoints;
+        temp.Activate(tile.Id());
+        temp.HandToCell(Cell(placement));
+        rPath.push_back(index);
+        bool const completed = temp.FindBestMove(rBest, rBestPoints,
+            rBestPath, rPath, rHistory, rRandom, rNodesLeft);
+        if (!completed) {
+            return false;
+        }
+        rPath.pop_back();
+        temp.BoardToHand();
+        temp.Deactivate();
+        if (rBestPoints > best_points) {
+            rHistory[placement]++;
+        }
     }
+
+    return true;
 }
 
 Cell Partial::FirstHinted(void) {
@@ -257,6 +443,17 @@ Move Partial::GetMove(bool includeActiveFlag) const {
 }
 
 
+// the name of the playable hand
+String Partial::HandName(void) const {
+    String result;
+    if (HasGame()) {
+        Hand const playable_hand = *mpGame;
+        result = playable_hand.Name();
+    }
+
+    return result;
+}
+
 void Partial::HandToCell(Cell const &cell) {
     ASSERT(mActiveId != Tile::ID_NONE);
     ASSERT(IsInHand(mActiveId));
@@ -268,6 +465,13 @@ void Partial::HandToCell(Cell const &cell) {
     ++mPlayedTileCnt;
     mHintedCellsValid = false;
 
+    if (!mObservers.IsEmpty()) {
+        Move placed;
+        placed.Add(tile, cell);
+        NotifyTiles(EVENT_TILES_PLACED, placed);
+        NotifyHand();
+    }
+
     ASSERT(!IsInHand(mActiveId));
     ASSERT(mBoard.GetCell(cell) != NULL);
     ASSERT(*(mBoard.GetCell(cell)) == tile);
@@ -279,6 +483,7 @@ void Partial::HandToSwap(void) {
 
     mSwapIds.Add(mActiveId);
     mHintedCellsValid = false;
+    NotifyHand();
 
     ASSERT(mSwapIds.Contains(mActiveId));
 }
@@ -291,6 +496,101 @@ Cell Partial::LocateTile(Tile::IdType id) const {
     return result;
 }
 
+/*
+Estimate the length of the run the hand could hold after keeping a run
+and drawing replacements for the swapped tiles:  the kept tiles plus the
+expected number of draws which extend them.  With nothing kept, the first
+draw starts a new run.
+*/
+/* static */ double Partial::KeepValue(
+    Tiles const& rKeep,
+    SizeType swapCnt,
+    Tiles const& rUnseen,
+    double singleOdds)
+{
+    double result = 0.0;
+
+    if (rKeep.IsEmpty()) {
+        if (swapCnt > 0) {
+            result = 1.0 + singleOdds*(swapCnt - 1);
+        }
+    } else if (!rUnseen.IsEmpty()) {
+        SizeType compatible_cnt = 0;
+        Tiles::ConstIterator i_tile;
+        for (i_tile = rUnseen.begin(); i_tile != rUnseen.end(); i_tile++) {
+            if (rKeep.AreAllCompatibleWith(Tile(*i_tile))) {
+                compatible_cnt++;
+            }
+        }
+        double const odds = double(compatible_cnt)/double(rUnseen.Count());
+        result = rKeep.Count() + odds*swapCnt;
+    } else {
+        result = rKeep.Count();
+    }
+
+    return result;
+}
+
+// Tell observers which tiles remain in the hand.
+void Partial::NotifyHand(void) const {
+    if (mObservers.IsEmpty()) {
+        return;
+    }
+
+    Tiles hand_tiles;
+    Tiles::ConstIterator i_tile;
+    for (i_tile = mTiles.begin(); i_tile != mTiles.end(); i_tile++) {
+        Tile const tile = *i_tile;
+        if (IsInHand(tile.Id())) {
+            hand_tiles.Add(tile);
+        }
+    }
+
+    GameEvent event(EVENT_HAND_CHANGED, HandName());
+    event.SetTiles(hand_tiles);
+    mObservers.Notify(event);
+}
+
+// Tell observers about the tiles a move placed on (or removed from) the board.
+void Partial::NotifyTiles(EventType type, Move const& rMove) const {
+    ASSERT(type == EVENT_TILES_PLACED || type == EVENT_TILES_REMOVED);
+
+    Cells const cells = Cells(rMove);
+    if (!mObservers.IsEmpty() && !cells.IsEmpty()) {
+        Tiles tiles;
+        Move::ConstIterator i_tile_cell;
+        for (i_tile_cell = rMove.Begin(); i_tile_cell != rMove.End(); i_tile_cell++) {
+            if (!i_tile_cell->IsSwap()) {
+                Tile const tile = Tile(*i_tile_cell);
+                tiles.Add(tile);
+            }
+        }
+
+        GameEvent event(type, HandName());
+        event.SetCells(cells);
+        event.SetTiles(tiles);
+        mObservers.Notify(event);
+    }
+}
+
+// Move tiles from the hand to reproduce a move.
+void Partial::PlayMove(Move const& rMove) {
+    ASSERT(mActiveId == Tile::ID_NONE);
+
+    Move::ConstIterator i_tile_cell;
+    for (i_tile_cell = rMove.Begin(); i_tile_cell != rMove.End(); i_tile_cell++) {
+        TileCell const tile_cell = *i_tile_cell;
+        Tile const tile = Tile(tile_cell);
+        Activate(tile.Id());
+        if (tile_cell.IsSwap()) {
+            HandToSwap();
+        } else {
+            HandToCell(Cell(tile_cell));
+        }
+        Deactivate();
+    }
+}
+
 ScoreType Partial::Points(void) const {
     SizeType const played_tile_cnt = CountPlayed();
     SizeType const must_play = mpGame->MustPlay();
@@ -303,6 +603,11 @@ ScoreType Partial::Points(void) const {
     return result;
 }
 
+// Unregister a callback registered by AddObserver().
+void Partial::RemoveObserver(Observers::FunctionType* pFunction, void* pArgument) {
+    mObservers.Remove(pFunction, pArgument);
+}
+
 void Partial::Reset(
     Game const* pGame, 
     HintType strength, 
@@ -323,6 +628,12 @@ void Partial::Reset(Fraction const& rSkipProbability) {
 
 // method invoked by takeback
 void Partial::Reset(void) {
+    // Note which tiles are leaving the board, for the observers.
+    Move played;
+    if (!mObservers.IsEmpty()) {
+        played = GetMove(true);
+    }
+
     mActiveId = Tile::ID_NONE;
     mHintedCellsValid = false;
     mPlayedTileCnt = 0;
@@ -334,6 +645,9 @@ void Partial::Reset(void) {
         mBoard.MakeEmpty();
         mTiles.MakeEmpty();
     }
+
+    NotifyTiles(EVENT_TILES_REMOVED, played);
+    NotifyHand();
 }
 
 void Partial::SetHintedCells(void) {
@@ -428,34 +742,111 @@ void Partial::SetHintStrength(HintType strength) {
     }
 }
 
+// Limit Suggest() to a fixed number of partial moves, explored best-first.
+void Partial::SetNodeBudget(SizeType nodeCnt) {
+    mNodeBudget = nodeCnt;
+}
+
 /*
 Set up a callback to be invoked periodically during long-running operations.
-Currently used only in FindBestMove(), by way of Yields().
+Currently used only in FindBestMove(), by way of Yields().  The callback
+belongs to the current context, and contexts configured later inherit it.
 */
 /* static */ void Partial::SetYield(
     YieldFunctionType* pFunction,
     void* pArgument)
 {
-    mspYieldArgument = pArgument;
-    mspYieldFunction = pFunction;
+    GameContext& r_context = GameContext::Current();
+    r_context.mpYieldArgument = pArgument;
+    r_context.mpYieldFunction = pFunction;
 }
 
 void Partial::Suggest(void) {
     ASSERT(HasGame());
 
     Reset();
+
+    /*
+    A search with skipping is random, so only the results of
+    thorough searches are cached.
+    */
+    bool const is_cacheable = (float(mSkipProbability) == 0.0);
+    String const key = SuggestionKey();
+    Move cached;
+    if (is_cacheable && mpGame->FindSuggestion(key, cached)) {
+        PlayMove(cached);
+        return;
+    }
+
     Partial best = *this; // make a copy
     ScoreType best_score = 0;
-    FindBestMove(best, best_score);
+    Path best_path;
+    Path path;
+    History history;
+    SizeType nodes_left = mNodeBudget;
+    if (nodes_left == 0) {
+        nodes_left = SizeType(~0);  // unlimited
+    }
+    // Only a search with skipping draws from the game's generator.
+    Random random;
+    if (!is_cacheable) {
+        random = mpGame->SplitGenerator();
+    }
+    bool const completed = FindBestMove(best, best_score, best_path, path,
+        history, random, nodes_left);
     if (best_score == 0) {
-        if (CanSwapAll()) {
-            SwapAll();
-        } // TODO - partial swaps
+        // A canceled search hasn't shown that no play is possible.
+        if (completed) {
+            ChooseSwap();
+        }
     } else {
         best.SetHintStrength(mHintStrength);
-        *this = best;
+        *this = best;  // keeps this object's observers
         mHintedCellsValid = false;
+
+        if (!mObservers.IsEmpty()) {
+            Move const played = GetMove(false);
+            NotifyTiles(EVENT_TILES_PLACED, played);
+            NotifyHand();
+        }
+    }
+
+    // The result of a canceled search would mislead later suggestions.
+    if (is_cacheable && completed) {
+        Move const move = GetMove(false);
+        mpGame->AddSuggestion(key, move);
+    }
+}
+
+/*
+Identify the situation in which a suggestion is sought:  every tile on
+the board and its cell, the playable tiles, and everything else which
+influences the search.  The unseen tiles (which influence the choice of
+a swap) are whatever tiles remain.
+*/
+String Partial::SuggestionKey(void) const {
+    String result;
+
+    Cells const cells = mBoard;
+    Cells::ConstIterator i_cell;
+    for (i_cell = cells.begin(); i_cell != cells.end(); i_cell++) {
+        Cell const cell = *i_cell;
+        Tile const* const p_tile = mBoard.GetCell(cell);
+        ASSERT(p_tile != NULL);
+        result += String(cell) + String(long(p_tile->Id()));
     }
+
+    Tiles::ConstIterator i_tile;
+    for (i_tile = mTiles.begin(); i_tile != mTiles.end(); i_tile++) {
+        Tile const tile = *i_tile;
+        result += "," + String(long(tile.Id()));
+    }
+
+    result += ":" + String(unsigned(mpGame->MustPlay()))
+        + ":" + String(unsigned(mpGame->CountStock()))
+        + ":" + String(unsigned(mNodeBudget));
+
+    return result;
 }
 
 void Partial::SwapAll(void) {
@@ -472,6 +863,7 @@ void Partial::SwapAll(void) {
     }
 
     mHintedCellsValid = false;
+    NotifyHand();
 }
 
 void Partial::SwapToHand(void) {
@@ -480,13 +872,15 @@ void Partial::SwapToHand(void) {
 
     mSwapIds.Remove(mActiveId);
     mHintedCellsValid = false;
+    NotifyHand();
 
     ASSERT(!mSwapIds.Contains(mActiveId));
 }
 
 /* static */ void Partial::Yields(bool& rCanceled) {
-    if (mspYieldFunction != NULL) {
-        (*mspYieldFunction)(mspYieldArgument, rCanceled);
+    GameContext const& r_context = GameContext::Current();
+    if (r_context.mpYieldFunction != NULL) {
+        (*r_context.mpYieldFunction)(r_context.mpYieldArgument, rCanceled);
     }
 }
 
@@ -34,13 +34,20 @@ implements a Suggest() method for user assistance and automatic play.
 The tiles may be located in the playable hand, in the swap area, or on the board.
 At any instant, only one tile may be active (in motion).
 
+Observers are told whenever tiles move between the hand, the swap area,
+and the board.  The copies made during a search have no observers, so the
+search itself is silent.
+
 The Partial class is ...
 */
 
+#include <map>          // USES std::map, std::multimap
+#include <vector>       // USES std::vector
 #include "board.hpp"    // HASA Board
 #include "cells.hpp"    // HASA Cells
-#include "game.hpp"
-#include "indices.hpp"  // HASA Indices
+#include "game.hpp"     // USES GameEvent, Observers
+#include "tilecell.hpp" // USES TileCell
+#include "tileids.hpp"  // HASA TileIds
 #include "tiles.hpp"    // HASA Tiles
 
 enum HintType {
@@ -56,7 +63,7 @@ enum HintType {
 class Partial {
 public:
     // public types
-    typedef void YieldFunctionType(void*, bool& cancel);
+    typedef GameContext::YieldFunctionType YieldFunctionType;
 
     // public lifecycle
     // no default constructor
@@ -71,6 +78,7 @@ public:
 
     // misc public methods
     void          Activate(Tile::IdType);
+    void          AddObserver(Observers::FunctionType*, void* arg);
     void          BoardToHand(void);             // move the active tile
     SizeType      CountHand(void) const;
     SizeType      CountHinted(void);
@@ -88,10 +96,12 @@ public:
     Cell          LocateTile(void) const;
     Cell          LocateTile(Tile::IdType) const;
     ScoreType     Points(void) const;             // points scored so far this turn
+    void          RemoveObserver(Observers::FunctionType*, void* arg);
     void          Reset(void);
     void          Reset(Fraction const& skipProb);
     void          Reset(Game const*, HintType, Fraction const& skipProb);
     void          SetHintStrength(HintType);
+    void          SetNodeBudget(SizeType);
     static void   SetYield(YieldFunctionType*, void* arg);
     void          Suggest(void);
     void          SwapAll(void);
@@ -126,23 +136,44 @@ protected:
     bool MightUse(Cell const&);
 
 private:
+    // private constants
+    static const SizeType SWAP_KEEP_CNT_MAX = 4096;  // runs valued by ChooseSwap()
+
+    // private types
+    typedef std::pair<SizeType,TileCell>   Child;     // enumeration index and placement
+    typedef std::multimap<double,Child>    Children;  // ordered by decreasing rank
+    typedef std::map<TileCell,SizeType>    History;   // placements which led to a new best move
+    typedef std::vector<SizeType>          Path;      // enumeration index at each depth
+
     // private data
     Tile::IdType   mActiveId;         // tile actively being dragged (or else Tile::ID_NONE)
     Board          mBoard;
     Cells          mHintedCells;      // cached choice of cells
     bool           mHintedCellsValid;
     HintType       mHintStrength;
+    SizeType       mNodeBudget;       // limits thoroughness of Suggest() method (0 means unlimited)
+    Observers      mObservers;        // callbacks notified of changes, not copied
     SizeType       mPlayedTileCnt;    // number of tiles played to the board
     Fraction       mSkipProbability;  // reduces thoroughness of Suggest() method
-    Indices        mSwapIds;          // indices of all tiles in the swap area
-    static void* mspYieldArgument;
-    static YieldFunctionType*
-                 mspYieldFunction;
+    TileIds        mSwapIds;          // indices of all tiles in the swap area
 
     // misc private methods
     void        AddValidNextUses(Move const&, Tile const&, Cells const&);
-    void        FindBestMove(Partial&, ScoreType&) const;
+    void        ChooseSwap(void);
+    void        FindBestKeep(Tiles const& keep, Tiles const& candidates,
+                    Tiles const& unseen, double singleOdds, SizeType& keepsLeft,
+                    Tiles& bestKeep, double& bestValue) const;
+    bool        FindBestMove(Partial&, ScoreType&, Path& bestPath, Path&, History&,
+                    Random&, SizeType& nodesLeft) const;
+    String      HandName(void) const;
+    void        NotifyHand(void) const;
+    void        NotifyTiles(EventType, Move const&) const;
+    void        PlayMove(Move const&);
     void        SetHintedCells(void);
+    String      SuggestionKey(void) const;
+    static double
+                KeepValue(Tiles const& keep, SizeType swapCnt, Tiles const& unseen,
+                    double singleOdds);
     static void Yields(bool& cancel);
 
     // private inquiry methods
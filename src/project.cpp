@@ -28,7 +28,8 @@ along with the Gold Tile Game.  If not, see <http://www.gnu.org/licenses/>.
 #else  // !defined(WIN32)
 # include <cstdlib>
 # include <cstring>
-# include <time.h>
+# include <sys/time.h>  // gettimeofday
+# include <unistd.h>    // usleep
 #endif  // !defined(WIN32)
 #include "string.hpp"
 
@@ -48,6 +49,19 @@ void assertion_failed(TextType file, uint32_t line) {
     ::exit(EXIT_FAILURE);
 }
 
+unsigned count_bits(uint64_t word) {
+#ifdef __GNUC__
+    unsigned const result = __builtin_popcountll(word);
+#else  // !defined(__GNUC__)
+    word = word - ((word >> 1) & 0x5555555555555555ULL);
+    word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+    word = (word + (word >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+    unsigned const result = unsigned((word*0x0101010101010101ULL) >> 56);
+#endif  // !defined(__GNUC__)
+
+    return result;
+}
+
 bool is_even(intmax_t number) {
     bool const result = ((number & 0x1) == 0);
 
@@ -66,8 +80,10 @@ MsecIntervalType milliseconds(void) {
     Win::DWORD const ticks = Win::GetTickCount();
     result = MsecIntervalType(ticks);
 #else  // !defined(WIN32)
-    time_t const seconds = ::time(NULL);
-    result = MSECS_PER_SECOND*MsecIntervalType(seconds);
+    struct timeval now;
+    ::gettimeofday(&now, NULL);
+    result = MSECS_PER_SECOND*MsecIntervalType(now.tv_sec)
+           + MsecIntervalType(now.tv_usec/1000);
 #endif  // !defined(WIN32)
 
     return result;
@@ -117,6 +133,14 @@ String ordinal(uintmax_t n) {
     return result;
 }
 
+void pause_milliseconds(MsecIntervalType msec) {
+#ifdef WIN32
+    Win::Sleep(Win::DWORD(msec));
+#else  // !defined(WIN32)
+    ::usleep(useconds_t(1000*msec));
+#endif  // !defined(WIN32)
+}
+
 TextType plural(intmax_t n) {
     ASSERT(n >= 0);
 
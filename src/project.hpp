@@ -33,6 +33,11 @@
 # define _WINSOCK2
 #endif
 
+// event-driven networking with epoll
+#if defined(_POSIX) && defined(__linux__)
+# define _REACTOR
+#endif  // defined(_POSIX) && defined(__linux__)
+
 #ifdef _CONSOLE
 # if defined(_CLIENT) && defined(_SERVER)
 #  error _CONSOLE build cannot act as both a client and a server
@@ -60,34 +65,64 @@
 # define MAX(a,b) (((a) > (b)) ? (a) : (b))
 #endif  // !defined(MAX)
 
+// storage class for data with a separate instance in each thread
+#if __cplusplus >= 201103L
+# define THREAD_LOCAL thread_local
+#elif defined(_MSC_VER)
+# define THREAD_LOCAL __declspec(thread)
+#else  // !defined(_MSC_VER)
+# define THREAD_LOCAL __thread
+#endif  // !defined(_MSC_VER)
+
 // forward declarations of project classes
 class Address;
+class Analyzer;
 class BaseBoard;
 class Board;
 class Cell;
 class Cells;
+class Checkpoint;
 class Combo;
 class Direction;
+class Engine;
 class Fifo;
+class FileMap;
 class Fraction;
 class Game;
+class GameContext;
+class GameEvent;
+class GameFile;
+class GameText;
 class GameOpt;
 class Hand;
 class HandOpt;
 class HandOpts;
 class Hands;
+class Host;
+class HostedGame;
 class Indices;
+class Journal;
 class Move;
+class Mutex;
 class Network;
+class Observers;
 class Partial;
+class Random;
+class Reactor;
+class SearchPool;
+class SelfPlay;
 class Socket;
+class StockBag;
 class String;
 class Strings;
+class SuggestionCache;
 class Tile;
 class TileCell;
+class TileIds;
 class Tiles;
 class Turn;
 class Turns;
+class Workers;
 
 #ifdef _GUI
 // forward declarations of GUI classes
@@ -130,7 +165,7 @@ class QFont;
 class QPainter;
 #endif  // defined(_QT)
 
-#include <cstdint>  // uint32_t
+#include <cstdint>  // uint32_t, uint64_t
 
 // project-wide typedefs
 typedef uint32_t    MsecIntervalType;  // up to 49 days
@@ -151,11 +186,13 @@ const double   SQRT_3 = 1.732050807568877;
 
 // project-wide utility functions
 void     assertion_failed(TextType, uint32_t);
+unsigned count_bits(uint64_t);  // population count
 bool     is_even(intmax_t);
 bool     is_odd(intmax_t);
 MsecIntervalType
          milliseconds(void);  // read real-time clock
 String   ordinal(uintmax_t);
+void     pause_milliseconds(MsecIntervalType);  // suspend the calling thread
 TextType plural(intmax_t);
 String   plural(intmax_t, TextType);
 bool     str_eq(TextType, TextType);  // compare text strings
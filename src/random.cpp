@@ -0,0 +1,94 @@
+// File:     random.cpp
+// Location: src
+// Purpose:  implement Random class
+// Author:   Stephen Gold sgold@sonic.net
+// (c) Copyright 2012 Stephen Gold
+// Distributed under the terms of the GNU General Public License
+
+/*
+This file is part of the Gold Tile Game.
+
+The Gold Tile Game is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by the
+Free Software Foundation, either version 3 of the License, or (at your
+option) any later version.
+
+The Gold Tile Game is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with the Gold Tile Game.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "random.hpp"
+
+
+// lifecycle
+
+Random::Random(void) {
+    Seed(0, 0);
+}
+
+Random::Random(SeedType seed, uint64_t stream) {
+    Seed(seed, stream);
+}
+
+// The implicitly defined copy constructor is fine.
+// The implicitly defined destructor is fine.
+
+
+// operators
+
+// The implicitly defined assignment method is fine.
+
+
+// misc methods
+
+// Generate an unbiased integer in [0, n) by multiplying and rejecting
+// the few products which would favor small results (Lemire, 2019).
+SizeType Random::Below(SizeType n) {
+    ASSERT(n > 0);
+
+    uint64_t product = uint64_t(Next())*n;
+    uint32_t low = uint32_t(product);
+    if (low < n) {
+        uint32_t const threshold = uint32_t(-n) % n;
+        while (low < threshold) {
+            product = uint64_t(Next())*n;
+            low = uint32_t(product);
+        }
+    }
+    SizeType const result = SizeType(product >> 32);
+
+    ASSERT(result < n);
+    return result;
+}
+
+Random::ValueType Random::Next(void) {
+    uint64_t const old_state = mState;
+    mState = old_state*MULTIPLIER + mIncrement;
+
+    uint32_t const xorshifted = uint32_t(((old_state >> 18) ^ old_state) >> 27);
+    unsigned const rotation = unsigned(old_state >> 59);
+    ValueType const result = (xorshifted >> rotation) | (xorshifted << ((32 - rotation) & 31));
+
+    return result;
+}
+
+void Random::Seed(uint64_t seed, uint64_t stream) {
+    mState = 0;
+    mIncrement = (stream << 1) | 1;
+    Next();
+    mState += seed;
+    Next();
+}
+
+double Random::Unit(void) {
+    double const result = Next()/4294967296.0;
+
+    ASSERT(result >= 0.0);
+    ASSERT(result < 1.0);
+    return result;
+}
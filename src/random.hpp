@@ -0,0 +1,72 @@
+#ifndef RANDOM_HPP_INCLUDED
+#define RANDOM_HPP_INCLUDED
+
+// File:     random.hpp
+// Location: src
+// Purpose:  declare Random class
+// Author:   Stephen Gold sgold@sonic.net
+// (c) Copyright 2012 Stephen Gold
+// Distributed under the terms of the GNU General Public License
+
+/*
+This file is part of the Gold Tile Game.
+
+The Gold Tile Game is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by the
+Free Software Foundation, either version 3 of the License, or (at your
+option) any later version.
+
+The Gold Tile Game is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with the Gold Tile Game.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/*
+A Random object represents a stream of pseudo-random numbers.  Each game
+owns a generator, seeded from its options, so that games in the same
+process don't disturb one another and so that a game can be replayed
+from its seed.
+
+The Random class implements the PCG32 generator (O'Neill, 2014):  a 64-bit
+linear congruential state whose output is scrambled by a xorshift and a
+data-dependent rotation.  Each generator also has a stream selector, so
+generators built from the same seed on different streams produce
+independent outputs.
+*/
+
+#include "fraction.hpp"  // HASA SeedType
+
+class Random {
+public:
+    // public types
+    typedef uint32_t ValueType;
+
+    // public lifecycle
+    Random(void);
+    explicit Random(SeedType, uint64_t stream = 0);
+    // Random(Random const&);  implicitly defined copy constructor
+    // ~Random(void);  implicitly defined destructor
+
+    // public operators
+    // Random& operator=(Random const&);  implicitly defined assignment method
+
+    // misc public methods
+    SizeType  Below(SizeType);  // uniform in [0, n)
+    ValueType Next(void);       // uniform over all 32-bit values
+    void      Seed(uint64_t seed, uint64_t stream);
+    double    Unit(void);       // uniform in [0, 1)
+
+private:
+    // private constants
+    static const uint64_t MULTIPLIER = 6364136223846793005ULL;
+
+    // private data
+    uint64_t mIncrement;  // selects the stream; always odd
+    uint64_t mState;
+};
+#endif  // !defined(RANDOM_HPP_INCLUDED)
@@ -0,0 +1,545 @@
+// File:     reactor.cpp
+// Location: src
+// Purpose:  implement Reactor class
+// Author:   Stephen Gold sgold@sonic.net
+// (c) Copyright 2012 Stephen Gold
+// Distributed under the terms of the GNU General Public License
+
+/*
+This file is part of the Gold Tile Game.
+
+The Gold Tile Game is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by the
+Free Software Foundation, either version 3 of the License, or (at your
+option) any later version.
+
+The Gold Tile Game is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with the Gold Tile Game.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "reactor.hpp"
+
+#ifdef _REACTOR
+
+#include <cerrno>       // errno
+#include <iostream>     // std::cerr
+#include <sys/epoll.h>  // epoll_create1(), epoll_ctl(), epoll_wait()
+#include <sys/eventfd.h> // eventfd()
+#include <sys/socket.h> // accept()
+#include <unistd.h>     // close()
+
+
+// private classes
+
+// a socket registered with a Reactor, and its callback
+class Reactor::Entry {
+public:
+    Entry(Socket const& rSocket, int native, AcceptFunctionType* pAccept,
+            ReadyFunctionType* pReady, void* pArgument):
+        mDrainTimer(0),
+        mIsWatched(false),
+        mNative(native),
+        mpAccept(pAccept),
+        mpArgument(pArgument),
+        mpReady(pReady),
+        mSocket(rSocket),
+        mWatchesOutput(false) {}
+
+    TimerType           mDrainTimer;  // while a closed connection is flushed, else 0
+    bool                mIsWatched;  // registered with the epoll instance
+    int                 mNative;     // native handle, kept after a lost socket is invalidated
+    AcceptFunctionType* mpAccept;    // for a listen socket, else NULL
+    void*               mpArgument;
+    ReadyFunctionType*  mpReady;     // for a data socket, else NULL
+    Socket              mSocket;     // shares its buffers with the caller's copy
+    bool                mWatchesOutput;  // waiting for the socket to become writable
+};
+
+// a pending timer and its callback
+class Reactor::Timer {
+public:
+    Timer(uint64_t deadline, TimerFunctionType* pFunction, void* pArgument):
+        mDeadline(deadline),
+        mpArgument(pArgument),
+        mpFunction(pFunction) {}
+
+    uint64_t           mDeadline;
+    void*              mpArgument;
+    TimerFunctionType* mpFunction;
+};
+
+
+// static functions
+
+// native handle of a socket
+static int native_socket(Socket const& rSocket) {
+    int const result = int(intptr_t(Socket::HandleType(rSocket)));
+
+    return result;
+}
+
+
+// lifecycle
+
+Reactor::Reactor(void) {
+    mHandle = ::epoll_create1(0);
+    ASSERT(mHandle >= 0);
+
+    mClock = 0;
+    mConnectionCnt = 0;
+    mDrainCnt = 0;
+    mLastMsec = ::milliseconds();
+    mNextSerial = 1;
+    mNextTimer = 1;
+    mStopFlag = false;
+
+    mWakeHandle = ::eventfd(0, EFD_NONBLOCK);
+    ASSERT(mWakeHandle >= 0);
+    struct epoll_event event;
+    event.events = EPOLLIN;
+    event.data.u64 = WAKE_SERIAL;
+    int const failure = ::epoll_ctl(mHandle, EPOLL_CTL_ADD, mWakeHandle, &event);
+    ASSERT(failure == 0);
+}
+
+// The registered sockets belong to the callers and aren't closed,
+// except for closed connections which are still being flushed.
+Reactor::~Reactor(void) {
+    EntryMap::iterator i_entry;
+    for (i_entry = mEntries.begin(); i_entry != mEntries.end(); i_entry++) {
+        Entry* const p_entry = i_entry->second;
+        if (p_entry->mDrainTimer != 0) {
+            p_entry->mSocket.Close();
+        }
+        delete p_entry;
+    }
+    TimerMap::iterator i_timer;
+    for (i_timer = mTimers.begin(); i_timer != mTimers.end(); i_timer++) {
+        delete i_timer->second;
+    }
+
+    ::close(mWakeHandle);
+    ::close(mHandle);
+}
+
+
+// misc methods
+
+// Accept every pending connection on a listen socket.
+void Reactor::Accept(Entry& rEntry) {
+    ASSERT(rEntry.mpAccept != NULL);
+
+    int const listen_socket = ::native_socket(rEntry.mSocket);
+    for (;;) {
+        int const data_socket = ::accept(listen_socket, NULL, NULL);
+        if (data_socket < 0) {
+            int const error_code = errno;
+            if (error_code == EAGAIN || error_code == EWOULDBLOCK) {
+                // Another reactor may have taken the connection.
+                break;
+            } else if (error_code == EMFILE || error_code == ENFILE
+                    || error_code == ENOBUFS || error_code == ENOMEM)
+            {
+                // The connection stays pending until resources are freed.
+                std::cerr << "Can't accept a connection (errno=" << error_code
+                    << "); pausing for " << LISTEN_PAUSE_MSEC << " msec."
+                    << std::endl;
+                PauseListen(rEntry);
+                break;
+            }
+            // The connection failed, or was interrupted, before it was accepted.
+            ASSERT(error_code != EBADF && error_code != EFAULT
+                && error_code != EINVAL && error_code != ENOTSOCK);
+            continue;
+        }
+
+        Socket socket = Socket(Socket::HandleType(intptr_t(data_socket)));
+        socket.MakeNonblocking();
+        socket.MakeBuffered();
+        (*rEntry.mpAccept)(*this, rEntry.mpArgument, socket);
+    }
+}
+
+void Reactor::Add(Socket const& rSocket, Entry* pEntry) {
+    ASSERT(pEntry != NULL);
+
+    int const native = ::native_socket(rSocket);
+    ASSERT(mSerials.find(native) == mSerials.end());
+
+    SerialType const serial = mNextSerial;
+    mNextSerial++;
+
+    mEntries[serial] = pEntry;
+    mSerials[native] = serial;
+    Watch(*pEntry);
+}
+
+/*
+Wait on a data socket.  The callback is invoked whenever a line arrives,
+and when the connection is lost, at which point it must remove the socket.
+The socket must be removed before it is closed.
+*/
+void Reactor::AddConnection(
+    Socket const& rSocket,
+    ReadyFunctionType* pFunction,
+    void* pArgument)
+{
+    ASSERT(rSocket.IsValid());
+    ASSERT(pFunction != NULL);
+
+    int const native = ::native_socket(rSocket);
+    Entry* const p_entry
+        = new Entry(rSocket, native, NULL, pFunction, pArgument);
+    ASSERT(p_entry != NULL);
+    Add(rSocket, p_entry);
+    mConnectionCnt++;
+}
+
+// Wait on a (non-blocking) listen socket.
+void Reactor::AddListen(
+    Socket const& rSocket,
+    AcceptFunctionType* pFunction,
+    void* pArgument)
+{
+    ASSERT(rSocket.IsValid());
+    ASSERT(pFunction != NULL);
+
+    int const native = ::native_socket(rSocket);
+    Entry* const p_entry
+        = new Entry(rSocket, native, pFunction, NULL, pArgument);
+    ASSERT(p_entry != NULL);
+    Add(rSocket, p_entry);
+}
+
+// Cancel a pending timer.  Timers which have expired are ignored.
+void Reactor::CancelTimer(TimerType handle) {
+    TimerMap::iterator const i_timer = mTimers.find(handle);
+    if (i_timer != mTimers.end()) {
+        Timer* const p_timer = i_timer->second;
+        mDeadlines.erase(DeadlineType(p_timer->mDeadline, handle));
+        mTimers.erase(i_timer);
+        delete p_timer;
+    }
+}
+
+/*
+Stop waiting on a data socket, and close it.  If the connection hasn't
+taken all the data put to the socket, keep flushing them for a while before
+closing it.  Either way, the caller's socket mustn't be used again.
+*/
+void Reactor::CloseConnection(Socket& rSocket) {
+    int const native = ::native_socket(rSocket);
+    SerialMap::const_iterator const i_serial = mSerials.find(native);
+    ASSERT(i_serial != mSerials.end());
+    Entry* const p_entry = mEntries[i_serial->second];
+    ASSERT(p_entry != NULL);
+    ASSERT(p_entry->mpReady != NULL);
+
+    // A socket invalidated by a lost connection has nothing left to flush.
+    Socket& r_socket = p_entry->mSocket;
+    if (!r_socket.IsValid() || !r_socket.HasUnsentData()) {
+        RemoveConnection(rSocket);
+        rSocket.Close();
+        return;
+    }
+
+    p_entry->mpArgument = NULL;
+    p_entry->mpReady = NULL;
+    p_entry->mWatchesOutput = true;
+    Watch(*p_entry);  // stop waiting for input
+    p_entry->mDrainTimer = StartTimer(DRAIN_MSEC_MAX, &DrainTimeout, p_entry);
+    rSocket.Invalidate();
+    mConnectionCnt--;
+    mDrainCnt++;
+}
+
+SizeType Reactor::CountConnections(void) const {
+    return mConnectionCnt;
+}
+
+void Reactor::Dispatch(SerialType serial, uint32_t events) {
+    EntryMap::iterator const i_entry = mEntries.find(serial);
+    if (i_entry == mEntries.end()) {
+        return;  // removed since the wait
+    }
+    Entry& r_entry = *(i_entry->second);
+
+    if (r_entry.mpAccept != NULL) {
+        Accept(r_entry);
+        return;
+    }
+
+    // A closed connection reports errors only through a failed flush.
+    bool const is_draining = (r_entry.mpReady == NULL);
+    bool lost = false;
+    if (r_entry.mWatchesOutput && ((events & EPOLLOUT) != 0 || is_draining)) {
+        lost = !r_entry.mSocket.Flush();
+        if (!lost && !r_entry.mSocket.HasUnsentData()) {
+            r_entry.mWatchesOutput = false;
+            if (!is_draining) {
+                Watch(r_entry);  // stop waiting for the socket to be writable
+            }
+        }
+    }
+    if (is_draining) {
+        if (lost || !r_entry.mWatchesOutput) {
+            EndDrain(r_entry);
+        }
+        return;
+    }
+
+    // Reading won't wait, so an event without input costs a single recv().
+    if (!lost && (events & ~uint32_t(EPOLLOUT)) != 0) {
+        lost = !r_entry.mSocket.Read(false);
+    }
+    if (lost) {
+        // Stop waking for the lost connection, in case the callback
+        // doesn't remove it right away, and don't flush it when it's closed.
+        Unwatch(r_entry);
+        r_entry.mSocket.Invalidate();
+    }
+    if (lost || r_entry.mSocket.CountLines() > 0) {
+        (*r_entry.mpReady)(*this, r_entry.mpArgument, lost);
+    }
+}
+
+// Give up on flushing a closed connection.
+/* static */ void Reactor::DrainTimeout(Reactor& rReactor, void* pEntry) {
+    Entry* const p_entry = (Entry*)pEntry;
+
+    p_entry->mDrainTimer = 0;
+    rReactor.EndDrain(*p_entry);
+}
+
+// Finish closing a connection closed by CloseConnection().
+void Reactor::EndDrain(Entry& rEntry) {
+    ASSERT(rEntry.mpReady == NULL && rEntry.mpAccept == NULL);
+
+    CancelTimer(rEntry.mDrainTimer);
+    Unwatch(rEntry);
+
+    int const native = rEntry.mNative;
+    SerialMap::iterator const i_serial = mSerials.find(native);
+    ASSERT(i_serial != mSerials.end());
+    mEntries.erase(i_serial->second);
+    mSerials.erase(i_serial);
+
+    rEntry.mSocket.Close();
+    delete &rEntry;
+    mDrainCnt--;
+}
+
+// Invoke the callbacks of any expired timers.
+void Reactor::FireTimers(void) {
+    UpdateClock();
+
+    while (!mDeadlines.empty() && mDeadlines.begin()->first <= mClock) {
+        TimerType const handle = mDeadlines.begin()->second;
+        mDeadlines.erase(mDeadlines.begin());
+
+        TimerMap::iterator const i_timer = mTimers.find(handle);
+        ASSERT(i_timer != mTimers.end());
+        Timer const timer = *(i_timer->second);
+        delete i_timer->second;
+        mTimers.erase(i_timer);
+
+        (*timer.mpFunction)(*this, timer.mpArgument);
+    }
+}
+
+/*
+Once the socket becomes writable, flush any data put to a connection which
+it didn't take right away.  Invoke this after putting data to the socket.
+*/
+void Reactor::FlushConnection(Socket const& rSocket) {
+    int const native = ::native_socket(rSocket);
+    SerialMap::const_iterator const i_serial = mSerials.find(native);
+    ASSERT(i_serial != mSerials.end());
+    Entry& r_entry = *mEntries[i_serial->second];
+    ASSERT(r_entry.mpReady != NULL);
+
+    bool const has_unsent = rSocket.HasUnsentData();
+    if (r_entry.mIsWatched && has_unsent != r_entry.mWatchesOutput) {
+        r_entry.mWatchesOutput = has_unsent;
+        Watch(r_entry);
+    }
+}
+
+// Stop watching a listen socket for a while.
+void Reactor::PauseListen(Entry& rEntry) {
+    ASSERT(rEntry.mpAccept != NULL);
+
+    Unwatch(rEntry);
+    StartTimer(LISTEN_PAUSE_MSEC, &ResumeListen, &rEntry);
+}
+
+// Have the reactor's thread invoke a callback.  Any thread may post.
+void Reactor::Post(PostFunctionType* pFunction, void* pArgument) {
+    ASSERT(pFunction != NULL);
+
+    mPostsMutex.Lock();
+    mPosts.push_back(std::make_pair(pFunction, pArgument));
+    mPostsMutex.Unlock();
+
+    uint64_t const one = 1;
+    ssize_t const byte_cnt = ::write(mWakeHandle, &one, sizeof(one));
+    ASSERT(byte_cnt == sizeof(one));
+}
+
+void Reactor::RemoveConnection(Socket const& rSocket) {
+    int const native = ::native_socket(rSocket);
+    SerialMap::iterator const i_serial = mSerials.find(native);
+    ASSERT(i_serial != mSerials.end());
+
+    EntryMap::iterator const i_entry = mEntries.find(i_serial->second);
+    ASSERT(i_entry != mEntries.end());
+    ASSERT(i_entry->second->mpReady != NULL);
+    Unwatch(*(i_entry->second));
+    delete i_entry->second;
+    mEntries.erase(i_entry);
+    mSerials.erase(i_serial);
+    mConnectionCnt--;
+}
+
+// Invoke the callbacks posted since the last wake.
+void Reactor::RunPosts(void) {
+    uint64_t count;
+    ssize_t const byte_cnt = ::read(mWakeHandle, &count, sizeof(count));
+    ASSERT(byte_cnt == sizeof(count) || errno == EAGAIN);
+
+    PostVector posts;
+    mPostsMutex.Lock();
+    posts.swap(mPosts);
+    mPostsMutex.Unlock();
+
+    PostVector::const_iterator i_post;
+    for (i_post = posts.begin(); i_post != posts.end(); i_post++) {
+        (*(i_post->first))(*this, i_post->second);
+    }
+}
+
+/*
+Dispatch events until Stop() is invoked by a callback, and any closed
+connections have been flushed.
+*/
+void Reactor::Run(void) {
+    mStopFlag = false;
+
+    while (!mStopFlag || mDrainCnt > 0) {
+        // Sleep until an event or the soonest deadline.
+        UpdateClock();
+        int timeout_msec = -1;
+        if (!mDeadlines.empty()) {
+            uint64_t const deadline = mDeadlines.begin()->first;
+            timeout_msec = (deadline > mClock) ? int(deadline - mClock) : 0;
+        }
+
+        struct epoll_event events[EVENT_CNT_MAX];
+        int const event_cnt = ::epoll_wait(mHandle, events, EVENT_CNT_MAX, timeout_msec);
+        if (event_cnt < 0) {
+            ASSERT(errno == EINTR);
+            continue;
+        }
+        for (int i_event = 0; i_event < event_cnt; i_event++) {
+            SerialType const serial = events[i_event].data.u64;
+            if (serial == WAKE_SERIAL) {
+                RunPosts();
+            } else {
+                Dispatch(serial, events[i_event].events);
+            }
+        }
+
+        FireTimers();
+    }
+}
+
+// Resume watching a listen socket paused by PauseListen().
+/* static */ void Reactor::ResumeListen(Reactor& rReactor, void* pEntry) {
+    Entry* const p_entry = (Entry*)pEntry;
+
+    rReactor.Watch(*p_entry);
+}
+
+// Start a one-shot timer.  Return a handle for CancelTimer().
+Reactor::TimerType Reactor::StartTimer(
+    MsecIntervalType delay,
+    TimerFunctionType* pFunction,
+    void* pArgument)
+{
+    ASSERT(pFunction != NULL);
+
+    UpdateClock();
+    TimerType const result = mNextTimer;
+    mNextTimer++;
+    if (mNextTimer == 0) {
+        mNextTimer = 1;
+    }
+
+    uint64_t const deadline = mClock + delay;
+    Timer* const p_timer = new Timer(deadline, pFunction, pArgument);
+    ASSERT(p_timer != NULL);
+    mTimers[result] = p_timer;
+    mDeadlines.insert(DeadlineType(deadline, result));
+
+    return result;
+}
+
+// Make Run() return once the current events have been dispatched.
+void Reactor::Stop(void) {
+    mStopFlag = true;
+}
+
+// Have the epoll instance stop waiting on a registered socket.
+void Reactor::Unwatch(Entry& rEntry) {
+    if (rEntry.mIsWatched) {
+        int const failure
+            = ::epoll_ctl(mHandle, EPOLL_CTL_DEL, rEntry.mNative, NULL);
+        ASSERT(failure == 0);
+        rEntry.mIsWatched = false;
+    }
+}
+
+// Advance mClock, which (unlike the real-time clock) never wraps around.
+void Reactor::UpdateClock(void) {
+    MsecIntervalType const now = ::milliseconds();
+    mClock += MsecIntervalType(now - mLastMsec);
+    mLastMsec = now;
+}
+
+/*
+Have the epoll instance wait on a registered socket, or update the events
+it waits for:  input unless the connection was closed, and the socket
+becoming writable while it has data to flush.
+*/
+void Reactor::Watch(Entry& rEntry) {
+    int const native = rEntry.mNative;
+    SerialMap::const_iterator const i_serial = mSerials.find(native);
+    ASSERT(i_serial != mSerials.end());
+
+    struct epoll_event event;
+    event.events = 0;
+    if (rEntry.mpAccept != NULL || rEntry.mpReady != NULL) {
+        event.events |= EPOLLIN;
+    }
+    if (rEntry.mWatchesOutput) {
+        event.events |= EPOLLOUT;
+    }
+#ifdef EPOLLEXCLUSIVE
+    if (rEntry.mpAccept != NULL) {
+        // Wake only one of the reactors which share the listen socket.
+        event.events |= EPOLLEXCLUSIVE;
+    }
+#endif  // defined(EPOLLEXCLUSIVE)
+    event.data.u64 = i_serial->second;
+    int const operation = rEntry.mIsWatched ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+    int const failure = ::epoll_ctl(mHandle, operation, native, &event);
+    ASSERT(failure == 0);
+    rEntry.mIsWatched = true;
+}
+
+#endif  // defined(_REACTOR)
@@ -0,0 +1,143 @@
+#ifndef REACTOR_HPP_INCLUDED
+#define REACTOR_HPP_INCLUDED
+
+// File:     reactor.hpp
+// Location: src
+// Purpose:  declare Reactor class
+// Author:   Stephen Gold sgold@sonic.net
+// (c) Copyright 2012 Stephen Gold
+// Distributed under the terms of the GNU General Public License
+
+/*
+This file is part of the Gold Tile Game.
+
+The Gold Tile Game is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by the
+Free Software Foundation, either version 3 of the License, or (at your
+option) any later version.
+
+The Gold Tile Game is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with the Gold Tile Game.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+A Reactor object represents an event loop which waits on many sockets
+at once, so that a single thread can serve thousands of idle connections
+without polling them.  It invokes a callback when a listen socket has
+a new connection, when a complete line arrives on a data socket, when
+a data socket's connection is lost, and when a timer expires.
+
+The Reactor class encapsulates an epoll instance (hence it exists only
+in _REACTOR builds), the registered sockets, and a set of one-shot
+timers ordered by deadline.  Incoming data are read into the Socket's
+own buffer, so the callback can get every complete line without waiting.
+Data sockets are buffered, so output the connection won't take right away
+is kept and flushed once the socket becomes writable, and a connection
+closed with output still unsent lingers (for a while) until it's flushed.
+Each registration gets a serial number which is never reused, so events
+for a socket removed during the same wait are ignored.  Other threads
+may post callbacks to run on the reactor's thread, such as the results of
+searches, and an eventfd wakes the wait when they do.  When the process
+runs out of descriptors or memory, a listen socket stops being watched
+for a while, so existing connections keep being served instead of the
+pending connection waking the reactor over and over.
+*/
+
+#include <map>          // HASA std::map
+#include <set>          // HASA std::set
+#include <vector>       // HASA std::vector
+#include "mutex.hpp"    // HASA Mutex
+#include "socket.hpp"   // HASA Socket
+
+#ifdef _REACTOR
+
+class Reactor {
+public:
+    // public types
+    typedef void     AcceptFunctionType(Reactor&, void*, Socket&);  // new connection
+    typedef void     PostFunctionType(Reactor&, void*);  // posted by another thread
+    typedef void     ReadyFunctionType(Reactor&, void*, bool lost);  // line arrived or connection lost
+    typedef void     TimerFunctionType(Reactor&, void*);
+    typedef uint32_t TimerType;  // 0 means no timer
+
+    // public lifecycle
+    Reactor(void);
+    ~Reactor(void);
+
+    // misc public methods
+    void      AddConnection(Socket const&, ReadyFunctionType*, void* arg);
+    void      AddListen(Socket const&, AcceptFunctionType*, void* arg);
+    void      CancelTimer(TimerType);
+    void      CloseConnection(Socket&);
+    SizeType  CountConnections(void) const;
+    void      FlushConnection(Socket const&);
+    void      Post(PostFunctionType*, void* arg);  // thread-safe
+    void      RemoveConnection(Socket const&);
+    void      Run(void);
+    TimerType StartTimer(MsecIntervalType delay, TimerFunctionType*, void* arg);
+    void      Stop(void);
+
+private:
+    // private types
+    class Entry;  // a registered socket
+    class Timer;  // a pending timer
+    typedef uint64_t                   SerialType;
+    typedef std::pair<uint64_t, TimerType>
+                                       DeadlineType;
+    typedef std::map<SerialType, Entry*> EntryMap;
+    typedef std::vector<std::pair<PostFunctionType*, void*> >
+                                       PostVector;
+    typedef std::map<int, SerialType>  SerialMap;
+    typedef std::map<TimerType, Timer*> TimerMap;
+
+    // private constants
+    static const MsecIntervalType DRAIN_MSEC_MAX = 10000;    // to flush a closed connection
+    static const int              EVENT_CNT_MAX = 64;        // events handled per wait
+    static const MsecIntervalType LISTEN_PAUSE_MSEC = 1000;  // after accept() runs out of resources
+    static const uint64_t         WAKE_SERIAL = 0;           // event serial of the eventfd, never assigned
+
+    // private data
+    uint64_t               mClock;        // milliseconds since construction
+    SizeType               mConnectionCnt;
+    std::set<DeadlineType> mDeadlines;    // pending timers, soonest first
+    SizeType               mDrainCnt;     // closed connections still being flushed
+    EntryMap               mEntries;      // registered sockets, by serial number
+    int                    mHandle;       // the epoll instance
+    MsecIntervalType       mLastMsec;     // real-time clock when mClock was updated
+    SerialType             mNextSerial;
+    TimerType              mNextTimer;
+    PostVector             mPosts;        // callbacks posted by other threads
+    Mutex                  mPostsMutex;
+    SerialMap              mSerials;      // serial numbers, by native socket
+    bool                   mStopFlag;
+    TimerMap               mTimers;       // pending timers, by handle
+    int                    mWakeHandle;   // eventfd written by Post()
+
+    // private lifecycle
+    Reactor(Reactor const&);  // not copyable
+
+    // private operators
+    Reactor& operator=(Reactor const&);  // not assignable
+
+    // misc private methods
+    void        Accept(Entry&);
+    void        Add(Socket const&, Entry*);
+    void        Dispatch(SerialType, uint32_t events);
+    static void DrainTimeout(Reactor&, void* pEntry);
+    void        EndDrain(Entry&);
+    void        FireTimers(void);
+    void        PauseListen(Entry&);
+    static void ResumeListen(Reactor&, void* pEntry);
+    void        RunPosts(void);
+    void        Unwatch(Entry&);
+    void        UpdateClock(void);
+    void        Watch(Entry&);
+};
+
+#endif  // defined(_REACTOR)
+#endif  // !defined(REACTOR_HPP_INCLUDED)
@@ -0,0 +1,150 @@
+// File:     searchpool.cpp
+// Location: src
+// Purpose:  implement SearchPool class
+// Author:   Stephen Gold sgold@sonic.net
+// (c) Copyright 2012 Stephen Gold
+// Distributed under the terms of the GNU General Public License
+
+/*
+This file is part of the Gold Tile Game.
+
+The Gold Tile Game is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by the
+Free Software Foundation, either version 3 of the License, or (at your
+option) any later version.
+
+The Gold Tile Game is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with the Gold Tile Game.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "searchpool.hpp"
+
+#ifdef _REACTOR
+
+#include "game.hpp"
+#include "gamecontext.hpp"
+#include "hand.hpp"
+#include "workers.hpp"
+
+
+// static callback functions
+
+// thread function for a search thread
+static void* search_main(void* pArgument) {
+    SearchPool* const p_pool = (SearchPool*)pArgument;
+
+    p_pool->Serve();
+
+    return NULL;
+}
+
+
+// lifecycle
+
+SearchPool::SearchPool(SizeType threadCnt) {
+    if (threadCnt == 0) {
+        threadCnt = Workers::CountProcessors();
+    }
+    if (threadCnt > THREAD_CNT_MAX) {
+        threadCnt = THREAD_CNT_MAX;
+    }
+    ASSERT(threadCnt > 0);
+
+    mStopFlag = false;
+    mThreadCnt = 0;
+
+    int error = ::pthread_mutex_init(&mLock, NULL);
+    ASSERT(error == 0);
+    error = ::pthread_cond_init(&mSearchReady, NULL);
+    ASSERT(error == 0);
+
+    while (mThreadCnt < threadCnt) {
+        error = ::pthread_create(&mThreads[mThreadCnt], NULL, &search_main, this);
+        if (error != 0) {
+            break;  // the threads already started will pick up the slack
+        }
+        mThreadCnt++;
+    }
+    ASSERT(mThreadCnt > 0);
+}
+
+// Tell the threads to exit, and wait for them.
+// No searches should be pending.
+SearchPool::~SearchPool(void) {
+    ::pthread_mutex_lock(&mLock);
+    ASSERT(mPending.empty());
+    mStopFlag = true;
+    ::pthread_cond_broadcast(&mSearchReady);
+    ::pthread_mutex_unlock(&mLock);
+
+    for (SizeType i = 0; i < mThreadCnt; i++) {
+        ::pthread_join(mThreads[i], NULL);
+    }
+
+    ::pthread_cond_destroy(&mSearchReady);
+    ::pthread_mutex_destroy(&mLock);
+}
+
+
+// misc methods
+
+SizeType SearchPool::Count(void) const {
+    return mThreadCnt;
+}
+
+// Perform searches until the pool is destroyed.
+void SearchPool::Serve(void) {
+    for (;;) {
+        ::pthread_mutex_lock(&mLock);
+        while (mPending.empty() && !mStopFlag) {
+            ::pthread_cond_wait(&mSearchReady, &mLock);
+        }
+        if (mPending.empty()) {
+            ::pthread_mutex_unlock(&mLock);
+            break;
+        }
+        Search const search = mPending.front();
+        mPending.pop_front();
+        ::pthread_mutex_unlock(&mLock);
+
+        search.mpGame->SelectContext();
+        Hand const playable = Hand(*search.mpGame);
+        *search.mpMove = playable.GetAutomaticMove(*search.mpGame);
+
+        // Don't leave this thread with a selection the reactor may delete.
+        GameContext::Select(NULL);
+        search.mpReactor->Post(search.mpDone, search.mpArgument);
+    }
+}
+
+// Queue a search for the playable hand's move.  The callback runs
+// on the reactor's thread once the move has been stored.
+void SearchPool::Start(
+    Game& rGame,
+    Move& rMove,
+    Reactor& rReactor,
+    Reactor::PostFunctionType* pDone,
+    void* pArgument)
+{
+    ASSERT(pDone != NULL);
+
+    Search search;
+    search.mpArgument = pArgument;
+    search.mpDone = pDone;
+    search.mpGame = &rGame;
+    search.mpMove = &rMove;
+    search.mpReactor = &rReactor;
+
+    ::pthread_mutex_lock(&mLock);
+    ASSERT(!mStopFlag);
+    mPending.push_back(search);
+    ::pthread_cond_signal(&mSearchReady);
+    ::pthread_mutex_unlock(&mLock);
+}
+
+#endif  // defined(_REACTOR)
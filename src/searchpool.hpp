@@ -0,0 +1,89 @@
+#ifndef SEARCHPOOL_HPP_INCLUDED
+#define SEARCHPOOL_HPP_INCLUDED
+
+// File:     searchpool.hpp
+// Location: src
+// Purpose:  declare SearchPool class
+// Author:   Stephen Gold sgold@sonic.net
+// (c) Copyright 2012 Stephen Gold
+// Distributed under the terms of the GNU General Public License
+
+/*
+This file is part of the Gold Tile Game.
+
+The Gold Tile Game is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by the
+Free Software Foundation, either version 3 of the License, or (at your
+option) any later version.
+
+The Gold Tile Game is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with the Gold Tile Game.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+A SearchPool object represents a group of threads which choose moves
+for automatic hands on behalf of reactors, so that a long search never
+stalls the other games on a reactor's thread.
+
+The SearchPool class encapsulates a queue of pending searches, along with
+a pthreads lock and condition variable.  Each search selects its game's
+GameContext, stores the chosen move where the caller asked, and then
+posts the caller's callback to the caller's reactor.  The game must
+not be touched by any other thread until that callback runs.
+*/
+
+#include <deque>        // HASA std::deque
+#include "reactor.hpp"  // HASA Reactor::PostFunctionType
+
+#ifdef _REACTOR
+
+#include <pthread.h>    // HASA pthread_t
+
+class SearchPool {
+public:
+    // public constants
+    static const SizeType THREAD_CNT_MAX = 64;
+
+    // public lifecycle
+    explicit SearchPool(SizeType threadCnt = 0);  // 0 means one per processor
+    ~SearchPool(void);
+
+    // misc public methods
+    SizeType Count(void) const;
+    void     Serve(void);  // invoked by each search thread
+    void     Start(Game&, Move&, Reactor&, Reactor::PostFunctionType*,
+                 void* arg);
+
+private:
+    // private types
+    struct Search {
+        Reactor::PostFunctionType* mpDone;      // posted once the move is chosen
+        void*                      mpArgument;  // argument for that callback
+        Game*                      mpGame;
+        Move*                      mpMove;      // where to store the move
+        Reactor*                   mpReactor;
+    };
+    typedef std::deque<Search> SearchQueue;
+
+    // private data
+    pthread_t       mThreads[THREAD_CNT_MAX];
+    pthread_mutex_t mLock;
+    SearchQueue     mPending;     // searches not yet claimed by a thread
+    pthread_cond_t  mSearchReady;
+    bool            mStopFlag;    // tells the threads to exit
+    SizeType        mThreadCnt;   // number of threads started
+
+    // private lifecycle
+    SearchPool(SearchPool const&);  // not copyable
+
+    // private operators
+    SearchPool& operator=(SearchPool const&);  // not assignable
+};
+
+#endif  // defined(_REACTOR)
+#endif  // !defined(SEARCHPOOL_HPP_INCLUDED)
@@ -0,0 +1,295 @@
+// File:     selfplay.cpp
+// Location: src
+// Purpose:  implement SelfPlay class
+// Author:   Stephen Gold sgold@sonic.net
+// (c) Copyright 2012 Stephen Gold
+// Distributed under the terms of the GNU General Public License
+
+/*
+This file is part of the Gold Tile Game.
+
+The Gold Tile Game is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by the
+Free Software Foundation, either version 3 of the License, or (at your
+option) any later version.
+
+The Gold Tile Game is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with the Gold Tile Game.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <iostream>     // cout
+#include "game.hpp"
+#include "selfplay.hpp"
+#include "socket.hpp"
+#include "strings.hpp"
+#include "workers.hpp"
+
+
+// static callback functions
+
+// callback for worker threads
+static void play_game(void* pArgument, SizeType game) {
+    SelfPlay* const p_self_play = (SelfPlay*)pArgument;
+
+    p_self_play->PlayGame(game);
+}
+
+
+// lifecycle
+
+SelfPlay::SelfPlay(GameOpt const& rGameOpt, HandOpts const& rHandOpts):
+    mGameOpt(rGameOpt),
+    mHandOpts(rHandOpts)
+{
+    ASSERT(mHandOpts.Count() == mGameOpt.HandsDealt());
+#ifdef _DEBUG
+    for (SizeType i_hand = 0; i_hand < mHandOpts.Count(); i_hand++) {
+        ASSERT(mHandOpts[i_hand].IsAutomatic());
+        ASSERT(!mHandOpts[i_hand].IsRemote());
+    }
+#endif  // defined(_DEBUG)
+
+    /*
+    Game options select the deal by seed only in debug style
+    with randomization disabled.
+    */
+    mGameOpt.SetDebug();
+    mGameOpt.SetRandomizeFlag(false);
+    mElapsedMsec = 0;
+}
+
+// The implicitly defined destructor is fine.
+
+
+// operators
+
+// one header line followed by one line per game
+SelfPlay::operator String(void) const {
+    String result = "seed,turns,msec,ending";
+    for (SizeType i_hand = 0; i_hand < mHandOpts.Count(); i_hand++) {
+        result += "," + mHandOpts[i_hand].PlayerName();
+    }
+    result += "\n";
+
+    std::vector<String>::const_iterator i_row;
+    for (i_row = mRows.begin(); i_row != mRows.end(); i_row++) {
+        result += *i_row + "\n";
+    }
+
+    return result;
+}
+
+
+// misc methods
+
+void SelfPlay::AddSeed(SeedType seed) {
+    mSeeds.push_back(seed);
+}
+
+SizeType SelfPlay::CountGames(void) const {
+    SizeType const result = SizeType(mSeeds.size());
+
+    return result;
+}
+
+// Count the games which should have been saved but weren't.
+SizeType SelfPlay::CountUnsaved(void) const {
+    SizeType result = 0;
+    if (!mSaveDirectory.IsEmpty()) {
+        for (SizeType i_game = 0; i_game < mSaved.size(); i_game++) {
+            if (mSaved[i_game] == 0) {
+                result++;
+            }
+        }
+    }
+
+    return result;
+}
+
+double SelfPlay::GamesPerSecond(void) const {
+    double result = 0.0;
+    if (mElapsedMsec > 0) {
+        result = 1000.0*CountGames()/mElapsedMsec;
+    }
+
+    return result;
+}
+
+void SelfPlay::PlayGame(SizeType game) {
+    ASSERT(game < CountGames());
+
+    SeedType const seed = mSeeds[game];
+    GameOpt game_opt = mGameOpt;
+    game_opt.SetSeed(seed);
+
+    // The new game selects its own context for this thread.
+    MsecIntervalType const start = ::milliseconds();
+    Socket const no_client;
+    Game* const p_game = Game::New(game_opt, mHandOpts, no_client);
+    ASSERT(p_game != NULL);
+
+    SizeType turn_cnt = 0;
+    bool was_successful = p_game->Initialize();
+    while (was_successful && !p_game->IsOver()) {
+        if (turn_cnt > 0) {
+            p_game->ActivateNextHand();
+        }
+        p_game->StartClock();
+        Hand const playable = Hand(*p_game);
+        Move const move = playable.GetAutomaticMove(*p_game);
+        was_successful = p_game->FinishTurn(move);
+        turn_cnt++;
+    }
+
+    String row = String(unsigned(seed)) + "," + String(unsigned(turn_cnt));
+    if (was_successful) {
+        p_game->EndBonus();
+        MsecIntervalType const msec = ::milliseconds() - start;
+        row += "," + String(unsigned(msec)) + ","
+            + ::ending_to_string(p_game->Ending());
+
+        Hands const hands = Hands(*p_game);
+        Hands::ConstIterator i_hand;
+        for (i_hand = hands.begin(); i_hand != hands.end(); i_hand++) {
+            row += "," + String(long(i_hand->Score()));
+        }
+
+        if (!mSaveDirectory.IsEmpty()) {
+            String const filespec = mSaveDirectory + "/game-"
+                + String(unsigned(seed)) + ".bin";
+            bool const was_saved = p_game->SaveBinary(filespec);
+            mSaved[game] = was_saved ? 1 : 0;
+        }
+    } else {
+        MsecIntervalType const msec = ::milliseconds() - start;
+        row += "," + String(unsigned(msec)) + ",failed";
+    }
+    delete p_game;
+
+    mRows[game] = row;
+}
+
+void SelfPlay::Run(SizeType threadCnt) {
+    mRows.assign(mSeeds.size(), String());
+    mSaved.assign(mSeeds.size(), 0);
+
+    MsecIntervalType const start = ::milliseconds();
+    Workers workers(threadCnt);
+    workers.Run(&::play_game, this, CountGames());
+    mElapsedMsec = ::milliseconds() - start;
+}
+
+// Save each finished game in the given directory, for later analysis.
+void SelfPlay::SetSaveDirectory(String const& rDirectory) {
+    mSaveDirectory = rDirectory;
+}
+
+
+#ifdef _SELFPLAY
+
+// command-line utility to play a batch of automatic games
+
+static void usage(void) {
+    std::cerr << "usage:  gold-tile-selfplay [-j THREADS] [-h STRATEGY:LEVEL,...] "
+        << "[-s DIRECTORY] \"NAME=VALUE;...\" SEED|FIRST-LAST ..." << std::endl;
+}
+
+int main(int argCnt, char** argValues) {
+    String save_directory;
+    SizeType thread_cnt = 0;
+    Strings hand_specs("greedy:10,greedy:10", ",");
+
+    int i_arg = 1;
+    while (i_arg + 1 < argCnt && argValues[i_arg][0] == '-') {
+        String const flag = argValues[i_arg];
+        String const value = argValues[i_arg + 1];
+        if (flag == "-j") {
+            thread_cnt = SizeType(long(value));
+        } else if (flag == "-h") {
+            hand_specs = Strings(value, ",");
+        } else if (flag == "-s") {
+            save_directory = value;
+        } else {
+            ::usage();
+            return EXIT_FAILURE;
+        }
+        i_arg += 2;
+    }
+    if (i_arg + 2 > argCnt) {
+        ::usage();
+        return EXIT_FAILURE;
+    }
+
+    // Options named on the command line override the defaults.
+    Strings const lines(argValues[i_arg], ";");
+    String const game_string = String(GameOpt()) + String(lines, "\n");
+    GameOpt game_opt(game_string);
+    i_arg++;
+
+    HandOpts hand_opts;
+    Strings::ConstIterator i_spec;
+    for (i_spec = hand_specs.Begin(); i_spec != hand_specs.End(); i_spec++) {
+        Strings const fields(*i_spec, ":");
+        if (fields.Count() != 2) {
+            ::usage();
+            return EXIT_FAILURE;
+        }
+        StrategyType const strategy = ::string_to_strategy(fields.First());
+        HandOpt::LevelType const level = HandOpt::LevelType(long(fields.Second()));
+        if (strategy == STRATEGY_NONE
+         || level < HandOpt::LEVEL_MIN
+         || level > HandOpt::LEVEL_MAX) {
+            ::usage();
+            return EXIT_FAILURE;
+        }
+
+        HandOpt hand_opt;
+        hand_opt.SetAutomatic();
+        hand_opt.SetLevel(level);
+        hand_opt.SetStrategy(strategy);
+        String const name = "Computer" + String(unsigned(hand_opts.Count() + 1));
+        hand_opt.SetPlayerName(name);
+        hand_opts.Append(hand_opt);
+    }
+    game_opt.SetHandsDealt(hand_opts.Count());
+
+    SelfPlay self_play(game_opt, hand_opts);
+    self_play.SetSaveDirectory(save_directory);
+    for (; i_arg < argCnt; i_arg++) {
+        Strings const range(argValues[i_arg], "-");
+        SeedType const first = SeedType(long(range.First()));
+        SeedType last = first;
+        if (range.Count() == 2) {
+            last = SeedType(long(range.Second()));
+        }
+        for (SeedType seed = first; seed <= last; seed++) {
+            self_play.AddSeed(seed);
+        }
+    }
+
+    // Discard the console output of the games themselves.
+    std::streambuf* const p_stdout = std::cout.rdbuf(NULL);
+
+    self_play.Run(thread_cnt);
+
+    std::cout.rdbuf(p_stdout);
+    std::cout << String(self_play);
+    std::cerr << self_play.CountGames() << " games at "
+        << self_play.GamesPerSecond() << " games per second" << std::endl;
+
+    SizeType const unsaved_cnt = self_play.CountUnsaved();
+    if (unsaved_cnt > 0) {
+        std::cerr << ::plural(unsaved_cnt, "game") << " couldn't be saved in "
+            << save_directory << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+#endif  // defined(_SELFPLAY)
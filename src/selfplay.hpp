@@ -0,0 +1,83 @@
+#ifndef SELFPLAY_HPP_INCLUDED
+#define SELFPLAY_HPP_INCLUDED
+
+// File:     selfplay.hpp
+// Location: src
+// Purpose:  declare SelfPlay class
+// Author:   Stephen Gold sgold@sonic.net
+// (c) Copyright 2012 Stephen Gold
+// Distributed under the terms of the GNU General Public License
+
+/*
+This file is part of the Gold Tile Game.
+
+The Gold Tile Game is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by the
+Free Software Foundation, either version 3 of the License, or (at your
+option) any later version.
+
+The Gold Tile Game is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with the Gold Tile Game.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+A SelfPlay object represents a batch of games between automatic hands,
+played without any user interaction, for tuning and benchmarking.
+
+The SelfPlay class encapsulates the game options, the hand options,
+and a list of random-number seeds, one per game.  The games are spread
+across a Workers object, each game in its own GameContext, so they run
+concurrently.  The outcome of each game is recorded as
+a row of comma-separated values:  the seed, the number of turns, the
+elapsed time, how the game ended, and the final score of each hand.
+Optionally, each finished game is saved in the binary format, ready
+for an Analyzer.
+*/
+
+#include <vector>        // HASA std::vector
+#include "fraction.hpp"  // HASA SeedType
+#include "gameopt.hpp"   // HASA GameOpt
+#include "handopts.hpp"  // HASA HandOpts
+#include "string.hpp"    // HASA String
+
+class SelfPlay {
+public:
+    // public lifecycle
+    // no default constructor
+    SelfPlay(GameOpt const&, HandOpts const&);
+    // ~SelfPlay(void);  implicitly defined destructor
+
+    // public operators
+    operator String(void) const;  // CSV header and rows
+
+    // misc public methods
+    void     AddSeed(SeedType);
+    SizeType CountGames(void) const;
+    SizeType CountUnsaved(void) const;
+    double   GamesPerSecond(void) const;
+    void     PlayGame(SizeType);  // invoked by worker threads
+    void     Run(SizeType threadCnt);
+    void     SetSaveDirectory(String const&);
+
+private:
+    // private data
+    MsecIntervalType      mElapsedMsec;  // wall-clock time for the batch
+    GameOpt               mGameOpt;
+    HandOpts              mHandOpts;
+    std::vector<String>   mRows;         // one CSV row per game
+    String                mSaveDirectory;  // where to save finished games, or empty
+    std::vector<int>      mSaved;        // one flag per game (not packed, since threads share it)
+    std::vector<SeedType> mSeeds;        // one seed per game
+
+    // private lifecycle
+    SelfPlay(SelfPlay const&);  // not copyable
+
+    // private operators
+    SelfPlay& operator=(SelfPlay const&);  // not assignable
+};
+#endif  // !defined(SELFPLAY_HPP_INCLUDED)
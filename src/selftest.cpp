@@ -0,0 +1,239 @@
+// File:     selftest.cpp
+// Location: src
+// Purpose:  command-line utility to check features the games don't exercise
+// Author:   Stephen Gold sgold@sonic.net
+// (c) Copyright 2012 Stephen Gold
+// Distributed under the terms of the GNU General Public License
+
+/*
+This file is part of the Gold Tile Game.
+
+The Gold Tile Game is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by the
+Free Software Foundation, either version 3 of the License, or (at your
+option) any later version.
+
+The Gold Tile Game is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with the Gold Tile Game.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+The self-test plays short automatic games and checks behavior which
+neither the self-play nor the host reaches:  cancellation, checkpoints,
+and the binary file format.  Each check prints one line, and the exit
+status counts the checks which failed.
+*/
+
+#ifdef _SELFTEST
+
+#include <cstdio>       // remove()
+#include <iostream>     // cerr, cout
+#include "game.hpp"
+#include "gamecontext.hpp"
+#include "hand.hpp"
+#include "handopts.hpp"
+#include "partial.hpp"
+#include "socket.hpp"
+#include "turns.hpp"
+
+
+// static callback functions
+
+// yield callback which cancels once its countdown runs out
+static void cancel_after(void* pArgument, bool& rCancel) {
+    SizeType* const p_countdown = (SizeType*)pArgument;
+
+    if (*p_countdown == 0) {
+        rCancel = true;
+    } else {
+        (*p_countdown)--;
+    }
+}
+
+
+// static functions
+
+// Start an automatic game and play the given number of turns.
+static Game* new_game(SeedType seed, SizeType turnCnt) {
+    GameOpt game_opt;
+    game_opt.SetDebug();
+    game_opt.SetRandomizeFlag(false);
+    game_opt.SetSeed(seed);
+    game_opt.SetHandSize(6);
+
+    HandOpts hand_opts;
+    for (unsigned i_hand = 0; i_hand < 2; i_hand++) {
+        HandOpt hand_opt;
+        hand_opt.SetAutomatic();
+        hand_opt.SetPlayerName("Computer" + String(i_hand + 1));
+        hand_opts.Append(hand_opt);
+    }
+    game_opt.SetHandsDealt(hand_opts.Count());
+
+    // The new game selects its own context for this thread.
+    Socket const no_client;
+    Game* const p_result = Game::New(game_opt, hand_opts, no_client);
+    ASSERT(p_result != NULL);
+    bool const was_successful = p_result->Initialize();
+    ASSERT(was_successful);
+
+    for (SizeType i_turn = 0; i_turn < turnCnt; i_turn++) {
+        if (i_turn > 0) {
+            p_result->ActivateNextHand();
+        }
+        p_result->StartClock();
+        Hand const playable = Hand(*p_result);
+        Move const move = playable.GetAutomaticMove(*p_result);
+        p_result->FinishTurn(move);
+    }
+    p_result->ActivateNextHand();
+
+    return p_result;
+}
+
+// Describe the position of a game:  everything a turn depends on.
+static String position(Game const& rGame) {
+    String result = String(Board(rGame)) + "\n" + rGame.StockBagString() + "\n";
+
+    Hands const hands = Hands(rGame);
+    Hands::ConstIterator i_hand;
+    for (i_hand = hands.begin(); i_hand != hands.end(); i_hand++) {
+        result += i_hand->Name() + " " + String(long(i_hand->Score())) + " "
+            + String(Tiles(*i_hand)) + "\n";
+    }
+    result += Hand(rGame).Name() + " "
+        + String(unsigned(Turns(rGame).Count())) + " "
+        + String(unsigned(rGame.MustPlay())) + "\n";
+
+    return result;
+}
+
+// Suggest a move for the playable hand, optionally canceling the search.
+static Move suggest(Game& rGame, SizeType* pCountdown) {
+    rGame.SelectContext();
+    if (pCountdown != NULL) {
+        Partial::SetYield(&cancel_after, pCountdown);
+    }
+
+    Partial partial(&rGame, HINT_NONE, 0.0);
+    partial.Suggest();
+    Partial::SetYield(NULL, NULL);
+
+    Move const result = partial.GetMove(false);
+
+    return result;
+}
+
+// A canceled suggestion must not be cached, or replace the search with a swap.
+static bool test_canceled_suggestion(void) {
+    SeedType const seed = 1;
+    SizeType const turn_cnt = 4;
+
+    Game* const p_reference = new_game(seed, turn_cnt);
+    Move const full = suggest(*p_reference, NULL);
+    delete p_reference;
+
+    Game* const p_game = new_game(seed, turn_cnt);
+    SizeType countdown = 1;
+    Move const canceled = suggest(*p_game, &countdown);
+    Move const again = suggest(*p_game, NULL);
+    delete p_game;
+
+    bool const result = !full.IsPass()
+        && canceled != full && !canceled.InvolvesSwap()
+        && !(again != full);
+
+    return result;
+}
+
+// Seeking through the checkpoints must match a replay from the deal.
+static bool test_seek_turn(void) {
+    SizeType const interval = Game::CHECKPOINT_INTERVAL;
+    SizeType const hand_cnt = 2;
+    SizeType const turn_cnt = 3*interval + 3;
+    Game* const p_game = new_game(2, turn_cnt);
+    SizeType const end = Turns(*p_game).Count();
+
+    // before, at, and after checkpoints, reached forward and backward
+    SizeType const targets[] = {
+        interval - 1, interval, interval + 1, end, 2*interval,
+        hand_cnt, 3*interval + 1, 2*interval - 1, interval, end
+    };
+    SizeType const target_cnt = sizeof(targets)/sizeof(targets[0]);
+
+    bool result = true;
+    for (SizeType i_target = 0; i_target < target_cnt; i_target++) {
+        SizeType const target = targets[i_target];
+        ASSERT(target >= hand_cnt && target <= end);
+
+        p_game->SeekTurn(target);
+        String const sought = ::position(*p_game);
+
+        p_game->Restart();
+        while (Turns(*p_game).Count() < target) {
+            p_game->Redo();
+        }
+        String const replayed = ::position(*p_game);
+
+        if (sought != replayed) {
+            result = false;
+        }
+    }
+    delete p_game;
+
+    return result;
+}
+
+// A game saved in the binary format must load back unchanged.
+static bool test_binary_round_trip(void) {
+    TextType const filespec = "selftest.bin";
+    Game* const p_game = new_game(3, 12);
+    String const saved_turns = String(Turns(*p_game));
+    String const saved_position = ::position(*p_game);
+    bool result = p_game->SaveBinary(filespec);
+    delete p_game;
+
+    if (result) {
+        Game* const p_loaded = Game::Load(filespec);
+        result = (p_loaded != NULL);
+        if (result) {
+            result = (String(Turns(*p_loaded)) == saved_turns)
+                && (::position(*p_loaded) == saved_position);
+            delete p_loaded;
+        }
+    }
+    std::remove(filespec);
+
+    return result;
+}
+
+static void report(TextType name, bool passed, int& rFailureCnt) {
+    std::cerr << name << ": " << (passed ? "ok" : "FAILED") << std::endl;
+    if (!passed) {
+        rFailureCnt++;
+    }
+}
+
+
+// command-line utility to run the checks
+
+int main(int, char**) {
+    // Discard the console output of the games themselves.
+    std::streambuf* const p_stdout = std::cout.rdbuf(NULL);
+
+    int failure_cnt = 0;
+    ::report("canceled suggestion", ::test_canceled_suggestion(), failure_cnt);
+    ::report("seek turn", ::test_seek_turn(), failure_cnt);
+    ::report("binary round trip", ::test_binary_round_trip(), failure_cnt);
+
+    std::cout.rdbuf(p_stdout);
+
+    return failure_cnt;
+}
+
+#endif  // defined(_SELFTEST)
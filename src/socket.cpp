@@ -26,6 +26,7 @@ along with the Gold Tile Game.  If not, see <http://www.gnu.org/licenses/>.
 #include "network.hpp"
 
 #ifdef _POSIX
+# include <unistd.h>      // close
 namespace Posix {
 # include <errno.h>       // EWOULDBLOCK
 # include <netdb.h>
@@ -36,13 +37,15 @@ using Posix::getsockname;
 using Posix::recv;
 using Posix::send;
 using Posix::sockaddr;
-using Posix::u_long;
+typedef unsigned long u_long;
 typedef sockaddr SOCKADDR;
 typedef int SOCKET;
 SOCKET const INVALID_SOCKET = -1;
 int const SOCKET_ERROR = -1;
+int const SEND_FLAGS = Posix::MSG_NOSIGNAL;  // report EPIPE instead of raising SIGPIPE
 int const WSAECONNABORTED = ECONNABORTED;
 int const WSAECONNRESET = ECONNRESET;
+int const WSAESHUTDOWN = EPIPE;
 int const WSAEWOULDBLOCK = EWOULDBLOCK;
 # define closesocket close
 # define ioctlsocket Posix::ioctl
@@ -67,6 +70,7 @@ using Win::PSOCKADDR_IN;
 using Win::SOCKADDR;
 using Win::SOCKET;
 typedef int socklen_t;
+int const SEND_FLAGS = 0;
 #endif  // defined(_WINSOCK2)
 
 
@@ -84,6 +88,7 @@ Socket::Socket(void) {
     mpSocket = NULL;
 #else  // !defined(_QT)
     mpReadBuffer = NULL;
+    mpWriteBuffer = NULL;
     Invalidate();
 #endif  // !defined(_QT)
 
@@ -106,6 +111,7 @@ Socket::Socket(HandleType handle) {
 
     mHandle = handle;
     mpReadBuffer = new Fifo;
+    mpWriteBuffer = NULL;
 
     ASSERT(IsValid());
 }
@@ -134,9 +140,15 @@ void Socket::Close(void) {
 #ifdef _QT
     mpSocket->close();
 #else   // !defined(_QT)
-    SOCKET const socket = SOCKET(mHandle);
+    SOCKET const socket = SOCKET(intptr_t(mHandle));
     int failure = closesocket(socket);
     ASSERT(failure == 0);
+
+    // Any copies of the socket share the buffers, so they mustn't be used again.
+    delete mpReadBuffer;
+    mpReadBuffer = NULL;
+    delete mpWriteBuffer;
+    mpWriteBuffer = NULL;
 #endif  // defined(_QT)
 
     Invalidate();
@@ -144,6 +156,31 @@ void Socket::Close(void) {
     ASSERT(!IsValid());
 }
 
+#ifndef _QT
+// Count the complete lines which can be gotten without reading.
+SizeType Socket::CountLines(void) const {
+    ASSERT(IsValid());
+
+    SizeType const result = mpReadBuffer->CountLines();
+
+    return result;
+}
+
+// Send as much buffered data as the connection will take without waiting.
+// Return false if the connection was lost.
+bool Socket::Flush(void) {
+    ASSERT(IsValid());
+    ASSERT(mpWriteBuffer != NULL);
+
+    SizeType sent_cnt = 0;
+    bool const result = Send(TextType(*mpWriteBuffer), mpWriteBuffer->Length(),
+        sent_cnt, false);
+    mpWriteBuffer->erase(0, sent_cnt);
+
+    return result;
+}
+#endif  // !defined(_QT)
+
 // Return true if successful, false if canceled.
 bool Socket::GetCharacter(char& rCharacter) {
     ASSERT(IsValid());
@@ -157,7 +194,7 @@ bool Socket::GetCharacter(char& rCharacter) {
 #else   // !defined(_QT)
     bool was_successful = true;
     if (!HasBufferedData()) {
-        was_successful = Read();
+        was_successful = Read(true);
     }
     if (was_successful) {
         rCharacter = mpReadBuffer->GetByte();
@@ -186,7 +223,7 @@ bool Socket::GetLine(String& rString) {
     return was_successful;
 }
 
-// Return true if successful, false if canceled.
+// Return true if successful, false if canceled or too long.
 bool Socket::GetParagraph(String& rString) {
     ASSERT(IsValid());
 
@@ -199,6 +236,10 @@ bool Socket::GetParagraph(String& rString) {
             break;
         }
         rString += line + "\n";
+        if (rString.Length() > PARAGRAPH_LENGTH_MAX) {
+            was_successful = false;
+            break;
+        }
     }
 
     return was_successful;
@@ -223,7 +264,7 @@ Address Socket::Local(void) const {
     QHostAddress const address = mpSocket->localAddress();
     Address const result(address);
 #else  // !defined(_QT)
-    SOCKET const socket = SOCKET(mHandle);
+    SOCKET const socket = SOCKET(intptr_t(mHandle));
     SOCKADDR sockaddr[2];  // a single SOCKADDR isn't sufficient??
     socklen_t length = sizeof(sockaddr);
     int const failure = getsockname(socket, sockaddr, &length);
@@ -234,11 +275,22 @@ Address Socket::Local(void) const {
     return result;
 }
 
+#ifndef _QT
+// Have Put() keep whatever the connection won't take right away.
+void Socket::MakeBuffered(void) {
+    ASSERT(IsValid());
+
+    if (mpWriteBuffer == NULL) {
+        mpWriteBuffer = new String;
+    }
+}
+#endif  // !defined(_QT)
+
 void Socket::MakeNonblocking(void) {
     ASSERT(IsValid());
 
 #ifndef _QT
-    SOCKET const socket = SOCKET(mHandle);
+    SOCKET const socket = SOCKET(intptr_t(mHandle));
     u_long non_blocking = 1;
     int const failure = ioctlsocket(socket, FIONBIO, &non_blocking);
     ASSERT(failure == 0);
@@ -255,7 +307,7 @@ Address Socket::Peer(void) const {
     ASSERT(address != QHostAddress::Null);
     Address const result(address);
 #else  // !defined(_QT)
-    SOCKET const socket = SOCKET(mHandle);
+    SOCKET const socket = SOCKET(intptr_t(mHandle));
     SOCKADDR sockaddr[2]; // a single SOCKADDR isn't sufficient??
     socklen_t length = sizeof(sockaddr);
     int const failure = getpeername(socket, sockaddr, &length);
@@ -275,30 +327,21 @@ bool Socket::Put(String const& rString) {
     if (bytes_sent == -1) {
         FAIL();
     }
+    ASSERT(IsValid());
+    return true;
 #else  // !defined(_QT)
-    SOCKET const socket = SOCKET(mHandle);
-    char const* const p_buffer = TextType(rString);
-    SizeType const buffer_size = rString.Length();
-    int const no_flags = 0;
-    int const bytes_sent = send(socket, p_buffer, buffer_size, no_flags);
-    if (bytes_sent == SOCKET_ERROR) {
-        int const error_code = Network::ErrorCode();
-        if (error_code == WSAECONNRESET) {
-            Address const peer_address = Peer();
-            String const peer = peer_address;
-            String const error_message = String("Lost network connection to ")
-                + peer + " -- discovered while sending data.";
-            Network::Notice(error_message);
-            return false;
-        } else {
-            Network::Fail("send");
-        }
+    bool result = true;
+    if (mpWriteBuffer != NULL) {
+        // Queue the data, and send whatever the connection will take now.
+        *mpWriteBuffer += rString;
+        result = Flush();
+    } else {
+        SizeType sent_cnt = 0;
+        result = Send(TextType(rString), rString.Length(), sent_cnt, true);
     }
-    ASSERT(SizeType(bytes_sent) == buffer_size);
-#endif  // !defined(_QT)
 
-    ASSERT(IsValid());
-    return true;
+    return result;
+#endif  // !defined(_QT)
 }
 
 bool Socket::PutLine(String const& rLine) {
@@ -309,19 +352,25 @@ bool Socket::PutLine(String const& rLine) {
 }
 
 #ifndef _QT
-// Read some more network data into the FIFO buffer.
-// Return true if successful, false if canceled.
-bool Socket::Read(void) {
+/*
+Read some more network data into the FIFO buffer.  If no data have arrived,
+either wait for some or (if mayWait is false) return without reading.
+Return true if successful, false if canceled or the connection was lost.
+*/
+bool Socket::Read(bool mayWait) {
     ASSERT(IsValid());
 
-    SOCKET const socket = SOCKET(mHandle);
+    SOCKET const socket = SOCKET(intptr_t(mHandle));
 
     char* p_start = NULL;
     SizeType bytes_requested = 0;
     mpReadBuffer->PreReceive(p_start, bytes_requested);
-    ASSERT(bytes_requested > 0);
 
-    bool canceled = false;
+    // A line which fills the read buffer ends the connection.
+    bool canceled = (bytes_requested == 0);
+    if (canceled) {
+        Network::Notice("Network line too long -- connection dropped.");
+    }
     int bytes_received = 0;
     while (!canceled) {
         int const flags = 0;
@@ -334,26 +383,33 @@ bool Socket::Read(void) {
             || error_code == WSAECONNABORTED
             || error_code == WSAECONNRESET)
         {
-            Address const peer_address = Peer();
-            String const peer = peer_address;
-            String const error_message = String("Lost network connection to ")
-                + peer + " -- discovered while receiving data.";
+            // The peer's address may be gone along with the connection.
+            String const error_message
+                = "Lost network connection -- discovered while receiving data.";
             Network::Notice(error_message);
             canceled = true;
             continue;
         } else if (error_code == WSAEWOULDBLOCK) {
+            if (!mayWait) {
+                break;  // an event loop will call again once data arrive
+            }
             Yields(canceled);
             continue;
         } else {
-            Network::Fail("receive");
+            // A peer mustn't be able to stop the process.
+            String const error_message = "Unexpected socket error (code="
+                + String(error_code) + ") on receive -- connection dropped.";
+            Network::Notice(error_message);
+            canceled = true;
         }
     }
 
     bool const was_successful = !canceled;
     if (was_successful) {
-        ASSERT(bytes_received > 0);
-        mpReadBuffer->PostReceive(bytes_received);
-        ASSERT(HasBufferedData());
+        if (bytes_received > 0) {
+            mpReadBuffer->PostReceive(bytes_received);
+            ASSERT(HasBufferedData());
+        }
         ASSERT(IsValid());
     } else {
         Invalidate();
@@ -361,6 +417,59 @@ bool Socket::Read(void) {
 
     return was_successful;
 }
+
+/*
+Send data, retrying after a partial send.  When the connection won't take
+any more, either wait (invoking the yield callback) or, if mayWait is false,
+return with the count of the bytes sent so far.  Return false if the
+connection was lost.
+*/
+bool Socket::Send(
+    char const* pBuffer,
+    SizeType byteCnt,
+    SizeType& rSentCnt,
+    bool mayWait)
+{
+    ASSERT(IsValid());
+
+    SOCKET const socket = SOCKET(intptr_t(mHandle));
+    rSentCnt = 0;
+    bool canceled = false;
+    while (!canceled && rSentCnt < byteCnt) {
+        int const bytes_sent = send(socket, pBuffer + rSentCnt,
+            byteCnt - rSentCnt, SEND_FLAGS);
+        if (bytes_sent != SOCKET_ERROR) {
+            rSentCnt += SizeType(bytes_sent);
+            continue;
+        }
+        int const error_code = Network::ErrorCode();
+        if (error_code == WSAECONNABORTED
+         || error_code == WSAECONNRESET
+         || error_code == WSAESHUTDOWN)
+        {
+            // The peer's address is gone along with the connection.
+            String const error_message
+                = "Lost network connection -- discovered while sending data.";
+            Network::Notice(error_message);
+            canceled = true;
+        } else if (error_code == WSAEWOULDBLOCK) {
+            if (!mayWait) {
+                break;  // the caller will flush the rest later
+            }
+            Yields(canceled);
+        } else {
+            // A peer mustn't be able to stop the process.
+            String const error_message = "Unexpected socket error (code="
+                + String(error_code) + ") on send -- connection dropped.";
+            Network::Notice(error_message);
+            canceled = true;
+        }
+    }
+
+    bool const was_successful = !canceled;
+
+    return was_successful;
+}
 #endif  // !defined(_QT)
 
 // Set up a callback to be invoked when waiting for data from the network.
@@ -372,9 +481,12 @@ bool Socket::Read(void) {
     mspYieldFunction = pFunction;
 }
 
+// Wait briefly for the network, unless a callback wants the time.
 /* static */  void Socket::Yields(bool& rCanceled) {
     if (mspYieldFunction != NULL) {
         (*mspYieldFunction)(mspYieldArgument, rCanceled);
+    } else {
+        ::pause_milliseconds(YIELD_PAUSE_MSEC);
     }
 }
 
@@ -394,6 +506,17 @@ bool Socket::HasBufferedData(void) const {
     return result;
 }
 
+#ifndef _QT
+// Check whether a buffered socket holds data the connection hasn't yet taken.
+bool Socket::HasUnsentData(void) const {
+    ASSERT(IsValid());
+
+    bool const result = (mpWriteBuffer != NULL && !mpWriteBuffer->IsEmpty());
+
+    return result;
+}
+#endif  // !defined(_QT)
+
 bool Socket::IsValid(void) const {
 #ifdef _QT
     bool const result = (mpSocket != NULL);
@@ -31,7 +31,16 @@ a server which is capable of passing String objects back and forth
 using "get" and "put" operations.
 
 The Socket class is encapsulates a handle (Winsock socket) and a Fifo
-for incoming data.
+for incoming data.  A peer which sends a line too long for the Fifo,
+or a paragraph longer than PARAGRAPH_LENGTH_MAX, loses its connection,
+as does any peer whose connection reports a socket error, so that a
+peer can end its own game but never the process.
+
+Put() waits until the connection has taken all the data, unless the
+socket has been made buffered, in which case it sends whatever the
+connection will take and keeps the rest for Flush().  A buffered socket
+is meant for an event loop such as a Reactor, which flushes it once the
+connection becomes writable.  Copies of a socket share its buffers.
 */
 
 #include "string.hpp"  // USES String
@@ -45,6 +54,10 @@ public:
     typedef void* HandleType;  // cast to the native socket type
     typedef void  YieldFunctionType(void*, bool& cancel);
 
+    // public constants
+    static const SizeType PARAGRAPH_LENGTH_MAX = 0x10000;  // 64 KiB
+    static const MsecIntervalType YIELD_PAUSE_MSEC = 1;  // between polls when no yield callback
+
     // public lifecycle
     Socket(void);
 #ifdef _QT
@@ -61,18 +74,32 @@ public:
 
     // misc public methods
     void    Close(void);
+#ifndef _QT
+    SizeType
+            CountLines(void) const;  // complete lines buffered
+    bool    Flush(void);
+#endif  // !defined(_QT)
     bool    GetLine(String&);
     bool    GetParagraph(String&);
     void    Invalidate(void);
     Address Local(void) const;
+#ifndef _QT
+    void    MakeBuffered(void);
+#endif  // !defined(_QT)
     void    MakeNonblocking(void);
     Address Peer(void) const;
     bool    Put(String const&);
     bool    PutLine(String const&);
+#ifndef _QT
+    bool    Read(bool mayWait);
+#endif  // !defined(_QT)
     static void
             SetYield(YieldFunctionType*, void* arg);
 
     // public inquiry methods
+#ifndef _QT
+    bool HasUnsentData(void) const;
+#endif  // !defined(_QT)
     bool IsValid(void) const;
 
 private:
@@ -80,6 +107,7 @@ private:
 #ifndef _QT
     HandleType     mHandle;
     Fifo*         mpReadBuffer;
+    String*       mpWriteBuffer;  // unsent data of a buffered socket, else NULL
 #else  // defined(_QT)
     QTcpSocket*   mpSocket;
 #endif  // defined(_QT)
@@ -89,7 +117,9 @@ private:
 
     // misc private methods
     bool GetCharacter(char&);
-    bool Read(void);
+#ifndef _QT
+    bool Send(char const*, SizeType byteCnt, SizeType& rSentCnt, bool mayWait);
+#endif  // !defined(_QT)
     static void 
          Yields(bool& cancel);
 
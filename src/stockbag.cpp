@@ -0,0 +1,190 @@
+// File:     stockbag.cpp
+// Location: src
+// Purpose:  implement StockBag class
+// Author:   Stephen Gold sgold@sonic.net
+// (c) Copyright 2012 Stephen Gold
+// Distributed under the terms of the GNU General Public License
+
+/*
+This file is part of the Gold Tile Game.
+
+The Gold Tile Game is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by the
+Free Software Foundation, either version 3 of the License, or (at your
+option) any later version.
+
+The Gold Tile Game is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with the Gold Tile Game.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "random.hpp"
+#include "stockbag.hpp"
+
+
+// lifecycle
+
+StockBag::StockBag(void) {
+}
+
+// The implicitly defined copy constructor is fine.
+
+StockBag::StockBag(Tiles const& rTiles) {
+    Merge(rTiles);
+}
+
+// The implicitly defined destructor is fine.
+
+
+// operators
+
+// The implicitly defined assignment method is fine.
+
+StockBag::operator String(void) const {
+    Tiles const tiles = *this;
+    String const result = tiles;
+
+    return result;
+}
+
+StockBag::operator Tiles(void) const {
+    Tiles result;
+
+    std::vector<Tile::IdType>::const_iterator i_id;
+    for (i_id = mIds.begin(); i_id != mIds.end(); i_id++) {
+        result.Add(*i_id);
+    }
+
+    return result;
+}
+
+
+// misc methods
+
+void StockBag::Add(Tile::IdType id) {
+    ASSERT(!Contains(id));
+
+    SetPosition(id, mIds.size());
+    mIds.push_back(id);
+
+    ASSERT(Contains(id));
+}
+
+SizeType StockBag::Count(void) const {
+    SizeType const result = SizeType(mIds.size());
+
+    return result;
+}
+
+void StockBag::Merge(Tiles const& rTiles) {
+    Tiles::ConstIterator i_tile;
+    for (i_tile = rTiles.begin(); i_tile != rTiles.end(); i_tile++) {
+        Tile::IdType const id = *i_tile;
+        Add(id);
+    }
+}
+
+// Look up the position of an ID in mIds.
+SizeType StockBag::Position(Tile::IdType id) const {
+    Positions const& r_positions = (id < 0) ? mNegativePositions : mPositivePositions;
+    SizeType const magnitude = SizeType((id < 0) ? -id : id);
+
+    SizeType result = POSITION_NONE;
+    if (magnitude < r_positions.size()) {
+        result = r_positions[magnitude];
+    }
+
+    return result;
+}
+
+Tile StockBag::PullRandomTile(Random& rRandom) {
+    ASSERT(!IsEmpty());
+
+    SizeType const n = Count();
+    SizeType const r = rRandom.Below(n);
+    Tile::IdType const id = mIds[r];
+    Remove(id);
+
+    ASSERT(Count() == n-1);
+    Tile const result = Tile(id);
+
+    return result;
+}
+
+Tiles StockBag::PullRandomTiles(SizeType tileCnt, Random& rRandom) {
+    Tiles result;
+
+    for (SizeType i_tile = 0; i_tile < tileCnt; i_tile++) {
+        if (IsEmpty()) {
+            break;
+        }
+        Tile const tile = PullRandomTile(rRandom);
+        result.Add(tile);
+    }
+
+    return result;
+}
+
+void StockBag::Purge(Tiles const& rTiles) {
+    ASSERT(Count() >= rTiles.Count());
+
+    Tiles::ConstIterator i_tile;
+    for (i_tile = rTiles.begin(); i_tile != rTiles.end(); i_tile++) {
+        Tile::IdType const id = *i_tile;
+        Remove(id);
+    }
+}
+
+// Move the last tile into the vacated position.
+void StockBag::Remove(Tile::IdType id) {
+    ASSERT(Contains(id));
+
+    SizeType const position = Position(id);
+    Tile::IdType const last_id = mIds.back();
+    mIds[position] = last_id;
+    SetPosition(last_id, position);
+    mIds.pop_back();
+    SetPosition(id, POSITION_NONE);
+
+    ASSERT(!Contains(id));
+}
+
+// Add copyCnt new tiles of every possible combination of attributes.
+void StockBag::Restock(SizeType copyCnt, Random& rRandom) {
+    Tile::IdType const first_id = Tile::MintAll(copyCnt, rRandom);
+    SizeType const tile_cnt = SizeType(copyCnt*Combo::CombinationCnt());
+
+    mIds.reserve(mIds.size() + tile_cnt);
+    for (SizeType i_tile = 0; i_tile < tile_cnt; i_tile++) {
+        Add(first_id + Tile::IdType(i_tile));
+    }
+}
+
+void StockBag::SetPosition(Tile::IdType id, SizeType position) {
+    Positions& r_positions = (id < 0) ? mNegativePositions : mPositivePositions;
+    SizeType const magnitude = SizeType((id < 0) ? -id : id);
+
+    if (magnitude >= r_positions.size()) {
+        r_positions.resize(magnitude + 1, SizeType(POSITION_NONE));
+    }
+    r_positions[magnitude] = position;
+}
+
+
+// inquiry methods
+
+bool StockBag::Contains(Tile::IdType id) const {
+    bool const result = (Position(id) != POSITION_NONE);
+
+    return result;
+}
+
+bool StockBag::IsEmpty(void) const {
+    bool const result = mIds.empty();
+
+    return result;
+}
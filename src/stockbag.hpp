@@ -0,0 +1,87 @@
+#ifndef STOCKBAG_HPP_INCLUDED
+#define STOCKBAG_HPP_INCLUDED
+
+// File:     stockbag.hpp
+// Location: src
+// Purpose:  declare StockBag class
+// Author:   Stephen Gold sgold@sonic.net
+// (c) Copyright 2012 Stephen Gold
+// Distributed under the terms of the GNU General Public License
+
+/*
+This file is part of the Gold Tile Game.
+
+The Gold Tile Game is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by the
+Free Software Foundation, either version 3 of the License, or (at your
+option) any later version.
+
+The Gold Tile Game is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with the Gold Tile Game.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/*
+A StockBag object represents the stock bag, from which tiles are drawn
+at random.
+
+The StockBag class is implemented as a vector of tile IDs in no particular
+order, plus an index from each ID to its position in the vector.  A tile
+is drawn by picking a random position and moving the last tile into the
+vacated position, so that drawing, adding, and removing a tile each take
+constant time.  Separate indices are kept for positive and negative
+(remote) IDs.
+*/
+
+#include <vector>       // HASA std::vector
+#include "tiles.hpp"    // USES Tiles
+
+class StockBag {
+public:
+    // public lifecycle
+    StockBag(void);
+    // StockBag(StockBag const&);  implicitly defined copy constructor
+    explicit StockBag(Tiles const&);
+    // ~StockBag(void);  implicitly defined destructor
+
+    // public operators
+    // StockBag& operator=(StockBag const&);  implicitly defined assignment method
+    operator String(void) const;  // same format as Tiles
+    operator Tiles(void) const;
+
+    // misc public methods
+    void     Add(Tile::IdType);
+    SizeType Count(void) const;
+    void     Merge(Tiles const&);
+    Tile     PullRandomTile(Random&);
+    Tiles    PullRandomTiles(SizeType, Random&);
+    void     Purge(Tiles const&);
+    void     Remove(Tile::IdType);
+    void     Restock(SizeType copyCnt, Random&);
+
+    // public inquiry methods
+    bool Contains(Tile::IdType) const;
+    bool IsEmpty(void) const;
+
+private:
+    // private types
+    typedef std::vector<SizeType> Positions;
+
+    // private constants
+    static const SizeType POSITION_NONE = UINT32_MAX;
+
+    // private data
+    std::vector<Tile::IdType> mIds;  // the tiles in the bag, in no particular order
+    Positions mNegativePositions;    // position of each negative ID in mIds, indexed by magnitude
+    Positions mPositivePositions;    // position of each positive ID in mIds
+
+    // misc private methods
+    SizeType Position(Tile::IdType) const;
+    void     SetPosition(Tile::IdType, SizeType);
+};
+#endif  // !defined(STOCKBAG_HPP_INCLUDED)
@@ -330,8 +330,8 @@ String String::Suffix(String const& rPrefix) const {
 // inquiry methods
 
 bool String::Contains(char character) const {
-    SizeType const position = SizeType(find(character));
-    bool const result = (position != npos);
+    // Compare before narrowing, since npos doesn't fit in a SizeType.
+    bool const result = (find(character) != npos);
 
     return result;
 }
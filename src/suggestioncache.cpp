@@ -0,0 +1,78 @@
+// File:     suggestioncache.cpp
+// Location: src
+// Purpose:  implement SuggestionCache class
+// Author:   Stephen Gold sgold@sonic.net
+// (c) Copyright 2012 Stephen Gold
+// Distributed under the terms of the GNU General Public License
+
+/*
+This file is part of the Gold Tile Game.
+
+The Gold Tile Game is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by the
+Free Software Foundation, either version 3 of the License, or (at your
+option) any later version.
+
+The Gold Tile Game is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with the Gold Tile Game.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "suggestioncache.hpp"
+
+
+// lifecycle
+
+SuggestionCache::SuggestionCache(void) {
+}
+
+// The implicitly defined destructor is fine.
+
+
+// misc methods
+
+void SuggestionCache::Add(String const& rKey, Move const& rMove) {
+    EntryMap::iterator const i_map = mMap.find(rKey);
+    if (i_map != mMap.end()) {
+        mEntries.erase(i_map->second);
+        mMap.erase(i_map);
+    }
+
+    mEntries.push_front(Entry(rKey, rMove));
+    mMap[rKey] = mEntries.begin();
+
+    // Discard the least recently used entry, if necessary.
+    if (mEntries.size() > CAPACITY) {
+        String const last_key = mEntries.back().first;
+        mMap.erase(last_key);
+        mEntries.pop_back();
+    }
+
+    ASSERT(Count() <= CAPACITY);
+    ASSERT(mMap.size() == mEntries.size());
+}
+
+SizeType SuggestionCache::Count(void) const {
+    SizeType const result = SizeType(mEntries.size());
+
+    return result;
+}
+
+// If found, the entry becomes the most recently used.
+bool SuggestionCache::Find(String const& rKey, Move& rMove) {
+    bool result = false;
+
+    EntryMap::iterator const i_map = mMap.find(rKey);
+    if (i_map != mMap.end()) {
+        EntryList::iterator const i_entry = i_map->second;
+        mEntries.splice(mEntries.begin(), mEntries, i_entry);
+        rMove = i_entry->second;
+        result = true;
+    }
+
+    return result;
+}
@@ -0,0 +1,77 @@
+#ifndef SUGGESTIONCACHE_HPP_INCLUDED
+#define SUGGESTIONCACHE_HPP_INCLUDED
+
+// File:     suggestioncache.hpp
+// Location: src
+// Purpose:  declare SuggestionCache class
+// Author:   Stephen Gold sgold@sonic.net
+// (c) Copyright 2012 Stephen Gold
+// Distributed under the terms of the GNU General Public License
+
+/*
+This file is part of the Gold Tile Game.
+
+The Gold Tile Game is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by the
+Free Software Foundation, either version 3 of the License, or (at your
+option) any later version.
+
+The Gold Tile Game is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with the Gold Tile Game.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+A SuggestionCache object represents the results of recent searches
+performed by Partial::Suggest(), so that repeated requests for the same
+suggestion needn't repeat the search.  Each key identifies the whole
+situation, so entries remain valid across turns, undo, and redo, and
+needn't be invalidated.
+
+The SuggestionCache class encapsulates a list of (key, move) pairs,
+ordered from most recently used to least recently used, and a map from
+each key to its position in the list.  When the cache is full, the least
+recently used entry is discarded.
+*/
+
+#include <list>         // HASA std::list
+#include <map>          // HASA std::map
+#include "move.hpp"     // HASA Move
+#include "string.hpp"   // HASA String
+
+class SuggestionCache {
+public:
+    // public constants
+    static const SizeType CAPACITY = 64;
+
+    // public lifecycle
+    SuggestionCache(void);
+    // ~SuggestionCache(void);  implicitly defined destructor
+
+    // misc public methods
+    void     Add(String const& key, Move const&);
+    SizeType Count(void) const;
+    bool     Find(String const& key, Move&);
+
+private:
+    // private types
+    typedef std::pair<String,Move>    Entry;
+    typedef std::list<Entry>          EntryList;
+    typedef std::map<String,EntryList::iterator>
+                                      EntryMap;
+
+    // private data
+    EntryList mEntries;  // most recently used first
+    EntryMap  mMap;      // key to position in mEntries
+
+    // private lifecycle
+    SuggestionCache(SuggestionCache const&);  // not copyable
+
+    // private operators
+    SuggestionCache& operator=(SuggestionCache const&);  // not assignable
+};
+#endif  // !defined(SUGGESTIONCACHE_HPP_INCLUDED)
@@ -23,9 +23,11 @@ along with the Gold Tile Game.  If not, see <http://www.gnu.org/licenses/>.
 */
 
 #include <iostream>    // std::cin
+#include "gamecontext.hpp"
 #include "gameopt.hpp"
 #include "strings.hpp"
 #include "tiles.hpp"
+#include "workers.hpp"
 
 
 // static constants
@@ -33,18 +35,16 @@ along with the Gold Tile Game.  If not, see <http://www.gnu.org/licenses/>.
 const String Tile::SEPARATOR(":");
 
 
-// static data
-
-Fraction     Tile::msBonusProbability = 0.0; // configured by SetStatic()
-Tile::IdType Tile::msNextId = ID_FIRST;
-Tile::Map    Tile::msOpts;
-
-
 // lifecycle
 
 Tile::Tile(void) {
     mId = ID_DEFAULT; // special ID generated *only* by this constructor
-    msOpts[mId] = TileOpt();
+
+    // Look before storing, so that default construction
+    // does not write to the table once the entry exists.
+    if (!IsStored(mId)) {
+        Store(mId, TileOpt());
+    }
 
     ASSERT(!IsValid(mId));
 }
@@ -63,13 +63,13 @@ Tile::Tile(String const& rString, bool remoteFlag) {
 
     String const second = parts.Second();
     TileOpt const opt = TileOpt(second);
-    msOpts[id] = opt;
+    Store(id, opt);
 }
 
 // Mint a new tile based on a TileOpt.
 Tile::Tile(TileOpt const& rOpt) {
     mId = NextId();
-    msOpts[mId] = rOpt;
+    Store(mId, rOpt);
 }
 
 Tile::Tile(IdType id, bool remoteFlag) {
@@ -80,6 +80,18 @@ Tile::Tile(IdType id, bool remoteFlag) {
     mId = id;
 }
 
+// Recreate a tile with a known ID, as when loading a saved game.
+Tile::Tile(IdType id, TileOpt const& rOpt) {
+    ASSERT(id >= ID_FIRST && id < ID_MAX);
+
+    GameContext& r_context = GameContext::Current();
+    if (id >= r_context.mNextId) {
+        r_context.mNextId = id + 1;
+    }
+    mId = id;
+    Store(id, rOpt);
+}
+
 // The implicitly defined copy constructor is fine.
 // The implicitly defined destructor is fine.
 
@@ -101,8 +113,8 @@ bool Tile::operator==(Tile const& rOther) const {
 }
 
 Tile::operator Combo(void) const {
-    TileOpt const& r_opt = msOpts[mId];
-    Combo const result = r_opt;
+    TileOpt const opt = Opt();
+    Combo const result = opt;
 
     return result;
 }
@@ -112,14 +124,14 @@ Tile::operator IndexType(void) const {
 }
 
 Tile::operator String(void) const {
-    TileOpt const& r_opt = msOpts[mId];
-    String const result = String(mId) + SEPARATOR + String(r_opt);
+    TileOpt const opt = Opt();
+    String const result = String(mId) + SEPARATOR + String(opt);
 
     return result;
 }
 
 Tile::operator TileOpt(void) const {
-    TileOpt const result = msOpts[mId];
+    TileOpt const result = Opt();
 
     return result;
 }
@@ -128,45 +140,82 @@ Tile::operator TileOpt(void) const {
 // misc methods
 
 AttrType Tile::Attr(AttrIndexType index) const {
-    TileOpt const& r_opt = msOpts[mId];
-    AttrType const result = r_opt.Attr(index);
+    ASSERT(index < Combo::AttrCnt());
+
+    AttrType const result = Attrs()[index];
 
     return result;
 }
 
-/* static */ Fraction Tile::BonusProbability(void) {
-    return msBonusProbability;
+// Locate the attributes of this tile in the table.
+AttrType const* Tile::Attrs(void) const {
+    ASSERT(IsStored(mId));
+
+    RegionType const region = Region(mId);
+    SizeType const slot = Slot(mId);
+    GameContext const& r_context = GameContext::Current();
+    AttrType const* const result = &r_context.mAttrs[region][slot*r_context.mAttrCnt];
+
+    return result;
 }
 
-// Create a clone (with a new ID) and randomize its bonus value.
-Tile Tile::CloneAndSetBonus(void) const {
-    // Create a Tile with a new ID.
-    Tile result(*this);
-    result.mId = NextId();
+/* static */ Fraction Tile::BonusProbability(void) {
+    return GameContext::Current().mBonusProbability;
+}
 
-    // Copy the visible options.
-    TileOpt& r_result_opt = msOpts[result.mId];
-    r_result_opt = msOpts[mId];
+Combo::IdType Tile::ComboId(void) const {
+    ASSERT(Combo::HasIds());
+    ASSERT(IsStored(mId));
 
-    // Randomize its bonus value.
-    bool const gets_bonus = msBonusProbability.RandomBool();
-    r_result_opt.SetBonus(gets_bonus);
+    RegionType const region = Region(mId);
+    SizeType const slot = Slot(mId);
+    Combo::IdType const result = GameContext::Current().mComboIds[region][slot];
 
     return result;
 }
 
 // Identify the common attribute of a compatible tile.
 AttrIndexType Tile::CommonAttr(Tile const& rOther) const {
-    TileOpt const& r_opt = msOpts[mId];
-    TileOpt const& r_other = msOpts[rOther.mId];
-    AttrIndexType const result = r_opt.CommonAttr(r_other);
+    ASSERT(IsCompatibleWith(&rOther));
+
+    AttrType const* const p_attrs = Attrs();
+    AttrType const* const p_other = rOther.Attrs();
+    AttrCntType const attr_cnt = Combo::AttrCnt();
 
+    AttrIndexType result = attr_cnt;
+    for (AttrIndexType i_attr = 0; i_attr < attr_cnt; i_attr++) {
+        if (p_attrs[i_attr] == p_other[i_attr]) {
+            result = i_attr;
+            break;
+        }
+    }
+
+    ASSERT(result < attr_cnt);
     return result;
 }
 
+// Configure the current context for a game, discarding any tiles in its table.
+/* static */ void Tile::Configure(GameOpt const& rGameOpt) {
+    Combo::Configure(rGameOpt);
+
+    GameContext& r_context = GameContext::Current();
+
+    Fraction const bonus_probability = rGameOpt.BonusPercent()/100.0;
+    r_context.mBonusProbability = bonus_probability;
+
+    r_context.mNextId = ID_FIRST;
+    for (unsigned i_region = 0; i_region < REGION_CNT; i_region++) {
+        r_context.mAttrs[i_region].clear();
+        r_context.mBonus[i_region].clear();
+        r_context.mComboIds[i_region].clear();
+        r_context.mPacked[i_region].clear();
+    }
+    Tile const default_tile;  // re-create the entry used by Tile(void)
+}
+
 String Tile::Description(void) const {
-    TileOpt const& r_opt = msOpts[mId];
-    String const result = r_opt.Description();
+    TileOpt const opt = Opt();
+    String const result = opt.Description();
 
     return result;
 }
@@ -209,44 +258,183 @@ Tile::IdType Tile::Id(void) const {
     return mId;
 }
 
+Combo::PackedType Tile::Packed(void) const {
+    ASSERT(Combo::CanPack());
+    ASSERT(IsStored(mId));
+
+    RegionType const region = Region(mId);
+    SizeType const slot = Slot(mId);
+    Combo::PackedType const result = GameContext::Current().mPacked[region][slot];
+
+    return result;
+}
+
+/*
+Mint copyCnt tiles of every combination of attributes, with consecutive
+IDs, writing directly into the table.  The combinations are minted in the
+same order as Combo::Id() numbers them, with the last attribute varying
+fastest, and the bonuses are drawn in ID order, so the deal depends only
+on the seed.
+Return the first ID.
+*/
+/* static */ Tile::IdType Tile::MintAll(SizeType copyCnt, Random& rRandom) {
+    GameContext& r_context = GameContext::Current();
+    SizeType const tile_cnt = SizeType(copyCnt*Combo::CombinationCnt());
+    IdType const first_id = r_context.mNextId;
+    ASSERT(tile_cnt < SizeType(ID_MAX - first_id));
+
+    if (tile_cnt > 0) {
+        r_context.mNextId = first_id + IdType(tile_cnt);
+
+        // Grow the table once.
+        SizeType const slot_cnt = Slot(r_context.mNextId - 1) + 1;
+        r_context.mAttrs[REGION_LOCAL].resize(slot_cnt*Combo::AttrCnt(), 0);
+        r_context.mBonus[REGION_LOCAL].resize(slot_cnt, false);
+        r_context.mComboIds[REGION_LOCAL].resize(slot_cnt, 0);
+        r_context.mPacked[REGION_LOCAL].resize(slot_cnt, 0);
+
+        // The bonuses come from the generator, so draw them in order.
+        for (IdType id = first_id; id < r_context.mNextId; id++) {
+            bool const gets_bonus = r_context.mBonusProbability.RandomBool(rRandom);
+            r_context.mBonus[REGION_LOCAL][Slot(id)] = gets_bonus;
+        }
+
+        // The attributes depend only on the ID, so fill them in parallel.
+        SizeType const chunk_cnt = (tile_cnt + MINT_CHUNK_SIZE - 1)/MINT_CHUNK_SIZE;
+        IdType first = first_id;
+        if (chunk_cnt > 1) {
+            Workers workers;
+            workers.Run(&MintChunk, &first, chunk_cnt);
+        } else {
+            MintChunk(&first, 0);
+        }
+    }
+
+    return first_id;
+}
+
+// Fill in the attributes of one chunk of the tiles minted by MintAll().
+/* static */ void Tile::MintChunk(void* pFirstId, SizeType chunk) {
+    GameContext& r_context = GameContext::Current();
+    IdType const first_id = *(IdType const*)pFirstId;
+    AttrCntType const attr_cnt = Combo::AttrCnt();
+    SizeType const combo_cnt = SizeType(Combo::CombinationCnt());
+    bool const can_pack = Combo::CanPack();
+    bool const has_ids = Combo::HasIds();
+
+    IdType const begin_id = first_id + IdType(chunk*MINT_CHUNK_SIZE);
+    IdType end_id = begin_id + IdType(MINT_CHUNK_SIZE);
+    if (end_id > r_context.mNextId) {
+        end_id = r_context.mNextId;
+    }
+
+    Combo combo;
+    for (IdType id = begin_id; id < end_id; id++) {
+        SizeType const slot = Slot(id);
+        AttrType* const p_attrs = &r_context.mAttrs[REGION_LOCAL][slot*attr_cnt];
+
+        // decode the combination, last attribute fastest
+        SizeType rest = SizeType(id - first_id) % combo_cnt;
+        for (AttrIndexType i_attr = attr_cnt; i_attr > 0; i_attr--) {
+            AttrType const value_cnt = Combo::ValueCnt(i_attr - 1);
+            AttrType const value = AttrType(rest % value_cnt);
+            combo.SetAttr(i_attr - 1, value);
+            p_attrs[i_attr - 1] = value;
+            rest /= value_cnt;
+        }
+
+        if (can_pack) {
+            r_context.mPacked[REGION_LOCAL][slot] = combo.Packed();
+        }
+        if (has_ids) {
+            r_context.mComboIds[REGION_LOCAL][slot] = combo.Id();
+        }
+    }
+}
+
 /* static */ Tile::IdType Tile::NextId(void) {
-    ASSERT(msNextId < ID_MAX);
+    GameContext& r_context = GameContext::Current();
+    ASSERT(r_context.mNextId < ID_MAX);
 
-    IdType const result = msNextId;
-    msNextId = result + 1;
+    IdType const result = r_context.mNextId;
+    r_context.mNextId = result + 1;
 
     ASSERT(IsValid(result));
     return result;
 }
 
-void Tile::SetAttr(AttrIndexType index, AttrType value) {
-    TileOpt& r_opt = msOpts[mId];
-    r_opt.SetAttr(index, value);
+// Gather the options of this tile from the table.
+TileOpt Tile::Opt(void) const {
+    AttrType const* const p_attrs = Attrs();
+
+    TileOpt result;
+    for (AttrIndexType i_attr = 0; i_attr < Combo::AttrCnt(); i_attr++) {
+        result.SetAttr(i_attr, p_attrs[i_attr]);
+    }
+    result.SetBonus(HasBonus());
+
+    return result;
+}
+
+/* static */ Tile::RegionType Tile::Region(IdType id) {
+    ASSERT(id != ID_NONE);
+
+    RegionType const result = (id < 0) ? REGION_REMOTE : REGION_LOCAL;
+
+    return result;
 }
 
-/* static */ void Tile::SetStatic(GameOpt const& rGameOpt) {
-    Combo::SetStatic(rGameOpt);
+// Index the table by the magnitude of the ID.
+/* static */ SizeType Tile::Slot(IdType id) {
+    ASSERT(id != ID_NONE);
 
-    Fraction const bonus_probability = rGameOpt.BonusPercent()/100.0;
-    msBonusProbability = bonus_probability;
+    SizeType const result = SizeType((id < 0) ? -id : id);
+
+    return result;
+}
+
+// Copy options into the table, growing it as needed.
+/* static */ void Tile::Store(IdType id, TileOpt const& rOpt) {
+    GameContext& r_context = GameContext::Current();
+    RegionType const region = Region(id);
+    SizeType const slot = Slot(id);
+    AttrCntType const attr_cnt = Combo::AttrCnt();
+
+    if (slot >= r_context.mBonus[region].size()) {
+        r_context.mAttrs[region].resize((slot + 1)*attr_cnt, 0);
+        r_context.mBonus[region].resize(slot + 1, false);
+        r_context.mComboIds[region].resize(slot + 1, 0);
+        r_context.mPacked[region].resize(slot + 1, 0);
+    }
 
-    msNextId = ID_FIRST;
-    msOpts.clear();
+    AttrType* const p_attrs = &r_context.mAttrs[region][slot*attr_cnt];
+    for (AttrIndexType i_attr = 0; i_attr < attr_cnt; i_attr++) {
+        p_attrs[i_attr] = rOpt.Attr(i_attr);
+    }
+    r_context.mBonus[region][slot] = rOpt.HasBonus();
+    if (Combo::HasIds()) {
+        r_context.mComboIds[region][slot] = rOpt.ComboId();
+    }
+    if (Combo::CanPack()) {
+        r_context.mPacked[region][slot] = rOpt.Packed();
+    }
 }
 
 
 // inquiry methods
 
 bool Tile::HasAttr(AttrIndexType index, AttrType value) const {
-    TileOpt const& r_opt = msOpts[mId];
-    bool const result = r_opt.HasAttr(index, value);
+    bool const result = (Attr(index) == value);
 
     return result;
 }
 
 bool Tile::HasBonus(void) const {
-    TileOpt const& r_opt = msOpts[mId];
-    bool const result = r_opt.HasBonus();
+    ASSERT(IsStored(mId));
+
+    RegionType const region = Region(mId);
+    SizeType const slot = Slot(mId);
+    bool const result = GameContext::Current().mBonus[region][slot];
 
     return result;
 }
@@ -259,15 +447,25 @@ bool Tile::HasId(IdType id) const {
 
 // Do the bonus value and all attributes match?
 bool Tile::HasOpt(TileOpt const& rOpt) const {
-    bool const result = (msOpts[mId] == rOpt);
+    bool result = (HasBonus() == rOpt.HasBonus());
+
+    AttrType const* const p_attrs = Attrs();
+    for (AttrIndexType i_attr = 0; result && i_attr < Combo::AttrCnt(); i_attr++) {
+        result = (p_attrs[i_attr] == rOpt.Attr(i_attr));
+    }
 
     return result;
 }
 
 // Same options but different ID?
 bool Tile::IsClone(Tile const& rOther) const {
-    TileOpt& r_other = msOpts[rOther.mId];
-    bool const result = (mId != rOther.mId && HasOpt(r_other));
+    bool result = (mId != rOther.mId && HasBonus() == rOther.HasBonus());
+
+    AttrType const* const p_attrs = Attrs();
+    AttrType const* const p_other = rOther.Attrs();
+    for (AttrIndexType i_attr = 0; result && i_attr < Combo::AttrCnt(); i_attr++) {
+        result = (p_attrs[i_attr] == p_other[i_attr]);
+    }
 
     return result;
 }
@@ -276,16 +474,55 @@ bool Tile::IsCompatibleWith(Tile const* pOther) const {
     bool result = true;
 
     if (pOther != NULL) {
-        TileOpt const& r_opt = msOpts[mId];
-        TileOpt const& r_other = msOpts[pOther->mId];
-        result = r_opt.IsCompatibleWith(r_other);
+        if (Combo::HasCompatibilityTable()) {
+            result = Combo::IsCompatibleId(ComboId(), pOther->ComboId());
+        } else if (Combo::CanPack()) {
+            result = Combo::IsCompatible(Packed(), pOther->Packed());
+        } else {
+            // compatible if exactly one attribute matches
+            AttrType const* const p_attrs = Attrs();
+            AttrType const* const p_other = pOther->Attrs();
+            AttrCntType match_cnt = 0;
+            for (AttrIndexType i_attr = 0; i_attr < Combo::AttrCnt(); i_attr++) {
+                if (p_attrs[i_attr] == p_other[i_attr]) {
+                    match_cnt++;
+                }
+            }
+            result = (match_cnt == 1);
+        }
     }
 
     return result;
 }
 
+/* static */ bool Tile::IsStored(IdType id) {
+    RegionType const region = Region(id);
+    SizeType const slot = Slot(id);
+    bool const result = (slot < GameContext::Current().mBonus[region].size());
+
+    return result;
+}
+
 /* static */ bool Tile::IsValid(Tile::IdType id) {
-    bool const result = (id <= -ID_FIRST || (id >= ID_FIRST && id < msNextId));
+    IdType const next_id = GameContext::Current().mNextId;
+    bool const result = (id <= -ID_FIRST || (id >= ID_FIRST && id < next_id));
+
+    return result;
+}
+
+// Check a save/send string before parsing it, since it may come from the network.
+/* static */ bool Tile::IsValid(String const& rString, bool remoteFlag) {
+    Strings const parts(rString, SEPARATOR);
+    bool result = (parts.Count() == 2);
+
+    if (result) {
+        String const first = parts.First();
+        IdType id = first;
+        if (remoteFlag) {
+            id = -id;
+        }
+        result = IsValid(id);
+    }
 
     return result;
 }
@@ -34,13 +34,17 @@ same number of attributes.  Distinct tiles with identical attributes
 (clones) are possible; a unique id is used to distinguish clones.
 In addition, some randomly-selected tiles are bonus tiles with extra value.
 
-The Tile class is implemented as a static container which maps IDs to
-tile options.  Individual tiles are represented by their IDs, which
-are positive for locally-generated tiles and negative for tiles
-generated by a remote client.
+The Tile class is implemented as a table of tile options, kept in the
+GameContext of the current game.
+Individual tiles are represented by their IDs, which are positive for
+locally-generated tiles and negative for tiles generated by a remote
+client.  The table is stored as dense arrays (one for attributes, one for
+bonus flags, one for packed attributes, and one for combo IDs) indexed
+by the magnitude of the ID, with separate arrays for each sign, so that
+looking up an option takes constant time.  Clones share a combo ID, which
+lets IsCompatibleWith() consult Combo's precomputed compatibility table.
 */
 
-#include <map>          // HASA std::map
 #include "indices.hpp"  // HASA IndexType
 #include "tileopt.hpp"  // HASA TileOpt
 
@@ -60,6 +64,7 @@ public:
     // public lifecycle
     Tile(void);
     Tile(IdType, bool remote = false);
+    Tile(IdType, TileOpt const&);
     // Tile(Tile const&);  implicitly defined copy constructor
     explicit Tile(TileOpt const&);
     explicit Tile(String const&, bool remote = false);
@@ -77,13 +82,15 @@ public:
     // misc public methods
     AttrType        Attr(AttrIndexType) const;
     static Fraction BonusProbability(void);
-    Tile            CloneAndSetBonus(void) const;
+    Combo::IdType   ComboId(void) const;
     AttrIndexType   CommonAttr(Tile const&) const;
+    static void     Configure(GameOpt const&);
     String          Description(void) const;
     String          GetUserChoice(Tiles const&, Strings const&);
     IdType          Id(void) const;
-    void            SetAttr(AttrIndexType, AttrType);
-    static void     SetStatic(GameOpt const&);
+    static IdType   MintAll(SizeType copyCnt, Random&);
+    Combo::PackedType
+                    Packed(void) const;
 
     // public inquiry methods
     bool HasAttr(AttrIndexType, AttrType) const;
@@ -94,24 +101,34 @@ public:
     bool IsCompatibleWith(Tile const*) const;
     static bool 
          IsValid(IdType);
+    static bool 
+         IsValid(String const&, bool remote);
 
 private:
     // private types
-    typedef std::map<IdType,TileOpt> 
-                                Map; 
-    typedef Map::const_iterator ConstIterator;
-    typedef Map::iterator       Iterator;
+    enum RegionType {
+        REGION_LOCAL,   // positive IDs
+        REGION_REMOTE,  // negative IDs
+        REGION_CNT
+    };
 
     // private constants
+    static const SizeType MINT_CHUNK_SIZE = 16384;  // tiles per job in MintAll()
     static const String SEPARATOR;
 
     // private data
-    static Fraction msBonusProbability; // configured by SetStatic()
-    IdType           mId;
-    static IdType   msNextId;
-    static Map      msOpts;
+    IdType mId;
 
     // misc private methods
-    static IdType NextId(void);
+    AttrType const*   Attrs(void) const;
+    static void       MintChunk(void* pFirstId, SizeType chunk);
+    static IdType     NextId(void);
+    TileOpt           Opt(void) const;
+    static RegionType Region(IdType);
+    static SizeType   Slot(IdType);
+    static void       Store(IdType, TileOpt const&);
+
+    // private inquiry methods
+    static bool IsStored(IdType);
 };
 #endif // !defined(TILE_HPP_INCLUDED)
@@ -160,3 +160,21 @@ bool TileCell::IsSwap(void) const {
     return mSwapFlag;
 }
 
+// Check a save/send string before parsing it, since it may come from the network.
+/* static */ bool TileCell::IsValid(String const& rString, bool remoteFlag) {
+    Strings const parts(rString, SEPARATOR);
+    bool result = (parts.Count() == 2);
+
+    if (result) {
+        String const first = parts.First();
+        Tile::IdType id = first;
+        if (remoteFlag) {
+            id = -id;
+        }
+        String const second = parts.Second();
+        result = Tile::IsValid(id) && (second == SWAP || Cell::IsValid(second));
+    }
+
+    return result;
+}
+
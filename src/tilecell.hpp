@@ -57,7 +57,8 @@ public:
     String GetUserChoice(Tiles const&, Strings const&);
 
     // public inquiry methods
-    bool IsSwap(void) const;
+    bool        IsSwap(void) const;
+    static bool IsValid(String const&, bool remote);
 
 private:
     // private constants
@@ -0,0 +1,240 @@
+// File:     tileids.cpp
+// Location: src
+// Purpose:  implement TileIds class
+// Author:   Stephen Gold sgold@sonic.net
+// (c) Copyright 2012 Stephen Gold
+// Distributed under the terms of the GNU General Public License
+
+/*
+This file is part of the Gold Tile Game.
+
+The Gold Tile Game is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by the
+Free Software Foundation, either version 3 of the License, or (at your
+option) any later version.
+
+The Gold Tile Game is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with the Gold Tile Game.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>    // binary_search, lower_bound
+#include "tileids.hpp"
+
+
+// lifecycle
+
+TileIds::TileIds(void) {
+    mCount = 0;
+    mIsSmall = true;
+}
+
+// The implicitly defined copy constructor is fine.
+
+TileIds::TileIds(Indices const& rIndices) {
+    mCount = 0;
+    mIsSmall = true;
+
+    Indices::ConstIterator i_index;
+    for (i_index = rIndices.begin(); i_index != rIndices.end(); i_index++) {
+        IndexType const index = *i_index;
+        Add(index);
+    }
+}
+
+// The implicitly defined destructor is fine.
+
+
+// operators
+
+// The implicitly defined assignment method is fine.
+
+// list the IDs in ascending order
+TileIds::operator Indices(void) const {
+    Indices result;
+
+    IndexType const* const p_ids = Begin();
+    for (SizeType i_id = 0; i_id < mCount; i_id++) {
+        result.Add(p_ids[i_id]);
+    }
+
+    ASSERT(result.Count() == mCount);
+    return result;
+}
+
+// same format as Indices
+TileIds::operator String(void) const {
+    Indices const indices = *this;
+    String const result = indices;
+
+    return result;
+}
+
+
+// misc methods
+
+void TileIds::Add(IndexType id) {
+    ASSERT(!Contains(id));
+
+    if (mIsSmall && mCount == SMALL_CNT_MAX) {
+        MakeLarge();
+    }
+
+    if (mIsSmall) {
+        // Shift larger IDs up to keep the array sorted.
+        SizeType i_small = mCount;
+        while (i_small > 0 && mSmall[i_small - 1] > id) {
+            mSmall[i_small] = mSmall[i_small - 1];
+            i_small--;
+        }
+        mSmall[i_small] = id;
+    } else {
+        std::vector<IndexType>::iterator const i_large
+            = std::lower_bound(mLarge.begin(), mLarge.end(), id);
+        mLarge.insert(i_large, id);
+    }
+    mCount++;
+
+    ASSERT(Contains(id));
+}
+
+void TileIds::AddRemove(IndexType id, bool addFlag) {
+    bool const have_id = Contains(id);
+
+    if (have_id && !addFlag) {
+        Remove(id);
+    } else if (!have_id && addFlag) {
+        Add(id);
+    }
+
+    ASSERT(addFlag == Contains(id));
+}
+
+// the sorted array of IDs, wherever it is kept
+IndexType const* TileIds::Begin(void) const {
+    IndexType const* p_result = mSmall;
+    if (!mIsSmall) {
+        ASSERT(mLarge.size() == mCount);
+        p_result = &mLarge[0];
+    }
+
+    return p_result;
+}
+
+SizeType TileIds::Count(void) const {
+    return mCount;
+}
+
+IndexType TileIds::First(void) const {
+    ASSERT(!IsEmpty());
+
+    IndexType const result = Begin()[0];
+
+    return result;
+}
+
+IndexType TileIds::Last(void) const {
+    ASSERT(!IsEmpty());
+
+    IndexType const result = Begin()[mCount - 1];
+
+    return result;
+}
+
+void TileIds::MakeEmpty(void) {
+    mCount = 0;
+    mIsSmall = true;
+    mLarge.clear();
+
+    ASSERT(IsEmpty());
+}
+
+// Move the IDs from the object into the vector.
+void TileIds::MakeLarge(void) {
+    ASSERT(mIsSmall);
+
+    mLarge.assign(mSmall, mSmall + mCount);
+    mIsSmall = false;
+}
+
+// Move the IDs from the vector back into the object.
+void TileIds::MakeSmall(void) {
+    ASSERT(!mIsSmall);
+    ASSERT(mCount <= SMALL_CNT_MAX);
+
+    for (SizeType i_id = 0; i_id < mCount; i_id++) {
+        mSmall[i_id] = mLarge[i_id];
+    }
+    mLarge.clear();
+    mIsSmall = true;
+}
+
+void TileIds::Merge(TileIds const& rOther) {
+    SizeType const new_count = mCount + rOther.mCount;
+
+    IndexType const* const p_other = rOther.Begin();
+    for (SizeType i_id = 0; i_id < rOther.mCount; i_id++) {
+        Add(p_other[i_id]);
+    }
+
+    // the sets must have been disjoint
+    ASSERT(mCount == new_count);
+}
+
+void TileIds::Purge(TileIds const& rOther) {
+    ASSERT(Count() >= rOther.Count());
+    SizeType const new_count = mCount - rOther.mCount;
+
+    IndexType const* const p_other = rOther.Begin();
+    for (SizeType i_id = 0; i_id < rOther.mCount; i_id++) {
+        Remove(p_other[i_id]);
+    }
+
+    // every purged ID must have been present
+    ASSERT(mCount == new_count);
+}
+
+void TileIds::Remove(IndexType id) {
+    ASSERT(Contains(id));
+
+    if (mIsSmall) {
+        SizeType i_small = 0;
+        while (mSmall[i_small] != id) {
+            i_small++;
+        }
+        for (; i_small + 1 < mCount; i_small++) {
+            mSmall[i_small] = mSmall[i_small + 1];
+        }
+    } else {
+        std::vector<IndexType>::iterator const i_large
+            = std::lower_bound(mLarge.begin(), mLarge.end(), id);
+        mLarge.erase(i_large);
+    }
+    mCount--;
+
+    if (!mIsSmall && mCount <= SMALL_CNT_MAX) {
+        MakeSmall();
+    }
+
+    ASSERT(!Contains(id));
+}
+
+
+// inquiry methods
+
+bool TileIds::Contains(IndexType id) const {
+    IndexType const* const p_ids = Begin();
+    bool const result = std::binary_search(p_ids, p_ids + mCount, id);
+
+    return result;
+}
+
+bool TileIds::IsEmpty(void) const {
+    bool const result = (mCount == 0);
+
+    return result;
+}
@@ -0,0 +1,86 @@
+#ifndef TILEIDS_HPP_INCLUDED
+#define TILEIDS_HPP_INCLUDED
+
+// File:     tileids.hpp
+// Location: src
+// Purpose:  declare TileIds class
+// Author:   Stephen Gold sgold@sonic.net
+// (c) Copyright 2012 Stephen Gold
+// Distributed under the terms of the GNU General Public License
+
+/*
+This file is part of the Gold Tile Game.
+
+The Gold Tile Game is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by the
+Free Software Foundation, either version 3 of the License, or (at your
+option) any later version.
+
+The Gold Tile Game is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with the Gold Tile Game.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+A TileIds object represents a set of tile IDs.  It offers the same
+methods as the Indices class, and it converts to and from Indices,
+so either may be used where only those methods are needed.
+
+The TileIds class keeps its IDs in ascending order in a single array.
+A set of up to SMALL_CNT_MAX IDs (such as a swap or the tiles of a
+move) is kept inside the object, without any heap allocation.  A larger
+set spills into a std::vector, and moves back inside the object when
+it shrinks again.  Lookups use binary search.
+*/
+
+#include <vector>       // HASA std::vector
+#include "indices.hpp"  // HASA IndexType
+
+class TileIds {
+public:
+    // public constants
+    static const SizeType SMALL_CNT_MAX = 8;
+
+    // public lifecycle
+    TileIds(void);
+    // TileIds(TileIds const&);  implicitly defined copy constructor
+    explicit TileIds(Indices const&);
+    // ~TileIds(void);  implicitly defined destructor
+
+    // public operators
+    // TileIds& operator=(TileIds const&);  implicitly defined assignment method
+    operator Indices(void) const;
+    operator String(void) const;
+
+    // misc public methods
+    void      Add(IndexType);
+    void      AddRemove(IndexType, bool);
+    SizeType  Count(void) const;
+    IndexType First(void) const;
+    IndexType Last(void) const;
+    void      MakeEmpty(void);
+    void      Merge(TileIds const&);
+    void      Purge(TileIds const&);
+    void      Remove(IndexType);
+
+    // public inquiry methods
+    bool Contains(IndexType) const;
+    bool IsEmpty(void) const;
+
+private:
+    // private data
+    SizeType               mCount;                 // number of IDs in the set
+    bool                   mIsSmall;               // true if using mSmall, false if using mLarge
+    std::vector<IndexType> mLarge;                 // sorted IDs, unless mIsSmall
+    IndexType              mSmall[SMALL_CNT_MAX];  // sorted IDs, if mIsSmall
+
+    // misc private methods
+    IndexType const* Begin(void) const;
+    void             MakeLarge(void);
+    void             MakeSmall(void);
+};
+#endif  // !defined(TILEIDS_HPP_INCLUDED)
@@ -81,6 +81,12 @@ AttrType TileOpt::Attr(AttrIndexType index) const {
     return result;
 }
 
+Combo::IdType TileOpt::ComboId(void) const {
+    Combo::IdType const result = mCombo.Id();
+
+    return result;
+}
+
 AttrIndexType TileOpt::CommonAttr(TileOpt const& rOther) const {
     AttrIndexType const result = mCombo.CommonAttr(rOther.mCombo);
 
@@ -116,6 +122,12 @@ String TileOpt::Description(void) const {
     return result;
 }
 
+Combo::PackedType TileOpt::Packed(void) const {
+    Combo::PackedType const result = mCombo.Packed();
+
+    return result;
+}
+
 void TileOpt::SetAttr(AttrIndexType index, AttrType value) {
     mCombo.SetAttr(index, value);
 }
@@ -138,7 +150,7 @@ bool TileOpt::HasBonus(void) const {
 }
 
 bool TileOpt::IsCompatibleWith(TileOpt const& rOther) const {
-    bool const result = mCombo.IsCompatibleWith(rOther);
+    bool const result = mCombo.IsCompatibleWith(rOther.mCombo);
 
     return result;
 }
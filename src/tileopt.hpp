@@ -37,6 +37,9 @@ with Combo (for the attributes).
 
 class TileOpt {
 public:
+    // public constants
+    static const char BONUS_CHARACTER = '+';  // suffix of a bonus tile's string
+
     // public lifecycle
     TileOpt(void);
     explicit TileOpt(String const&);
@@ -51,10 +54,13 @@ public:
 
     // misc public methods
     AttrType       Attr(AttrIndexType) const;
+    Combo::IdType  ComboId(void) const;
     AttrIndexType  CommonAttr(TileOpt const&) const;
     AttrCntType    CountMatchingAttrs(TileOpt const&) const;
     String         Description(void) const;
     static TileOpt FromDescription(String const&);
+    Combo::PackedType
+                   Packed(void) const;
     void           SetAttr(AttrIndexType, AttrType);
     void           SetBonus(bool);
 
@@ -65,9 +71,6 @@ public:
     bool MatchesDescription(String const&) const;
 
 private:
-    // private constants
-    static const char BONUS_CHARACTER = '+';
-
     // private data
     Combo mCombo;    // all attributes
     bool  mHasBonus;
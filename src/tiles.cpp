@@ -22,8 +22,8 @@ You should have received a copy of the GNU General Public License
 along with the Gold Tile Game.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <algorithm>  // std::sort
 #include <iostream>
-#include <stdlib.h>
 #include "strings.hpp"
 #include "tiles.hpp"
 
@@ -106,22 +106,6 @@ void Tiles::Add(Tile::IdType id) {
     Indices::Add(id);
 }
 
-// generate tiles for the stock bag - RECURSIVE
-void Tiles::AddAllTiles(AttrIndexType attributeIndex, Tile& rModelTile) {
-    AttrCntType const na = Combo::AttrCnt();
-    if (attributeIndex < na) {
-        AttrType const max = Combo::ValueMax(attributeIndex);
-        for (AttrType attr = 0; attr <= max; attr++) {
-            rModelTile.SetAttr(attributeIndex, attr);
-            AddAllTiles(attributeIndex + 1, rModelTile);
-        }
-    } else {
-        ASSERT(attributeIndex == na);
-        Tile const clone = rModelTile.CloneAndSetBonus();
-        Add(clone);
-    }
-}
-
 ScoreType Tiles::BonusFactor(void) const {
     ScoreType result = 1;
 
@@ -137,26 +121,54 @@ ScoreType Tiles::BonusFactor(void) const {
     return result;
 }
 
-// construct "runs":  subsets of mutually-compatible tiles - RECURSIVE
-void Tiles::BuildRuns(Tiles const& rRunSoFar, Tiles& rLongestRun) const {
-    if (IsEmpty()) {
-        if (rRunSoFar.Count() > rLongestRun.Count()) {
-            rLongestRun = rRunSoFar;
+/*
+RECURSIVE
+Find a maximum clique in the graph of compatible tiles, whose vertices
+are positions in a list of tiles.  Each call decides the first of the
+remaining candidates:  first leaving it out, then adding it to the run
+and keeping only the candidates compatible with it.  A branch is
+abandoned as soon as it can no longer produce a run longer than the
+best found so far.
+*/
+/* static */ void Tiles::BuildCliques(
+    Graph const& rCompatible,
+    Bitset const& rCandidates,
+    Positions& rRun,
+    Positions& rLongestRun)
+{
+    SizeType const word_cnt = SizeType(rCandidates.size());
+    SizeType candidate_cnt = 0;
+    SizeType first = 0;  // lowest-numbered candidate
+    for (SizeType i_word = word_cnt; i_word > 0; i_word--) {
+        WordType const word = rCandidates[i_word - 1];
+        if (word != 0) {
+            candidate_cnt += ::count_bits(word);
+            first = (i_word - 1)*WORD_BIT_CNT + ::count_bits((word & (0 - word)) - 1);
         }
-    } else {
-        Tiles run(rRunSoFar);
-        Tiles remainder(*this);
-        Tile const first = remainder.PullFirstTile();
+    }
+
+    if (rRun.size() + candidate_cnt <= rLongestRun.size()) {
+        return;
+    }
+    if (candidate_cnt == 0) {
+        rLongestRun = rRun;
+        return;
+    }
 
-        // build runs without the first tile
-        remainder.BuildRuns(run, rLongestRun);
+    // build runs without the first candidate
+    Bitset without = rCandidates;
+    without[first/WORD_BIT_CNT] &= ~(WordType(1) << (first % WORD_BIT_CNT));
+    BuildCliques(rCompatible, without, rRun, rLongestRun);
 
-        if (run.AreAllCompatibleWith(first)) {
-            // build runs with the first tile
-            run.Add(first);
-            remainder.BuildRuns(run, rLongestRun);
-        }
+    // build runs with the first candidate
+    Bitset const& r_compatible = rCompatible[first];
+    Bitset with(word_cnt);
+    for (SizeType i_word = 0; i_word < word_cnt; i_word++) {
+        with[i_word] = without[i_word] & r_compatible[i_word];
     }
+    rRun.push_back(first);
+    BuildCliques(rCompatible, with, rRun, rLongestRun);
+    rRun.pop_back();
 }
 
 AttrIndexType Tiles::CommonAttr(void) const {
@@ -214,72 +226,122 @@ Tile::IdType Tiles::FindFirst(TileOpt const& rTileOpt) const {
 }
 
 
-// return the largest subset of mutually compatible tiles
+/*
+Find the longest run of the unique tiles.
+
+In a two-attribute game, the tiles of any run longer than one share
+a value of one attribute, so the longest run is the largest group of
+tiles with a common value, taking one tile per combination.  That takes
+linear time.  With more attributes, the longest run is a maximum clique
+of the compatibility graph, found by BuildCliques().
+
+Either way, ties are broken in favor of the run which omits the earliest
+tiles, so both methods choose the same run.
+*/
 Tiles Tiles::LongestRun(void) const {
     // clones are never compatible, so consider only the unique tiles
     Tiles const unique = UniqueTiles();
+    std::vector<Tile> tiles;
+    ConstIterator i_tile;
+    for (i_tile = unique.begin(); i_tile != unique.end(); i_tile++) {
+        tiles.push_back(Tile(*i_tile));
+    }
+    SizeType const tile_cnt = SizeType(tiles.size());
+
+    Positions longest_run;
+    if (Combo::AttrCnt() == 2) {
+        longest_run = LongestGroup(tiles);
+    } else {
+        SizeType const word_cnt = (tile_cnt + WORD_BIT_CNT - 1)/WORD_BIT_CNT;
+        Graph compatible(tile_cnt, Bitset(word_cnt, 0));
+        Bitset candidates(word_cnt, 0);
+        for (SizeType i_first = 0; i_first < tile_cnt; i_first++) {
+            WordType const bit = WordType(1) << (i_first % WORD_BIT_CNT);
+            candidates[i_first/WORD_BIT_CNT] |= bit;
+            for (SizeType i_second = 0; i_second < tile_cnt; i_second++) {
+                if (tiles[i_second].IsCompatibleWith(&tiles[i_first])) {
+                    compatible[i_second][i_first/WORD_BIT_CNT] |= bit;
+                }
+            }
+        }
+        Positions run;
+        BuildCliques(compatible, candidates, run, longest_run);
+    }
 
+    // convert positions back to tiles
     Tiles result;
-    Tiles const empty_run;
-    unique.BuildRuns(empty_run, result);
+    Positions::const_iterator i_position;
+    for (i_position = longest_run.begin(); i_position != longest_run.end(); i_position++) {
+        result.Add(tiles[*i_position]);
+    }
 
     ASSERT(result.AreAllCompatible());
     return result;
 }
 
-Tile Tiles::PullFirstTile(void) {
-    ASSERT(!IsEmpty());
-
-    Iterator const i_tile = begin();
-    ASSERT(i_tile != end());
-    Tile const result = *i_tile;
-    erase(i_tile);
-
-    return result;
-}
+/*
+For a two-attribute game, find the largest group of tiles which share
+a value of one attribute and differ in the other.  Where the same
+combination occurs more than once, the last occurrence is used.
+*/
+/* static */ Tiles::Positions Tiles::LongestGroup(std::vector<Tile> const& rTiles) {
+    ASSERT(Combo::AttrCnt() == 2);
 
-Tile Tiles::PullRandomTile(void) {
-    ASSERT(!IsEmpty());
+    SizeType const tile_cnt = SizeType(rTiles.size());
+    Positions result;
+    for (AttrIndexType i_shared = 0; i_shared < 2; i_shared++) {
+        AttrIndexType const i_other = 1 - i_shared;
+        for (AttrType value = 0; value <= Combo::ValueMax(i_shared); value++) {
+            Positions last(Combo::ValueCnt(i_other), tile_cnt);
+            for (SizeType position = 0; position < tile_cnt; position++) {
+                Tile const& r_tile = rTiles[position];
+                if (r_tile.HasAttr(i_shared, value)) {
+                    last[r_tile.Attr(i_other)] = position;
+                }
+            }
 
-    SizeType const n = Count();
-    ASSERT(n > 0);
-    SizeType const r = ::rand() % n;
+            Positions group;
+            Positions::const_iterator i_last;
+            for (i_last = last.begin(); i_last != last.end(); i_last++) {
+                if (*i_last < tile_cnt) {
+                    group.push_back(*i_last);
+                }
+            }
+            std::sort(group.begin(), group.end());
 
-    // find the "r"th tile in the bag
-    Iterator i_tile = begin();
-    ASSERT(i_tile != end());
-    for (SizeType i = 0; i < r; i++) {
-        i_tile++;
-        ASSERT(i_tile != end());
+            if (group.size() > result.size()
+             || (group.size() == result.size() && group > result)) {
+                result = group;
+            }
+        }
     }
 
-    Tile const result = *i_tile;
-    erase(i_tile);
-
-    ASSERT(Count() == n-1);
     return result;
 }
 
-Tiles Tiles::PullRandomTiles(SizeType tileCnt) {
-    Tiles result;
+// get the packed combos of the tiles, in order
+Tiles::PackedList Tiles::Packed(void) const {
+    PackedList result;
+    result.reserve(Count());
 
-    for (SizeType i_tile = 0; i_tile < tileCnt; i_tile++) {
-        if (IsEmpty()) {
-            break;
-        }
-        Tile const tile = PullRandomTile();
-        result.Add(tile);
+    ConstIterator i_tile;
+    for (i_tile = begin(); i_tile != end(); i_tile++) {
+        Tile const tile = *i_tile;
+        result.push_back(tile.Packed());
     }
 
     return result;
 }
 
-// Add one instance of every possible combination of attributes.
-void Tiles::Restock(void) {
-    AttrIndexType const attribute_index = 0;
-    Tile model_tile;
+Tile Tiles::PullFirstTile(void) {
+    ASSERT(!IsEmpty());
+
+    Iterator const i_tile = begin();
+    ASSERT(i_tile != end());
+    Tile const result = *i_tile;
+    erase(i_tile);
 
-    AddAllTiles(attribute_index, model_tile);
+    return result;
 }
 
 // return a new set containing only one instance of each clone
@@ -301,6 +363,17 @@ Tiles Tiles::UniqueTiles(void) const {
 // inquiry methods
 
 bool Tiles::AreAllCompatible(void) const {
+    if (Combo::CanPack()) {
+        PackedList const combos = Packed();
+        SizeType const cnt = SizeType(combos.size());
+        for (SizeType i = 0; i + 1 < cnt; i++) {
+            if (!Combo::AreAllCompatibleWith(combos[i], &combos[i + 1], cnt - i - 1)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
     ConstIterator i_tile;
     for (i_tile = begin(); i_tile != end(); i_tile++) {
         Tile const tile = *i_tile;
@@ -317,6 +390,15 @@ bool Tiles::AreAllCompatible(void) const {
 }
 
 bool Tiles::AreAllCompatibleWith(Tile const& rTile) const {
+    if (Combo::CanPack()) {
+        PackedList const combos = Packed();
+        SizeType const cnt = SizeType(combos.size());
+        Combo::PackedType const* const p_run = (cnt > 0) ? &combos[0] : NULL;
+        bool const result = Combo::AreAllCompatibleWith(rTile.Packed(), p_run, cnt);
+
+        return result;
+    }
+
     bool result = true;
 
     ConstIterator i_tile;
@@ -336,3 +418,35 @@ bool Tiles::ContainsOpt(TileOpt const& rTileOpt) const {
     return result;
 }
 
+/*
+Check a save/send string before parsing it, since it may come from the network.
+A remote peer mints its tiles with consecutive IDs, and parsing a remote tile
+grows the tile tables to fit its ID, so remote IDs are also bounded by the
+number of tiles.
+*/
+/* static */ bool Tiles::IsValid(String const& rString, bool remoteFlag) {
+    bool const has_prefix = rString.HasPrefix(PREFIX);
+    bool const has_suffix = rString.HasSuffix(SUFFIX);
+    bool result = (has_prefix && has_suffix);
+
+    if (result) {
+        String const body = rString.Suffix(PREFIX).Prefix(SUFFIX);
+        Strings const words(body, SEPARATOR);
+        Tile::IdType const id_end = Tile::ID_FIRST + Tile::IdType(words.Count());
+
+        Strings::ConstIterator i_word;
+        for (i_word = words.Begin(); i_word != words.End(); i_word++) {
+            String const word = *i_word;
+            Tile::IdType const id = long(word);  // the ID leads the word
+            if (!Tile::IsValid(word, remoteFlag)
+             || (remoteFlag && id >= id_end))
+            {
+                result = false;
+                break;
+            }
+        }
+    }
+
+    return result;
+}
+
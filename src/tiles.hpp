@@ -32,6 +32,7 @@ The Tiles class is implemented as a collection of tile IDs, using
 the Indices class as its base.
 */
 
+#include <vector>   // USES std::vector
 #include "tile.hpp" // USES Tile
 
 
@@ -51,7 +52,6 @@ public:
 
     // misc public methods
     void      Add(Tile::IdType);
-    void      AddAllTiles(AttrIndexType, Tile& model);
     ScoreType BonusFactor(void) const;
     AttrIndexType
               CommonAttr(void) const;
@@ -61,23 +61,33 @@ public:
               FindFirst(TileOpt const&) const;
     Tiles     LongestRun(void) const;
     Tile      PullFirstTile(void);
-    Tile      PullRandomTile(void);
-    Tiles     PullRandomTiles(SizeType);
-    void      Restock(void);
     Tiles     UniqueTiles(void) const;
 
     // public inquiry methods
-    bool AreAllCompatible(void) const;
-    bool AreAllCompatibleWith(Tile const&) const;
-    bool ContainsOpt(TileOpt const&) const;
+    bool        AreAllCompatible(void) const;
+    bool        AreAllCompatibleWith(Tile const&) const;
+    bool        ContainsOpt(TileOpt const&) const;
+    static bool IsValid(String const&, bool remote);
 
 private:
     // private constants
     static const String PREFIX;
     static const String SEPARATOR;
     static const String SUFFIX;
+    static const SizeType WORD_BIT_CNT = 64;  // bits per Bitset word
+
+    // private types
+    typedef uint64_t                       WordType;
+    typedef std::vector<WordType>          Bitset;  // one bit per position
+    typedef std::vector<Bitset>            Graph;   // one Bitset per position
+    typedef std::vector<Combo::PackedType> PackedList;
+    typedef std::vector<SizeType>          Positions;
 
     // private methods
-    void BuildRuns(Tiles const& runSoFar, Tiles& bestRun) const;
+    static void BuildCliques(Graph const& compatible, Bitset const& candidates,
+                    Positions& run, Positions& longestRun);
+    static Positions
+                LongestGroup(std::vector<Tile> const&);
+    PackedList  Packed(void) const;
 };
 #endif // !defined(TILES_HPP_INCLUDED)
@@ -43,17 +43,22 @@ const String Turns::SUFFIX("}");
 
 // The implicitly defined assignment method is OK.
 
+Turn const& Turns::operator[](SizeType index) const {
+    ASSERT(index < Count());
+
+    return mList[index];
+}
+
 // Convert to a string for save/send.
 Turns::operator String(void) const {
     String result(PREFIX);
 
-    ConstIterator i_turn;
-    for (i_turn = begin(); i_turn != end(); i_turn++) {
-        if (i_turn != begin()) {
+    for (SizeType i_turn = 0; i_turn < Count(); i_turn++) {
+        if (i_turn > 0) {
             result += SEPARATOR;
         }
 
-        Turn const turn = *i_turn;
+        Turn const turn = mList[i_turn];
         String const turn_string = turn;
         result += turn_string;
     }       
@@ -65,36 +70,48 @@ Turns::operator String(void) const {
 
 // misc methods
 
+void Turns::Append(Turn const& rTurn) {
+    SizeType last_play = 0;
+    if (!mLastPlays.empty()) {
+        last_play = mLastPlays.back();
+    }
+    mList.push_back(rTurn);
+
+    Move const move = rTurn;
+    if (move.IsPlay()) {
+        last_play = Count();
+    }
+    mLastPlays.push_back(last_play);
+
+    ASSERT(mLastPlays.size() == mList.size());
+}
+
 SizeType Turns::Count(void) const {
-    SizeType const result = SizeType(size());
+    SizeType const result = SizeType(mList.size());
 
     return result;
 }
 
-// convert an iterator to an index
-SizeType Turns::Index(Iterator const& rIterator) const {
-    // count the number of iterator values preceding the argument
+// Consider only the first turnCnt turns.  Return the index just past the
+// last one which placed tiles on the board, or zero if none did.
+SizeType Turns::IndexLastPlay(SizeType turnCnt) const {
+    ASSERT(turnCnt <= Count());
+
     SizeType result = 0;
-    ConstIterator iterator;
-    for (iterator = begin(); iterator != rIterator; iterator++) {
-        ASSERT(iterator != end());
-        result++;
+    if (turnCnt > 0) {
+        result = mLastPlays[turnCnt - 1];
     }
 
+    ASSERT(result <= turnCnt);
     return result;
 }
 
-SizeType Turns::IndexLastPlay(void) const {
-    SizeType result = Count();
+// Discard all turns after the first turnCnt.
+void Turns::Truncate(SizeType turnCnt) {
+    ASSERT(turnCnt <= Count());
 
-    for (ConstReverseIterator i_turn = rbegin(); i_turn != rend(); i_turn++) {
-        Move const move = *i_turn;
-        if (move.IsPlay()) {
-            break;
-        }
-        result--;
-    }
+    mLastPlays.erase(mLastPlays.begin() + turnCnt, mLastPlays.end());
+    mList.erase(mList.begin() + turnCnt, mList.end());
 
-    return result;
+    ASSERT(Count() == turnCnt);
 }
-
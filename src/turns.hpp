@@ -25,39 +25,47 @@ You should have received a copy of the GNU General Public License
 along with the Gold Tile Game.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+
 /*
 A Turns object represents a linear sequence of zero or more turns of the game,
 used to record game history.
+
+The Turns class encapsulates a vector of Turn objects, so any turn may be
+accessed by its index.  Alongside the turns it keeps, for each prefix of the
+sequence, the index just past the last turn which placed tiles on the board,
+so that IndexLastPlay() need not search backward through the history.
 */
 
-#include <list>      // ISA std::list
+#include <vector>    // HASA std::vector
 #include "turn.hpp"  // HASA Turn
 
 
-class Turns: public std::list<Turn> {
+class Turns {
 public:
-    // public types
-    typedef std::list<Turn>::const_iterator ConstIterator;
-    typedef std::list<Turn>::const_reverse_iterator ConstReverseIterator;
-    typedef std::list<Turn>::iterator Iterator;
-
     // public lifecycle
     // Turns(void);  implicitly defined default constructor
     // Turns(Turns const&);  implicitly defined copy constructor
     // ~Turns(void);  implicitly defined destructor
 
     // public operators
+    // Turns& operator=(Turns const&);  implicitly defined assignment operator
+    Turn const& operator[](SizeType) const;
     operator String(void) const;
 
     // misc public methods
+    void     Append(Turn const&);
     SizeType Count(void) const;
-    SizeType Index(Iterator const&) const;
-    SizeType IndexLastPlay(void) const;
+    SizeType IndexLastPlay(SizeType turnCnt) const;
+    void     Truncate(SizeType turnCnt);
 
 private:
     // private constants
     static const String PREFIX;
     static const String SEPARATOR;
     static const String SUFFIX;
+
+    // private data
+    std::vector<SizeType> mLastPlays;  // IndexLastPlay() of each non-empty prefix
+    std::vector<Turn>     mList;
 };
 #endif  // !defined(TURNS_HPP_INCLUDED)
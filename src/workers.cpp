@@ -0,0 +1,400 @@
+// File:     workers.cpp
+// Location: src
+// Purpose:  implement Workers class
+// Author:   Stephen Gold sgold@sonic.net
+// (c) Copyright 2012 Stephen Gold
+// Distributed under the terms of the GNU General Public License
+
+/*
+This file is part of the Gold Tile Game.
+
+The Gold Tile Game is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by the
+Free Software Foundation, either version 3 of the License, or (at your
+option) any later version.
+
+The Gold Tile Game is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with the Gold Tile Game.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "gamecontext.hpp"
+#include "workers.hpp"
+#ifdef _QT
+# include <QThread>
+# include <QWaitCondition>
+#elif defined(WIN32)
+# include "gui/win_types.hpp"
+#else  // POSIX threads
+# include <pthread.h>
+# include <unistd.h>    // sysconf
+#endif  // POSIX threads
+
+
+// static callback functions
+
+#ifdef _QT
+// a QThread which performs jobs for a Workers object
+class WorkerThread: public QThread {
+public:
+    explicit WorkerThread(Workers* pWorkers) { mpWorkers = pWorkers; }
+protected:
+    void run(void) { mpWorkers->Serve(); }
+private:
+    Workers* mpWorkers;
+};
+
+#elif defined(WIN32)
+// thread function for a Windows thread
+static DWORD WINAPI worker_main(LPVOID pArgument) {
+    Workers* const p_workers = (Workers*)pArgument;
+
+    p_workers->Serve();
+
+    return 0;
+}
+
+#else  // POSIX threads
+// thread function for a POSIX thread
+static void* worker_main(void* pArgument) {
+    Workers* const p_workers = (Workers*)pArgument;
+
+    p_workers->Serve();
+
+    return NULL;
+}
+#endif  // POSIX threads
+
+
+/*
+A Workers::Threads object holds the helper threads of a Workers object,
+along with a native lock and two condition variables:  one on which
+the helpers wait for a new batch, and one on which each caller waits
+for the helpers to finish its batch.
+*/
+class Workers::Threads {
+public:
+    Threads(void);
+    ~Threads(void);
+
+    void Join(SizeType helperCnt);
+    void Lock(void);
+    bool Start(Workers*);  // start one more helper
+    void Unlock(void);
+    void WaitForBatch(void);    // the lock must be held
+    void WaitForHelpers(void);  // the lock must be held
+    void WakeCaller(void);
+    void WakeHelpers(void);
+
+private:
+    SizeType mStartedCnt;
+#ifdef _QT
+    WorkerThread*  mpHelpers[THREAD_CNT_MAX];
+    QMutex         mLock;
+    QWaitCondition mBatchReady;
+    QWaitCondition mHelpersDone;
+#elif defined(WIN32)
+    Win::HANDLE             mHelpers[THREAD_CNT_MAX];
+    Win::CRITICAL_SECTION   mLock;
+    Win::CONDITION_VARIABLE mBatchReady;
+    Win::CONDITION_VARIABLE mHelpersDone;
+#else  // POSIX threads
+    pthread_t       mHelpers[THREAD_CNT_MAX];
+    pthread_mutex_t mLock;
+    pthread_cond_t  mBatchReady;
+    pthread_cond_t  mHelpersDone;
+#endif  // POSIX threads
+};
+
+Workers::Threads::Threads(void) {
+    mStartedCnt = 0;
+#ifdef _QT
+    // QMutex and QWaitCondition are ready to use.
+#elif defined(WIN32)
+    Win::InitializeCriticalSection(&mLock);
+    Win::InitializeConditionVariable(&mBatchReady);
+    Win::InitializeConditionVariable(&mHelpersDone);
+#else  // POSIX threads
+    int error = ::pthread_mutex_init(&mLock, NULL);
+    ASSERT(error == 0);
+    error = ::pthread_cond_init(&mBatchReady, NULL);
+    ASSERT(error == 0);
+    error = ::pthread_cond_init(&mHelpersDone, NULL);
+    ASSERT(error == 0);
+#endif  // POSIX threads
+}
+
+// The helpers must have been joined.
+Workers::Threads::~Threads(void) {
+#ifdef _QT
+    // nothing to release
+#elif defined(WIN32)
+    Win::DeleteCriticalSection(&mLock);
+#else  // POSIX threads
+    ::pthread_cond_destroy(&mHelpersDone);
+    ::pthread_cond_destroy(&mBatchReady);
+    ::pthread_mutex_destroy(&mLock);
+#endif  // POSIX threads
+}
+
+// Wait for the helpers to exit.
+void Workers::Threads::Join(SizeType helperCnt) {
+    ASSERT(helperCnt == mStartedCnt);
+
+    for (SizeType i = 0; i < helperCnt; i++) {
+#ifdef _QT
+        mpHelpers[i]->wait();
+        delete mpHelpers[i];
+#elif defined(WIN32)
+        Win::WaitForSingleObject(mHelpers[i], INFINITE);
+        Win::CloseHandle(mHelpers[i]);
+#else  // POSIX threads
+        ::pthread_join(mHelpers[i], NULL);
+#endif  // POSIX threads
+    }
+    mStartedCnt = 0;
+}
+
+void Workers::Threads::Lock(void) {
+#ifdef _QT
+    mLock.lock();
+#elif defined(WIN32)
+    Win::EnterCriticalSection(&mLock);
+#else  // POSIX threads
+    int const error = ::pthread_mutex_lock(&mLock);
+    ASSERT(error == 0);
+#endif  // POSIX threads
+}
+
+// Return false if the thread couldn't be created.
+bool Workers::Threads::Start(Workers* pWorkers) {
+    ASSERT(mStartedCnt < THREAD_CNT_MAX);
+
+    bool result = true;
+#ifdef _QT
+    WorkerThread* const p_helper = new WorkerThread(pWorkers);
+    ASSERT(p_helper != NULL);
+    p_helper->start();
+    mpHelpers[mStartedCnt] = p_helper;
+#elif defined(WIN32)
+    Win::HANDLE const helper
+        = Win::CreateThread(NULL, 0, &worker_main, pWorkers, 0, NULL);
+    result = (helper != NULL);
+    mHelpers[mStartedCnt] = helper;
+#else  // POSIX threads
+    int const error
+        = ::pthread_create(&mHelpers[mStartedCnt], NULL, &worker_main, pWorkers);
+    result = (error == 0);
+#endif  // POSIX threads
+
+    if (result) {
+        mStartedCnt++;
+    }
+
+    return result;
+}
+
+void Workers::Threads::Unlock(void) {
+#ifdef _QT
+    mLock.unlock();
+#elif defined(WIN32)
+    Win::LeaveCriticalSection(&mLock);
+#else  // POSIX threads
+    int const error = ::pthread_mutex_unlock(&mLock);
+    ASSERT(error == 0);
+#endif  // POSIX threads
+}
+
+void Workers::Threads::WaitForBatch(void) {
+#ifdef _QT
+    mBatchReady.wait(&mLock);
+#elif defined(WIN32)
+    Win::SleepConditionVariableCS(&mBatchReady, &mLock, INFINITE);
+#else  // POSIX threads
+    ::pthread_cond_wait(&mBatchReady, &mLock);
+#endif  // POSIX threads
+}
+
+void Workers::Threads::WaitForHelpers(void) {
+#ifdef _QT
+    mHelpersDone.wait(&mLock);
+#elif defined(WIN32)
+    Win::SleepConditionVariableCS(&mHelpersDone, &mLock, INFINITE);
+#else  // POSIX threads
+    ::pthread_cond_wait(&mHelpersDone, &mLock);
+#endif  // POSIX threads
+}
+
+void Workers::Threads::WakeCaller(void) {
+#ifdef _QT
+    mHelpersDone.wakeAll();
+#elif defined(WIN32)
+    Win::WakeAllConditionVariable(&mHelpersDone);
+#else  // POSIX threads
+    ::pthread_cond_broadcast(&mHelpersDone);
+#endif  // POSIX threads
+}
+
+void Workers::Threads::WakeHelpers(void) {
+#ifdef _QT
+    mBatchReady.wakeAll();
+#elif defined(WIN32)
+    Win::WakeAllConditionVariable(&mBatchReady);
+#else  // POSIX threads
+    ::pthread_cond_broadcast(&mBatchReady);
+#endif  // POSIX threads
+}
+
+
+// lifecycle
+
+Workers::Workers(SizeType threadCnt) {
+    if (threadCnt == 0) {
+        threadCnt = CountProcessors();
+    }
+    if (threadCnt > THREAD_CNT_MAX) {
+        threadCnt = THREAD_CNT_MAX;
+    }
+    ASSERT(threadCnt > 0);
+
+    mpThreads = new Threads;
+    mHelperCnt = 0;
+    mStopFlag = false;
+    mThreadCnt = threadCnt;
+}
+
+// Tell the helpers to exit, and wait for them.
+Workers::~Workers(void) {
+    mpThreads->Lock();
+    ASSERT(mBatches.empty());
+    mStopFlag = true;
+    mpThreads->WakeHelpers();
+    mpThreads->Unlock();
+
+    mpThreads->Join(mHelperCnt);
+    delete mpThreads;
+}
+
+
+// misc methods
+
+// Find the oldest batch with an unclaimed job.  The lock must be held.
+Workers::Batch* Workers::ClaimableBatch(void) const {
+    Batch* result = NULL;
+
+    BatchList::const_iterator i_batch;
+    for (i_batch = mBatches.begin(); i_batch != mBatches.end(); i_batch++) {
+        Batch* const p_batch = *i_batch;
+        if (p_batch->mNextJob < p_batch->mJobCnt) {
+            result = p_batch;
+            break;
+        }
+    }
+
+    return result;
+}
+
+SizeType Workers::Count(void) const {
+    return mThreadCnt;
+}
+
+/* static */ SizeType Workers::CountProcessors(void) {
+    long cnt;
+#ifdef _QT
+    cnt = QThread::idealThreadCount();
+#elif defined(WIN32)
+    Win::SYSTEM_INFO info;
+    Win::GetSystemInfo(&info);
+    cnt = long(info.dwNumberOfProcessors);
+#else  // POSIX
+    cnt = ::sysconf(_SC_NPROCESSORS_ONLN);
+#endif  // POSIX
+
+    SizeType result = 1;
+    if (cnt > 1) {
+        result = SizeType(cnt);
+    }
+
+    return result;
+}
+
+// Claim and perform one job of a batch.  The lock must be held,
+// and is released while the job runs.
+void Workers::DoJob(Batch& rBatch) {
+    ASSERT(rBatch.mNextJob < rBatch.mJobCnt);
+
+    SizeType const job = rBatch.mNextJob;
+    rBatch.mNextJob++;
+    mpThreads->Unlock();
+
+    // The job operates on its caller's game.
+    GameContext::Select(rBatch.mpContext);
+    (*rBatch.mpFunction)(rBatch.mpArgument, job);
+
+    mpThreads->Lock();
+    rBatch.mDoneCnt++;
+    if (rBatch.mDoneCnt == rBatch.mJobCnt) {
+        mpThreads->WakeCaller();
+    }
+}
+
+// Invoke the callback once for each job index in [0, jobCnt),
+// spreading the jobs across the group's threads.
+// Return only after every job has completed.
+void Workers::Run(JobFunctionType* pFunction, void* pArgument, SizeType jobCnt) {
+    ASSERT(pFunction != NULL);
+
+    GameContext* const p_context = &GameContext::Current();
+
+    Batch batch;
+    batch.mpArgument = pArgument;
+    batch.mpContext = p_context;
+    batch.mpFunction = pFunction;
+    batch.mDoneCnt = 0;
+    batch.mJobCnt = jobCnt;
+    batch.mNextJob = 0;
+
+    mpThreads->Lock();
+    while (mHelperCnt + 1 < mThreadCnt && mHelperCnt + 1 < jobCnt) {
+        bool const started = mpThreads->Start(this);
+        if (!started) {
+            break;  // the threads already started will pick up the slack
+        }
+        mHelperCnt++;
+    }
+
+    // Batches from different callers run side by side.
+    mBatches.push_back(&batch);
+    mpThreads->WakeHelpers();
+
+    while (batch.mNextJob < batch.mJobCnt) {
+        DoJob(batch);
+    }
+    while (batch.mDoneCnt < batch.mJobCnt) {
+        mpThreads->WaitForHelpers();
+    }
+    mBatches.remove(&batch);
+    mpThreads->Unlock();
+}
+
+// Perform jobs from the pending batches, until the group is destroyed.
+void Workers::Serve(void) {
+    mpThreads->Lock();
+
+    for (;;) {
+        Batch* p_batch = ClaimableBatch();
+        while (!mStopFlag && p_batch == NULL) {
+            mpThreads->WaitForBatch();
+            p_batch = ClaimableBatch();
+        }
+        if (mStopFlag) {
+            break;
+        }
+        DoJob(*p_batch);
+    }
+
+    mpThreads->Unlock();
+}
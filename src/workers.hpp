@@ -0,0 +1,100 @@
+#ifndef WORKERS_HPP_INCLUDED
+#define WORKERS_HPP_INCLUDED
+
+// File:     workers.hpp
+// Location: src
+// Purpose:  declare Workers class
+// Author:   Stephen Gold sgold@sonic.net
+// (c) Copyright 2012 Stephen Gold
+// Distributed under the terms of the GNU General Public License
+
+/*
+This file is part of the Gold Tile Game.
+
+The Gold Tile Game is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by the
+Free Software Foundation, either version 3 of the License, or (at your
+option) any later version.
+
+The Gold Tile Game is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with the Gold Tile Game.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+A Workers object represents a group of threads which cooperate to
+perform a batch of independent jobs, such as the samples evaluated
+by an Engine.
+
+The Workers class encapsulates a list of pending batches, each with
+its own job callback, argument, and counters.  The calling thread
+works only on its own batch, so a group of one thread runs every job
+serially without creating any threads.  Helper threads claim jobs
+from the oldest batch which has any left, so batches submitted by
+different threads (such as the engines of concurrent games) run side
+by side, and threads left idle by a small batch help with the others.
+Each job runs with its caller's GameContext selected.  Jobs are claimed
+under the lock, so each job should be substantial.  Helper threads are
+created by the first batch which needs them and sleep between batches
+until the group is destroyed, so a long-lived group (such as the one
+shared by every Engine) creates its threads only once.
+Threads are created using QThread (Qt), CreateThread (Windows), or
+pthreads (POSIX).
+*/
+
+#include <list>         // HASA std::list
+#include "project.hpp"  // HASA SizeType
+
+class Workers {
+public:
+    // public types
+    typedef void JobFunctionType(void*, SizeType job);
+
+    // public constants
+    static const SizeType THREAD_CNT_MAX = 64;
+
+    // public lifecycle
+    explicit Workers(SizeType threadCnt = 0);  // 0 means one per processor
+    ~Workers(void);
+
+    // misc public methods
+    SizeType        Count(void) const;
+    static SizeType CountProcessors(void);
+    void            Run(JobFunctionType*, void* arg, SizeType jobCnt);
+    void            Serve(void);  // invoked by each helper thread
+
+private:
+    // private types
+    struct Batch {
+        void*            mpArgument;  // argument for the job callback
+        GameContext*     mpContext;   // game context selected by the caller
+        JobFunctionType* mpFunction;  // job callback
+        SizeType         mDoneCnt;    // number of jobs completed
+        SizeType         mJobCnt;     // number of jobs in the batch
+        SizeType         mNextJob;    // index of the next unclaimed job
+    };
+    typedef std::list<Batch*> BatchList;
+    class Threads;  // the helper threads and the native objects they sleep on
+
+    // private data
+    BatchList        mBatches;     // batches whose callers are waiting, oldest first
+    Threads*         mpThreads;
+    SizeType         mHelperCnt;   // number of helper threads started
+    bool             mStopFlag;    // tells the helpers to exit
+    SizeType         mThreadCnt;   // number of threads, including a caller's
+
+    // private lifecycle
+    Workers(Workers const&);  // not copyable
+
+    // private operators
+    Workers& operator=(Workers const&);  // not assignable
+
+    // misc private methods
+    Batch* ClaimableBatch(void) const;  // the lock must be held
+    void   DoJob(Batch&);               // the lock must be held
+};
+#endif  // !defined(WORKERS_HPP_INCLUDED)